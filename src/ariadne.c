@@ -25,6 +25,7 @@
 #include "bflib_memory.h"
 #include "bflib_math.h"
 #include "bflib_planar.h"
+#include "bflib_datetm.h"
 #include "config_terrain.h"
 #include "ariadne_navitree.h"
 #include "ariadne_regions.h"
@@ -40,6 +41,7 @@
 #include "map_columns.h"
 #include "map_utils.h"
 #include "game_legacy.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 #define EDGEFIT_LEN           64
@@ -86,6 +88,29 @@ static long Border[BORDER_LENGTH];
 static long route_fwd[ROUTE_LENGTH];
 static long route_bak[ROUTE_LENGTH];
 
+/** Cached triangle route, with all parameters the route search depends on. */
+struct RouteCacheEntry {
+    unsigned long generation; // Triangulation generation when the route was made; 0 for unused entry
+    unsigned long last_used;
+    long tri_beg;
+    long tri_end;
+    NavRules nav_rules;
+    const unsigned long *edge_fit;
+    long owner;
+    long over_lava;
+    short start_stl_x;
+    short start_stl_y;
+    unsigned char backward;
+    long route_len;
+    long route[ROUTE_CACHE_MAX_LEN+1];
+};
+
+static struct RouteCacheEntry route_cache[ROUTE_CACHE_SETS][ROUTE_CACHE_WAYS];
+/** Triangulation generation; increased every time navmesh is changed, which invalidates cached routes. */
+static unsigned long route_cache_generation = 1;
+static unsigned long route_cache_clock;
+static struct RouteCacheStats route_cache_stats;
+
 /******************************************************************************/
 static unsigned char const actual_sizexy_to_nav_block_sizexy_table[] = {
     1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
@@ -417,6 +442,7 @@ long init_navigation(void)
     IanMap = (unsigned char *)&game.navigation_map;
     init_navigation_map();
     triangulate_map(IanMap);
+    ariadne_route_cache_invalidate();
     nav_rulesA2B = navigation_rule_normal;
     game.map_changed_for_nagivation = 1;
     return 1;
@@ -458,6 +484,7 @@ long update_navigation_triangulation(long start_x, long start_y, long end_x, lon
         }
     }
     triangulate_area(IanMap, sx, sy, ex, ey);
+    ariadne_route_cache_invalidate();
     return true;
 }
 
@@ -1883,6 +1910,107 @@ long triangle_route_do_bak(long ttriA, long ttriB, long *route, long *routecost)
     return i;
 }
 
+void ariadne_route_cache_invalidate(void)
+{
+    route_cache_generation++;
+    route_cache_stats.invalidations++;
+    if (route_cache_generation == 0)
+    {
+        // Generation overflow; make sure no old entry could become valid again
+        LbMemorySet(route_cache, 0, sizeof(route_cache));
+        route_cache_generation = 1;
+    }
+}
+
+const struct RouteCacheStats *ariadne_get_route_cache_stats(void)
+{
+    return &route_cache_stats;
+}
+
+/**
+ * Checks whether route cache entry was made with the same parameters as the current search.
+ * Apart from the triangles, route search depends on current navigation rules, creature size,
+ * and start subtile which is used by cost_to_start().
+ */
+static TbBool route_cache_entry_matches(const struct RouteCacheEntry *rcentry, TbBool backward, long ttriA, long ttriB)
+{
+    return (rcentry->generation == route_cache_generation)
+        && (rcentry->tri_beg == ttriA) && (rcentry->tri_end == ttriB)
+        && (rcentry->backward == backward)
+        && (rcentry->start_stl_x == (tree_Ax8 >> 8)) && (rcentry->start_stl_y == (tree_Ay8 >> 8))
+        && (rcentry->nav_rules == nav_rulesA2B) && (rcentry->edge_fit == EdgeFit)
+        && (rcentry->owner == owner_player_navigating) && (rcentry->over_lava == nav_thing_can_travel_over_lava);
+}
+
+static struct RouteCacheEntry *route_cache_get_set(long ttriA, long ttriB)
+{
+    unsigned long hash = (unsigned long)ttriA * 31 + (unsigned long)ttriB * 17 + (unsigned long)(tree_Ax8 >> 8) * 7 + (unsigned long)(tree_Ay8 >> 8);
+    return route_cache[hash % ROUTE_CACHE_SETS];
+}
+
+/**
+ * Makes a forward or backward triangle route, using route cache when possible.
+ * Results are identical to calling triangle_route_do_fwd() or triangle_route_do_bak() directly.
+ */
+static long triangle_route_do_cached(TbBool backward, long ttriA, long ttriB, long *route, long *routecost)
+{
+    struct RouteCacheEntry *rcset = route_cache_get_set(ttriA, ttriB);
+    struct RouteCacheEntry *rcentry;
+    route_cache_clock++;
+    int i;
+    for (i = 0; i < ROUTE_CACHE_WAYS; i++)
+    {
+        rcentry = &rcset[i];
+        if (route_cache_entry_matches(rcentry, backward, ttriA, ttriB))
+        {
+            rcentry->last_used = route_cache_clock;
+            route_cache_stats.hits++;
+            if (rcentry->route_len >= 0) {
+                LbMemoryCopy(route, rcentry->route, (rcentry->route_len+1)*sizeof(long));
+            }
+            return rcentry->route_len;
+        }
+    }
+    route_cache_stats.misses++;
+    long len;
+    if (backward)
+        len = triangle_route_do_bak(ttriA, ttriB, route, routecost);
+    else
+        len = triangle_route_do_fwd(ttriA, ttriB, route, routecost);
+    if (len > ROUTE_CACHE_MAX_LEN)
+    {
+        route_cache_stats.too_long++;
+        return len;
+    }
+    // Replace unused or least recently used entry
+    rcentry = &rcset[0];
+    for (i = 1; i < ROUTE_CACHE_WAYS; i++)
+    {
+        if (rcentry->generation != route_cache_generation)
+            break;
+        if ((rcset[i].generation != route_cache_generation) || (rcset[i].last_used < rcentry->last_used))
+            rcentry = &rcset[i];
+    }
+    if (rcentry->generation == route_cache_generation)
+        route_cache_stats.evictions++;
+    rcentry->generation = route_cache_generation;
+    rcentry->last_used = route_cache_clock;
+    rcentry->tri_beg = ttriA;
+    rcentry->tri_end = ttriB;
+    rcentry->backward = backward;
+    rcentry->start_stl_x = (tree_Ax8 >> 8);
+    rcentry->start_stl_y = (tree_Ay8 >> 8);
+    rcentry->nav_rules = nav_rulesA2B;
+    rcentry->edge_fit = EdgeFit;
+    rcentry->owner = owner_player_navigating;
+    rcentry->over_lava = nav_thing_can_travel_over_lava;
+    rcentry->route_len = len;
+    if (len >= 0) {
+        LbMemoryCopy(rcentry->route, route, (len+1)*sizeof(long));
+    }
+    return len;
+}
+
 /**
  * Prepares a tree route for reaching ttriB from ttriA.
  * @param ttriA Beginning region triangle.
@@ -1906,7 +2034,7 @@ long ma_triangle_route(long ttriA, long ttriB, long *routecost)
     // Forward route
     NAVIDBG(19,"Making forward route");
     rcost_fwd = 0;
-    len_fwd = triangle_route_do_fwd(ttriA, ttriB, route_fwd, &rcost_fwd);
+    len_fwd = triangle_route_do_cached(false, ttriA, ttriB, route_fwd, &rcost_fwd);
     if (len_fwd == -1)
     {
         NAVIDBG(19,"No forward route");
@@ -1922,7 +2050,7 @@ long ma_triangle_route(long ttriA, long ttriB, long *routecost)
     // Backward route
     NAVIDBG(19,"Making backward route");
     rcost_bak = 0;
-    len_bak = triangle_route_do_bak(ttriB, ttriA, route_bak, &rcost_bak);
+    len_bak = triangle_route_do_cached(true, ttriB, ttriA, route_bak, &rcost_bak);
     if (len_bak == -1)
     {
         NAVIDBG(19,"No backward route");
@@ -2810,7 +2938,9 @@ AriadneReturn ariadne_initialise_creature_route_f(struct Thing *thing, const str
         }
     } else
     {
+        profiler_zone_start(Zone_AriadnePrepareRoute);
         ret = ariadne_prepare_creature_route_to_target_f(thing, arid, &thing->mappos, pos, speed, flags, func_name);
+        profiler_zone_end(Zone_AriadnePrepareRoute);
         if (ret != AridRet_OK) {
             NAVIDBG(19,"%s: Failed to prepare route from %5d,%5d to %5d,%5d", func_name,
                 (int)thing->mappos.x.val,(int)thing->mappos.y.val, (int)pos->x.val,(int)pos->y.val);
@@ -3054,6 +3184,7 @@ static TbBool ariadne_check_forward_for_wallhug_gap(struct Thing *thing, struct
     potentional_next_pos_3d.z.val = get_floor_height_under_thing_at(thing, &thing->mappos);
 
     thing->mappos.z.val = potentional_next_pos_3d.z.val;
+    mark_thing_sync_hash_dirty(thing);
     TbBool cant_move_to_pos_directly = creature_cannot_move_directly_to(thing, &potentional_next_pos_3d);
 
     if (cant_move_to_pos_directly)
@@ -3353,7 +3484,10 @@ AriadneReturn creature_follow_route_to_using_gates(struct Thing *thing, struct C
         cctrl = creature_control_get_from_thing(thing);
         cctrl->arid.field_23 = 1;
     }
-    return ariadne_get_next_position_for_route(thing, finalpos, speed, nextpos, flags);
+    profiler_zone_start(Zone_AriadneFollowRoute);
+    AriadneReturn ret = ariadne_get_next_position_for_route(thing, finalpos, speed, nextpos, flags);
+    profiler_zone_end(Zone_AriadneFollowRoute);
+    return ret;
 }
 
 /**
@@ -32,6 +32,11 @@ extern "C" {
 #define ROUTE_LENGTH 12000
 #define ARID_WAYPOINTS_COUNT 10
 #define ARID_PATH_WAYPOINTS_COUNT 256
+/** Amount of sets in route cache; each set has ROUTE_CACHE_WAYS entries with LRU eviction. */
+#define ROUTE_CACHE_SETS 32
+#define ROUTE_CACHE_WAYS 8
+/** Max length of a triangle route which can be stored in route cache. */
+#define ROUTE_CACHE_MAX_LEN 480
 
 /******************************************************************************/
 #pragma pack(1)
@@ -182,6 +187,15 @@ extern const struct HugStart blocked_x_hug_start[][2];
 extern const struct HugStart blocked_y_hug_start[][2];
 extern const struct HugStart blocked_xy_hug_start[][2][2];
 
+/** Route cache statistics, for debugging and profiling. */
+struct RouteCacheStats {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+    unsigned long too_long;
+    unsigned long invalidations;
+};
+
 /******************************************************************************/
 
 
@@ -202,6 +216,8 @@ long ariadne_count_waypoints_on_creature_route_to_target_f(const struct Thing *t
 AriadneReturn ariadne_invalidate_creature_route(struct Thing *thing);
 
 TbBool navigation_points_connected(struct Coord3d *pt1, struct Coord3d *pt2);
+void ariadne_route_cache_invalidate(void);
+const struct RouteCacheStats *ariadne_get_route_cache_stats(void);
 void path_init8_wide_f(struct Path *path, long start_x, long start_y, long end_x, long end_y, long a6, unsigned char nav_size, const char *func_name);
 void nearest_search_f(long sizexy, long srcx, long srcy, long dstx, long dsty, long *px, long *py, const char *func_name);
 #define nearest_search(sizexy, srcx, srcy, dstx, dsty, px, py) nearest_search_f(sizexy, srcx, srcy, dstx, dsty, px, py, __func__)
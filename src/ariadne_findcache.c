@@ -31,55 +31,67 @@
 extern "C" {
 #endif
 /******************************************************************************/
-static long find_cache[4][4];
+/** Find cache grid; every cell stores a triangle lying in or near that cell,
+ *  which is used as starting point when walking towards a searched position. */
+static long find_cache[FIND_CACHE_CELLS_Y][FIND_CACHE_CELLS_X];
 
 /******************************************************************************/
-long triangle_brute_find8_near(long pos_x, long pos_y)
+static inline long find_cache_cell_x(long pos_x)
 {
-    long cx = pos_x >> 14;
+    long cx = (pos_x >> FIND_CACHE_CELL_SHIFT);
     if (cx < 0)
         cx = 0;
-    if (cx > 3)
-        cx = 3;
-    long cy = pos_y >> 14;
+    if (cx > FIND_CACHE_CELLS_X-1)
+        cx = FIND_CACHE_CELLS_X-1;
+    return cx;
+}
+
+static inline long find_cache_cell_y(long pos_y)
+{
+    long cy = (pos_y >> FIND_CACHE_CELL_SHIFT);
     if (cy < 0)
         cy = 0;
-    if (cy > 3)
-        cy = 3;
-   // Try sibling
+    if (cy > FIND_CACHE_CELLS_Y-1)
+        cy = FIND_CACHE_CELLS_Y-1;
+    return cy;
+}
+
+/**
+ * Computes the find cache cell in which centre of given triangle lies.
+ */
+static void triangle_find_cache_cell(long tri_idx, long *cx, long *cy)
+{
+    struct Triangle* tri = &Triangles[tri_idx];
+    long pos_x = ari_Points[tri->points[0]].x + ari_Points[tri->points[1]].x + ari_Points[tri->points[2]].x;
+    long pos_y = ari_Points[tri->points[0]].y + ari_Points[tri->points[1]].y + ari_Points[tri->points[2]].y;
+    *cx = find_cache_cell_x((pos_x << 8) / 3);
+    *cy = find_cache_cell_y((pos_y << 8) / 3);
+}
+
+long triangle_brute_find8_near(long pos_x, long pos_y)
+{
+    long cx = find_cache_cell_x(pos_x);
+    long cy = find_cache_cell_y(pos_y);
+    // Try cells around, in rings of growing distance
     long tri_id;
-    if (cx-1 >= 0)
-    {
-        tri_id = find_cache[cy][cx-1];
-        if (get_triangle_tree_alt(tri_id) != -1)
-            return tri_id;
-    }
-    if (cx+1 < 4)
-    {
-        tri_id = find_cache[cy][cx+1];
-        if (get_triangle_tree_alt(tri_id) != -1)
-            return tri_id;
-    }
-    if (cy-1 >= 0)
+    for (long n = 1; n <= FIND_CACHE_NEAR_DIST; n++)
     {
-        tri_id = find_cache[cy-1][cx];
-        if (get_triangle_tree_alt(tri_id) != -1)
-            return tri_id;
-    }
-    if (cy+1 < 4)
-    {
-        tri_id = find_cache[cy+1][cx];
-        if (get_triangle_tree_alt(tri_id) != -1)
-            return tri_id;
-    }
-    // Try any in cache
-    for (cy=0; cy < 4; cy++)
-    {
-        for (cx=0; cx < 4; cx++)
+        for (long dy = -n; dy <= n; dy++)
         {
-            tri_id = find_cache[cy][cx];
-            if (get_triangle_tree_alt(tri_id) != -1)
-                return tri_id;
+            long ny = cy + dy;
+            if ((ny < 0) || (ny >= FIND_CACHE_CELLS_Y))
+                continue;
+            // Only the cells on ring border are checked
+            long step = ((dy == -n) || (dy == n)) ? 1 : 2*n;
+            for (long dx = -n; dx <= n; dx += step)
+            {
+                long nx = cx + dx;
+                if ((nx < 0) || (nx >= FIND_CACHE_CELLS_X))
+                    continue;
+                tri_id = find_cache[ny][nx];
+                if (get_triangle_tree_alt(tri_id) != -1)
+                    return tri_id;
+            }
         }
     }
     // Try any
@@ -89,16 +101,8 @@ long triangle_brute_find8_near(long pos_x, long pos_y)
 
 long triangle_find_cache_get(long pos_x, long pos_y)
 {
-    long cache_x = (pos_x >> 14);
-    if (cache_x > 3)
-        cache_x = 3;
-    if (cache_x < 0)
-        cache_x = 0;
-    long cache_y = (pos_y >> 14);
-    if (cache_y > 3)
-        cache_y = 3;
-    if (cache_y < 0)
-        cache_y = 0;
+    long cache_x = find_cache_cell_x(pos_x);
+    long cache_y = find_cache_cell_y(pos_y);
 
     long ntri = find_cache[cache_y][cache_x];
     if (get_triangle_tree_alt(ntri) == -1)
@@ -117,27 +121,44 @@ long triangle_find_cache_get(long pos_x, long pos_y)
 
 void triangle_find_cache_put(long pos_x, long pos_y, long ntri)
 {
-    long cache_x = (pos_x >> 14);
-    if (cache_x > 3)
-        cache_x = 3;
-    if (cache_x < 0)
-        cache_x = 0;
-    long cache_y = (pos_y >> 14);
-    if (cache_y > 3)
-        cache_y = 3;
-    if (cache_y < 0)
-        cache_y = 0;
+    long cache_x = find_cache_cell_x(pos_x);
+    long cache_y = find_cache_cell_y(pos_y);
     find_cache[cache_y][cache_x] = ntri;
 }
 
+/**
+ * Stores triangle in find cache cell where it lies.
+ * To be called whenever triangle points are changed.
+ */
+void triangle_find_cache_put_triangle(long tri_idx)
+{
+    long cache_x;
+    long cache_y;
+    triangle_find_cache_cell(tri_idx, &cache_x, &cache_y);
+    find_cache[cache_y][cache_x] = tri_idx;
+}
+
+/**
+ * Removes triangle from find cache cell where it lies.
+ * To be called before the triangle is disposed, while its points are still valid.
+ */
+void triangle_find_cache_remove_triangle(long tri_idx)
+{
+    long cache_x;
+    long cache_y;
+    triangle_find_cache_cell(tri_idx, &cache_x, &cache_y);
+    if (find_cache[cache_y][cache_x] == tri_idx)
+        find_cache[cache_y][cache_x] = -1;
+}
+
 void triangulation_init_cache(long tri_idx)
 {
-    for (long i = 0; i < 4; i++)
+    for (long cy = 0; cy < FIND_CACHE_CELLS_Y; cy++)
     {
-        find_cache[i][0] = tri_idx;
-        find_cache[i][1] = tri_idx;
-        find_cache[i][2] = tri_idx;
-        find_cache[i][3] = tri_idx;
+        for (long cx = 0; cx < FIND_CACHE_CELLS_X; cx++)
+        {
+            find_cache[cy][cx] = tri_idx;
+        }
     }
 }
 
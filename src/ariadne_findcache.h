@@ -26,6 +26,13 @@
 extern "C" {
 #endif
 
+/******************************************************************************/
+/** Size of find cache cell, in map coordinates shift; cell is 4x4 subtiles. */
+#define FIND_CACHE_CELL_SHIFT 10
+#define FIND_CACHE_CELLS_X ((MAX_SUBTILES_X+4)/4)
+#define FIND_CACHE_CELLS_Y ((MAX_SUBTILES_Y+4)/4)
+/** Max distance, in cells, to look for a cached triangle if the cell itself has none. */
+#define FIND_CACHE_NEAR_DIST 8
 /******************************************************************************/
 #pragma pack(1)
 
@@ -34,6 +41,8 @@ extern "C" {
 /******************************************************************************/
 long triangle_find_cache_get(long pos_x, long pos_y);
 void triangle_find_cache_put(long pos_x, long pos_y, long ntri);
+void triangle_find_cache_put_triangle(long tri_idx);
+void triangle_find_cache_remove_triangle(long tri_idx);
 
 void triangulation_init_cache(long tri_idx);
 
@@ -24,6 +24,7 @@
 #include "bflib_math.h"
 #include "ariadne_points.h"
 #include "ariadne_edge.h"
+#include "ariadne_findcache.h"
 #include "ariadne.h"
 #include "gui_topmsg.h"
 #include "post_inc.h"
@@ -79,6 +80,7 @@ long tri_new(void)
 
 void tri_dispose(long tri_idx)
 {
+    triangle_find_cache_remove_triangle(tri_idx);
     long pfree_idx = free_Triangles;
     free_Triangles = tri_idx;
     Triangles[tri_idx].tags[0] = pfree_idx;
@@ -245,6 +247,8 @@ void edgelen_set(long tri_id)
         delta_y = 3;
     edge_len |= (EdgeLenBits[delta_y][delta_x] << 0);
     set_triangle_edgelen(tri_id, edge_len);
+    // Edge lengths are updated every time triangle shape changes, so keep find cache in sync here
+    triangle_find_cache_put_triangle(tri_id);
 }
 
 long edge_rotateAC(long tri1_id, long cor1_id)
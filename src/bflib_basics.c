@@ -25,6 +25,8 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <limits.h>
+#include <stdatomic.h>
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -34,6 +36,7 @@
 #include "bflib_datetm.h"
 #include "bflib_memory.h"
 #include "bflib_fileio.h"
+#include <SDL2/SDL.h>
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -228,6 +231,7 @@ short error_dialog(const char *codefile,const int ecode,const char *message)
 
 short error_dialog_fatal(const char *codefile,const int ecode,const char *message)
 {
+  LbErrorLogSetSynchronous();
   LbErrorLog("In source %s:\n %5d - %s\n",codefile,ecode,message);
   static char msg_text[2048];
   sprintf(msg_text, "%s This error in '%s' makes the program unable to continue. See '%s' for details.", message, codefile, log_file_name);
@@ -240,17 +244,442 @@ short error_dialog_fatal(const char *codefile,const int ecode,const char *messag
 short error_log_initialised=false;
 struct TbLog error_log;
 /******************************************************************************/
-int LbLog(struct TbLog *log, const char *fmt_str, va_list arg);
+/** Amount of lines which may wait in queue for the log writer; must be power of 2. */
+#define LOG_QUEUE_LENGTH    1024
+/** Max length of a queued line; longer lines are written directly by the logging thread. */
+#define LOG_LINE_LENGTH      480
+/** How long the log writer sleeps if there's nothing to write, in milliseconds. */
+#define LOG_WRITER_IDLE_TIME 100
+/** How many times to try taking the log file lock while crashing, before writing anyway. */
+#define LOG_LOCK_CRASH_TRIES 1000
+#define LOG_BINARY_MAGIC "KFXLOGB1"
+
+/** Line waiting in the log queue. */
+struct LogQueueSlot {
+    atomic_ulong seq; // Queue position for which the slot is free (seq==pos) or filled (seq==pos+1)
+    unsigned char category;
+    unsigned short len;
+    unsigned long clock;
+    char text[LOG_LINE_LENGTH];
+};
+
+/** Prefix and rate limiting state of a log category. */
+struct LogCategory {
+    const char *prefix;
+    unsigned long limit; // Lines per second; 0 means no limit
+    atomic_ulong window; // Second in which the lines are counted
+    atomic_ulong count;
+    atomic_ulong suppressed;
+};
+
+static struct LogCategory log_categories[LbLogC_ListEnd] = {
+    {"Error: ",        200, 0, 0, 0},
+    {"Warning: ",      200, 0, 0, 0},
+    {"Skirmish AI: ",    0, 0, 0, 0},
+    {"Net: ",            0, 0, 0, 0},
+    {"Sync: ",           0, 0, 0, 0},
+    {"Navi: ",           0, 0, 0, 0},
+    {"Script: ",         0, 0, 0, 0},
+    {"Config: ",         0, 0, 0, 0},
+    {"",                 0, 0, 0, 0},
+};
+
+static struct LogQueueSlot log_queue[LOG_QUEUE_LENGTH];
+/** Next queue position to be filled; shared by all logging threads. */
+static atomic_ulong log_queue_head;
+/** Next queue position to be written; used only by the holder of log_file_lock. */
+static unsigned long log_queue_tail;
+/** Owned by whoever writes to the log file. */
+static atomic_flag log_file_lock = ATOMIC_FLAG_INIT;
+/** If set, lines are written to the file by the thread which logs them. */
+static atomic_bool log_synchronous;
+static atomic_bool log_writer_signalled;
+static atomic_bool log_writer_quit;
+static SDL_Thread *log_writer_thread = NULL;
+static SDL_sem *log_writer_sem = NULL;
+FILE *file = NULL;
 /******************************************************************************/
 
+static TbBool log_file_lock_take(void)
+{
+    int tries = 0;
+    while (atomic_flag_test_and_set_explicit(&log_file_lock, memory_order_acquire))
+    {
+        // When crashing, the lock owner may be the thread which crashed
+        if (atomic_load(&log_synchronous) && (++tries >= LOG_LOCK_CRASH_TRIES))
+            return false;
+        SDL_Delay(1);
+    }
+    return true;
+}
+
+static void log_file_lock_release(void)
+{
+    atomic_flag_clear_explicit(&log_file_lock, memory_order_release);
+}
+
+/**
+ * Puts line into the log queue.
+ * @return True if the line was queued, false if the queue is full.
+ */
+static TbBool log_queue_push(enum TbLogCategory category, unsigned long clock, const char *text, unsigned short len)
+{
+    unsigned long pos = atomic_load_explicit(&log_queue_head, memory_order_relaxed);
+    struct LogQueueSlot *slot;
+    while (1)
+    {
+        slot = &log_queue[pos & (LOG_QUEUE_LENGTH-1)];
+        long dif = (long)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+        if (dif == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&log_queue_head, &pos, pos+1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else
+        if (dif < 0)
+        {
+            return false;
+        } else
+        {
+            pos = atomic_load_explicit(&log_queue_head, memory_order_relaxed);
+        }
+    }
+    slot->category = category;
+    slot->clock = clock;
+    slot->len = len;
+    memcpy(slot->text, text, len);
+    atomic_store_explicit(&slot->seq, pos+1, memory_order_release);
+    return true;
+}
+
+/**
+ * Opens the log file, writing its header if it's being created.
+ * @note Requires log_file_lock.
+ */
+static TbBool log_file_open(struct TbLog *log)
+{
+  enum Header {
+        NONE   = 0,
+        CREATE = 1,
+        APPEND = 2,
+  };
+    if (file != NULL)
+        return true;
+  char header = NONE;
+  short need_initial_newline = false;
+  if ( !log->Created )
+  {
+      if (((log->flags & 0x04) == 0) || LbFileExists(log->filename))
+      {
+        if (((log->flags & 0x01) != 0) && ((log->flags & 0x04) != 0))
+        {
+          header = CREATE;
+        } else
+        if (((log->flags & 0x02) != 0) && ((log->flags & 0x08) != 0))
+        {
+          need_initial_newline = true;
+          header = APPEND;
+        }
+      } else
+      {
+        header = CREATE;
+      }
+  }
+    const char *accmode;
+    if ((log->flags & LbLog_BinaryFormat) != 0)
+      accmode = ((log->Created) || ((log->flags & 0x01) == 0)) ? "ab" : "wb";
+    else
+      accmode = ((log->Created) || ((log->flags & 0x01) == 0)) ? "a" : "w";
+    file = fopen(log->filename, accmode);
+    // Couldn't open. Abort
+    if (file == NULL)
+      return false;
+    log->Created = true;
+    if ((log->flags & LbLog_BinaryFormat) != 0)
+    {
+        // Binary log always starts with magic; the header below becomes a record
+        if (ftell(file) == 0)
+            fwrite(LOG_BINARY_MAGIC, 1, sizeof(LOG_BINARY_MAGIC)-1, file);
+        need_initial_newline = false;
+    }
+    if (header != NONE)
+    {
+      char text[LOG_LINE_LENGTH];
+      int len = 0;
+      if ( need_initial_newline )
+        len += snprintf(text+len, sizeof(text)-len, "\n");
+      const char *actn;
+      if (header == CREATE)
+      {
+        len += snprintf(text+len, sizeof(text)-len, PROGRAM_NAME" ver "VER_STRING" (%s release) git:%s\n", (BFDEBUG_LEVEL>7)?"heavylog":"standard", GIT_REVISION);
+        actn = "CREATED";
+      } else
+      {
+        actn = "APPENDED";
+      }
+      len += snprintf(text+len, sizeof(text)-len, "LOG %s", actn);
+      short at_used = 0;
+      if ((log->flags & LbLog_TimeInHeader) != 0)
+      {
+        struct TbTime curr_time;
+        LbTime(&curr_time);
+        len += snprintf(text+len, sizeof(text)-len, "  @ %02d:%02d:%02d",
+            curr_time.Hour,curr_time.Minute,curr_time.Second);
+        at_used = 1;
+      }
+      if ((log->flags & LbLog_DateInHeader) != 0)
+      {
+        struct TbDate curr_date;
+        LbDate(&curr_date);
+        const char *sep;
+        if ( at_used )
+          sep = " ";
+        else
+          sep = "  @ ";
+        len += snprintf(text+len, sizeof(text)-len," %s%02d-%02d-%d",sep,curr_date.Day,curr_date.Month,curr_date.Year);
+      }
+      len += snprintf(text+len, sizeof(text)-len, "\n\n");
+      if (len >= (int)sizeof(text))
+        len = sizeof(text)-1;
+      if ((log->flags & LbLog_BinaryFormat) != 0)
+      {
+          struct TbLogRecordHeader rechdr;
+          rechdr.clock = SDL_GetTicks();
+          rechdr.category = LbLogC_Just;
+          rechdr.reserved = 0;
+          rechdr.len = len;
+          fwrite(&rechdr, sizeof(rechdr), 1, file);
+      }
+      fwrite(text, 1, len, file);
+    }
+    return true;
+}
+
+/**
+ * Writes a line to the log file, in text or binary form.
+ * @note Requires log_file_lock.
+ */
+static TbBool log_file_write(struct TbLog *log, enum TbLogCategory category, unsigned long clock, const char *text, unsigned long len)
+{
+    if (!log_file_open(log))
+        return false;
+    if ((log->flags & LbLog_BinaryFormat) != 0)
+    {
+        struct TbLogRecordHeader rechdr;
+        if (len > USHRT_MAX)
+            len = USHRT_MAX;
+        rechdr.clock = clock;
+        rechdr.category = category;
+        rechdr.reserved = 0;
+        rechdr.len = len;
+        fwrite(&rechdr, sizeof(rechdr), 1, file);
+    }
+    fwrite(text, 1, len, file);
+    return true;
+}
+
+/**
+ * Writes queued lines to the log file.
+ * @param complete If set, lines which are being queued right now are waited for;
+ *     otherwise writing stops at the first line which is not ready.
+ * @note Requires log_file_lock.
+ */
+static void log_queue_flush(struct TbLog *log, TbBool complete)
+{
+    unsigned long head = atomic_load(&log_queue_head);
+    TbBool written = false;
+    int tries = 0;
+    while (1)
+    {
+        struct LogQueueSlot *slot = &log_queue[log_queue_tail & (LOG_QUEUE_LENGTH-1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != log_queue_tail+1)
+        {
+            if (!complete || ((long)(head - log_queue_tail) <= 0))
+                break;
+            // Slot taken, but not filled yet; unless crashing, the other thread will fill it soon
+            if (atomic_load(&log_synchronous) && (++tries >= LOG_LOCK_CRASH_TRIES))
+                break;
+            SDL_Delay(0);
+            continue;
+        }
+        log_file_write(log, slot->category, slot->clock, slot->text, slot->len);
+        atomic_store_explicit(&slot->seq, log_queue_tail+LOG_QUEUE_LENGTH, memory_order_release);
+        log_queue_tail++;
+        written = true;
+    }
+    if (written && (file != NULL))
+    {
+        fflush(file);
+        log->position = ftell(file);
+    }
+}
+
+static int SDLCALL log_writer(void *data)
+{
+    struct TbLog *log = (struct TbLog *)data;
+    while (!atomic_load(&log_writer_quit))
+    {
+        SDL_SemWaitTimeout(log_writer_sem, LOG_WRITER_IDLE_TIME);
+        atomic_store(&log_writer_signalled, false);
+        if (atomic_load(&log_synchronous))
+            break;
+        if (log_file_lock_take())
+        {
+            log_queue_flush(log, false);
+            log_file_lock_release();
+        }
+    }
+    return 0;
+}
+
+static void log_writer_signal(void)
+{
+    if (!atomic_exchange(&log_writer_signalled, true))
+        SDL_SemPost(log_writer_sem);
+}
+
+/**
+ * Logs a complete line. The line is queued for the log writer, unless logging
+ * is synchronous or the line is too long - then it is written right away,
+ * after the lines which are already queued.
+ */
+static int log_line(struct TbLog *log, enum TbLogCategory category, unsigned long clock, const char *text, unsigned long len)
+{
+    while ((len < LOG_LINE_LENGTH) && !atomic_load(&log_synchronous))
+    {
+        if (log_queue_push(category, clock, text, len))
+        {
+            log_writer_signal();
+            return 1;
+        }
+        // Queue is full - help the writer, so that lines of this thread stay in order
+        if (log_file_lock_take())
+        {
+            log_queue_flush(log, true);
+            log_file_lock_release();
+        }
+    }
+    TbBool locked = log_file_lock_take();
+    log_queue_flush(log, true);
+    int result = log_file_write(log, category, clock, text, len) ? 1 : -1;
+    if (file != NULL)
+    {
+        fflush(file);
+        log->position = ftell(file);
+    }
+    if (locked)
+        log_file_lock_release();
+    return result;
+}
+
+/**
+ * Counts the line within rate limit of its category.
+ * @return True if the line should be logged, false if it is suppressed.
+ */
+static TbBool log_rate_check(struct TbLog *log, enum TbLogCategory category, unsigned long clock)
+{
+    struct LogCategory *lcat = &log_categories[category];
+    if ((lcat->limit == 0) || atomic_load(&log_synchronous))
+        return true;
+    unsigned long window = clock / 1000;
+    unsigned long prev_window = atomic_load(&lcat->window);
+    if ((prev_window != window) && atomic_compare_exchange_strong(&lcat->window, &prev_window, window))
+    {
+        atomic_store(&lcat->count, 0);
+        unsigned long suppressed = atomic_exchange(&lcat->suppressed, 0);
+        if (suppressed > 0)
+        {
+            char text[LOG_LINE_LENGTH];
+            int len = snprintf(text, sizeof(text), "%sSuppressed %lu more messages of this kind.\n", lcat->prefix, suppressed);
+            log_line(log, category, clock, text, len);
+        }
+    }
+    if (atomic_fetch_add(&lcat->count, 1) < lcat->limit)
+        return true;
+    atomic_fetch_add(&lcat->suppressed, 1);
+    return false;
+}
+
+/**
+ * Reports lines suppressed by rate limiting, which weren't reported yet.
+ */
+static void log_rate_report(struct TbLog *log)
+{
+    for (int i = 0; i < LbLogC_ListEnd; i++)
+    {
+        struct LogCategory *lcat = &log_categories[i];
+        unsigned long suppressed = atomic_exchange(&lcat->suppressed, 0);
+        if (suppressed > 0)
+        {
+            char text[LOG_LINE_LENGTH];
+            int len = snprintf(text, sizeof(text), "%sSuppressed %lu more messages of this kind.\n", lcat->prefix, suppressed);
+            log_line(log, i, SDL_GetTicks(), text, len);
+        }
+    }
+}
+
+/**
+ * Formats a log line, with optional date and time.
+ * @return Length of the whole line, which may exceed buffer size; negative on error.
+ */
+static int log_format(struct TbLog *log, char *buf, size_t buf_size, const char *prefix, const char *fmt_str, va_list arg)
+{
+    // Date, time and prefix are short, so they always fit in the buffer
+    int len = 0;
+    if ((log->flags & LbLog_DateInLines) != 0)
+    {
+        struct TbDate curr_date;
+        LbDate(&curr_date);
+        len += snprintf(buf, buf_size, "%02d-%02d-%d ",curr_date.Day,curr_date.Month,curr_date.Year);
+    }
+    if ((log->flags & LbLog_TimeInLines) != 0)
+    {
+        struct TbTime curr_time;
+        LbTime(&curr_time);
+        len += snprintf(buf+len, buf_size-len, "%02d:%02d:%02d ",
+            curr_time.Hour,curr_time.Minute,curr_time.Second);
+    }
+    len += snprintf(buf+len, buf_size-len, "%s", prefix);
+    int msg_len = vsnprintf(buf+len, buf_size-len, fmt_str, arg);
+    if (msg_len < 0)
+        return msg_len;
+    return len + msg_len;
+}
+
+static int LbLog(struct TbLog *log, enum TbLogCategory category, const char *prefix, const char *fmt_str, va_list arg)
+{
+  if (!log->Initialised)
+    return -1;
+  if ( log->Suspended )
+    return 1;
+  unsigned long clock = SDL_GetTicks();
+  if (!log_rate_check(log, category, clock))
+    return 1;
+  char text[LOG_LINE_LENGTH];
+  va_list arg_copy;
+  va_copy(arg_copy, arg);
+  int len = log_format(log, text, sizeof(text), prefix, fmt_str, arg_copy);
+  va_end(arg_copy);
+  if (len < 0)
+    return -1;
+  if (len < (int)sizeof(text))
+    return log_line(log, category, clock, text, len);
+  // Line too long to be queued
+  char* long_text = (char *)malloc(len + 1);
+  if (long_text == NULL)
+    return log_line(log, category, clock, text, sizeof(text) - 1);
+  log_format(log, long_text, len + 1, prefix, fmt_str, arg);
+  int result = log_line(log, category, clock, long_text, len);
+  free(long_text);
+  return result;
+}
+
 int LbErrorLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Error: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Error, log_categories[LbLogC_Error].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -259,10 +688,9 @@ int LbWarnLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Warning: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Warning, log_categories[LbLogC_Warning].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -271,10 +699,9 @@ int LbAiLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Skirmish AI: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Ai, log_categories[LbLogC_Ai].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -283,10 +710,9 @@ int LbNetLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Net: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Net, log_categories[LbLogC_Net].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -295,10 +721,9 @@ int LbSyncLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Sync: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Sync, log_categories[LbLogC_Sync].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -307,10 +732,9 @@ int LbNaviLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "Navi: ");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Navi, log_categories[LbLogC_Navi].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -322,10 +746,11 @@ int LbScriptLog(unsigned long line,const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefixFmt(&error_log, "Script(line %lu): ",line);
+    char prefix[LOG_PREFIX_LEN];
+    snprintf(prefix, sizeof(prefix), "Script(line %lu): ",line);
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Script, prefix, format, val);
     va_end(val);
     return result;
 }
@@ -337,10 +762,11 @@ int LbConfigLog(unsigned long line,const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefixFmt(&error_log, "Config(line %lu): ",line);
+    char prefix[LOG_PREFIX_LEN];
+    snprintf(prefix, sizeof(prefix), "Config(line %lu): ",line);
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Config, prefix, format, val);
     va_end(val);
     return result;
 }
@@ -349,10 +775,9 @@ int LbJustLog(const char *format, ...)
 {
     if (!error_log_initialised)
         return -1;
-    LbLogSetPrefix(&error_log, "");
     va_list val;
     va_start(val, format);
-    int result=LbLog(&error_log, format, val);
+    int result=LbLog(&error_log, LbLogC_Just, log_categories[LbLogC_Just].prefix, format, val);
     va_end(val);
     return result;
 }
@@ -378,7 +803,22 @@ int LbErrorLogSetup(const char *directory, const char *filename, TbBool flag)
     result = 1;
   } else
   {
-    result = -1;
+    return -1;
+  }
+  // Start the log writer; without it, every line is written when logged
+  for (unsigned long i = 0; i < LOG_QUEUE_LENGTH; i++)
+    atomic_store(&log_queue[i].seq, i);
+  atomic_store(&log_queue_head, 0);
+  log_queue_tail = 0;
+  atomic_store(&log_writer_quit, false);
+  atomic_store(&log_synchronous, true);
+  log_writer_sem = SDL_CreateSemaphore(0);
+  if (log_writer_sem != NULL)
+  {
+    atomic_store(&log_synchronous, false);
+    log_writer_thread = SDL_CreateThread(log_writer, "LogWriter", &error_log);
+    if (log_writer_thread == NULL)
+      atomic_store(&log_synchronous, true);
   }
   return result;
 }
@@ -387,121 +827,85 @@ int LbErrorLogClose(void)
 {
     if (!error_log_initialised)
         return -1;
+    if (log_writer_thread != NULL)
+    {
+        // When crashing, the writer may be unable to finish - leave it be
+        if (!atomic_load(&log_synchronous))
+        {
+            atomic_store(&log_writer_quit, true);
+            SDL_SemPost(log_writer_sem);
+            SDL_WaitThread(log_writer_thread, NULL);
+        }
+        log_writer_thread = NULL;
+    }
+    atomic_store(&log_synchronous, true);
+    log_rate_report(&error_log);
+    TbBool locked = log_file_lock_take();
+    log_queue_flush(&error_log, true);
+    if (file != NULL)
+        fflush(file);
+    if (locked)
+        log_file_lock_release();
     return LbLogClose(&error_log);
 }
 
-FILE *file = NULL;
-
-void LbCloseLog()
+/**
+ * Switches the error log to binary format, where each line is preceded by TbLogRecordHeader.
+ * Only possible before the log file is created.
+ */
+int LbErrorLogSetBinaryFormat(TbBool binary)
 {
-    fclose(file);
-    file = NULL;
+    if (!error_log_initialised)
+        return -1;
+    TbBool locked = log_file_lock_take();
+    int result;
+    if (error_log.Created)
+    {
+        result = -1;
+    } else
+    {
+        set_flag_dword(&error_log.flags, LbLog_BinaryFormat, binary);
+        result = 1;
+    }
+    if (locked)
+        log_file_lock_release();
+    return result;
 }
 
-int LbLog(struct TbLog *log, const char *fmt_str, va_list arg)
+/**
+ * Sets how many lines of given category may be logged each second; 0 removes the limit.
+ */
+int LbErrorLogSetRateLimit(enum TbLogCategory category, unsigned long lines_per_second)
 {
-  enum Header {
-        NONE   = 0,
-        CREATE = 1,
-        APPEND = 2,
-  };
-//  printf(fmt_str, arg);
-  if (!log->Initialised)
-    return -1;
-  if ( log->Suspended )
+    if ((category < 0) || (category >= LbLogC_ListEnd))
+        return -1;
+    log_categories[category].limit = lines_per_second;
     return 1;
-  char header = NONE;
-  short need_initial_newline = false;
-  if ( !log->Created )
-  {
-      if (((log->flags & 0x04) == 0) || LbFileExists(log->filename))
-      {
-        if (((log->flags & 0x01) != 0) && ((log->flags & 0x04) != 0))
-        {
-          header = CREATE;
-        } else
-        if (((log->flags & 0x02) != 0) && ((log->flags & 0x08) != 0))
-        {
-          need_initial_newline = true;
-          header = APPEND;
-        }
-      } else
-      {
-        header = CREATE;
-      }
-  }
-   const char *accmode;
-    if ((log->Created) || ((log->flags & 0x01) == 0))
-      accmode = "a";
-    else
-      accmode = "w";
-    // Only load log if it's not already open
+}
+
+/**
+ * Writes all queued lines and makes further logging write directly to the file.
+ * To be used when crashing, so that no lines are lost.
+ */
+void LbErrorLogSetSynchronous(void)
+{
+    atomic_store(&log_synchronous, true);
+    if (!error_log_initialised)
+        return;
+    TbBool locked = log_file_lock_take();
+    log_queue_flush(&error_log, true);
+    if (file != NULL)
+        fflush(file);
+    if (locked)
+        log_file_lock_release();
+}
+
+void LbCloseLog()
+{
     if (file == NULL)
-    {
-      file = fopen(log->filename, accmode);
-      // Couldn't open. Abort
-      if (file == NULL)
-        return -1;
-    }
-    log->Created = true;
-    if (header != NONE)
-    {
-      if ( need_initial_newline )
-        fprintf(file, "\n");
-      const char *actn;
-      if (header == CREATE)
-      {
-        fprintf(file, PROGRAM_NAME" ver "VER_STRING" (%s release) git:%s\n", (BFDEBUG_LEVEL>7)?"heavylog":"standard", GIT_REVISION);
-        actn = "CREATED";
-      } else
-      {
-        actn = "APPENDED";
-      }
-      fprintf(file, "LOG %s", actn);
-      short at_used = 0;
-      if ((log->flags & LbLog_TimeInHeader) != 0)
-      {
-        struct TbTime curr_time;
-        LbTime(&curr_time);
-        fprintf(file, "  @ %02d:%02d:%02d",
-            curr_time.Hour,curr_time.Minute,curr_time.Second);
-        at_used = 1;
-      }
-      if ((log->flags & LbLog_DateInHeader) != 0)
-      {
-        struct TbDate curr_date;
-        LbDate(&curr_date);
-        const char *sep;
-        if ( at_used )
-          sep = " ";
-        else
-          sep = "  @ ";
-        fprintf(file," %s%02d-%02d-%d",sep,curr_date.Day,curr_date.Month,curr_date.Year);
-      }
-      fprintf(file, "\n\n");
-    }
-    if ((log->flags & LbLog_DateInLines) != 0)
-    {
-        struct TbDate curr_date;
-        LbDate(&curr_date);
-        fprintf(file,"%02d-%02d-%d ",curr_date.Day,curr_date.Month,curr_date.Year);
-    }
-    if ((log->flags & LbLog_TimeInLines) != 0)
-    {
-        struct TbTime curr_time;
-        LbTime(&curr_time);
-        fprintf(file, "%02d:%02d:%02d ",
-            curr_time.Hour,curr_time.Minute,curr_time.Second);
-    }
-    if (log->prefix[0] != '\0')
-      fprintf(file, log->prefix);
-  vfprintf(file, fmt_str, arg);
-  log->position = ftell(file);
-  // fclose is slow and automatically happens on normal program exit.
-  // Opening/closing every time we log something hits performance hard.
-  // fclose(file);
-  fflush(file);
-  return 1;
+        return;
+    fclose(file);
+    file = NULL;
 }
 
 int LbLogSetPrefix(struct TbLog *log, const char *prefix)
@@ -50,6 +50,21 @@ enum TbLogFlags {
         LbLog_DateInLines  = 0x0040,
         LbLog_TimeInLines  = 0x0080,
         LbLog_LoopedFile   = 0x0100,
+        LbLog_BinaryFormat = 0x0200,
+};
+
+/** Categories of error log messages; each has its own prefix and rate limit. */
+enum TbLogCategory {
+        LbLogC_Error = 0,
+        LbLogC_Warning,
+        LbLogC_Ai,
+        LbLogC_Net,
+        LbLogC_Sync,
+        LbLogC_Navi,
+        LbLogC_Script,
+        LbLogC_Config,
+        LbLogC_Just,
+        LbLogC_ListEnd,
 };
 
 enum TbErrorCode {
@@ -113,6 +128,14 @@ struct TbLog {
         long position;
 };
 
+/** Header of a line stored in binary log; followed by the text of the line, which is not NUL-terminated. */
+struct TbLogRecordHeader {
+        unsigned long clock; // Milliseconds since the program start
+        unsigned char category; // Value from TbLogCategory
+        unsigned char reserved;
+        unsigned short len;
+};
+
 struct TbNetworkCallbackData;
 /** Command function result, alias for TbResult. */
 typedef int TbError;
@@ -150,6 +173,9 @@ void LbPrint(const char *format, ...);
 
 int LbErrorLogSetup(const char *directory, const char *filename, TbBool flag);
 int LbErrorLogClose(void);
+int LbErrorLogSetBinaryFormat(TbBool binary);
+int LbErrorLogSetRateLimit(enum TbLogCategory category, unsigned long lines_per_second);
+void LbErrorLogSetSynchronous(void);
 
 int LbLogClose(struct TbLog *log);
 int LbLogSetup(struct TbLog *log, const char *filename, ulong flags);
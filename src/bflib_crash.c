@@ -91,6 +91,7 @@ void exit_handler(void)
 void ctrl_handler(int sig_id)
 {
     signal(sig_id, SIG_DFL);
+    LbErrorLogSetSynchronous();
     LbErrorLog("Failure signal: %s.\n",sigstr(sig_id));
     LbScreenReset();
     LbErrorLogClose();
@@ -139,6 +140,8 @@ _backtrace(int depth , LPCONTEXT context)
 
 static LONG CALLBACK ctrl_handler_w32(LPEXCEPTION_POINTERS info)
 {
+    // Don't rely on the log writer thread when crashing
+    LbErrorLogSetSynchronous();
     switch (info->ExceptionRecord->ExceptionCode) {
     case EXCEPTION_ACCESS_VIOLATION:
         switch (info->ExceptionRecord->ExceptionInformation[0])
@@ -21,6 +21,8 @@
 #include "bflib_datetm.h"
 
 #include <chrono>
+#include <cstdio>
+#include <cstring>
 #include "bflib_basics.h"
 #include "globals.h"
 
@@ -46,6 +48,29 @@ TimePoint initialized_time_point;
 struct FrametimeMeasurements frametime_measurements;
 TimePoint delta_time_previous_timepoint;
 int debug_display_frametime = 0;
+struct ProfilerMeasurements profiler_measurements;
+struct BenchmarkMeasurements benchmark_measurements;
+static const char *profiler_zone_names[TOTAL_PROFILER_ZONES] = {
+    "update_things",
+    "process_rooms",
+    "process_dungeons",
+    "process_level_script",
+    "process_computer_players2",
+    "computer_check_events",
+    "process_checks",
+    "process_processes_and_task",
+    "process_players",
+    "ariadne_follow_route",
+    "ariadne_prepare_route",
+    "light_render_area",
+    "display_drawlist",
+};
+/** Chrome trace-event file; events are written while it is open. */
+static FILE *profiler_trace_file = NULL;
+static TimePoint profiler_trace_time_point;
+static unsigned long profiler_trace_events;
+static double profiler_trace_microseconds();
+static void profiler_trace_write_event(const char *name, double start_us, double duration_us);
 /******************************************************************************/
 void initial_time_point()
 {
@@ -88,6 +113,7 @@ void frametime_set_all_measurements_to_be_displayed()
         switch (debug_display_frametime)
         {
             case 1: // Frametime (show constantly)
+            case 3: // Frametime with profiling zones
                 frametime_measurements.frametime_display[i] = frametime_measurements.frametime_current[i];
                 break;
             case 2: // Frametime max (shown once per half-second)
@@ -120,10 +146,227 @@ void frametime_end_measurement(int frametime_kind)
     float result = float(current_milliseconds) - frametime_measurements.starting_measurement[frametime_kind];
     frametime_measurements.frametime_current[frametime_kind] = result;
     
+    if (profiler_trace_file != NULL) {
+        static const char *frametime_kind_names[TOTAL_FRAMETIME_KINDS] = {"frame", "logic", "draw", "sleep"};
+        profiler_trace_write_event(frametime_kind_names[frametime_kind], profiler_trace_microseconds() - result * 1000.0, result * 1000.0);
+    }
     if (frametime_kind == Frametime_FullFrame) {
         // Done last at end of frame
         frametime_set_all_measurements_to_be_displayed();
+        profiler_frame_end();
+    }
+}
+
+static double profiler_current_milliseconds()
+{
+    long double current_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(TimeNow - initialized_time_point).count();
+    return double(current_nanoseconds/1000000.0);
+}
+
+static double profiler_trace_microseconds()
+{
+    long double current_nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(TimeNow - profiler_trace_time_point).count();
+    return double(current_nanoseconds/1000.0);
+}
+
+/**
+ * Zones are only measured if anything is going to use the results;
+ * otherwise entering and leaving a zone costs just this check.
+ */
+static inline bool profiler_is_active()
+{
+    return (debug_display_frametime == 3) || (profiler_trace_file != NULL) || (benchmark_measurements.active);
+}
+
+static void profiler_trace_write_event(const char *name, double start_us, double duration_us)
+{
+    fprintf(profiler_trace_file, "%s\n{\"name\":\"%s\",\"cat\":\"keeperfx\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+        (profiler_trace_events > 0) ? "," : "", name, start_us, duration_us);
+    profiler_trace_events++;
+}
+
+const char *profiler_zone_name(int zone_kind)
+{
+    if ((zone_kind < 0) || (zone_kind >= TOTAL_PROFILER_ZONES))
+        return "unknown";
+    return profiler_zone_names[zone_kind];
+}
+
+/**
+ * Enters a profiling zone. Every call has to be paired with profiler_zone_end() for the same zone.
+ */
+void profiler_zone_start(int zone_kind)
+{
+    if (!profiler_is_active())
+        return;
+    struct ProfilerMeasurements *pmeas = &profiler_measurements;
+    if (pmeas->stack_depth >= PROFILER_MAX_DEPTH)
+    {
+        // Log only once, so that the log isn't flooded every frame
+        static TbBool depth_exceeded_logged = false;
+        if (!depth_exceeded_logged)
+        {
+            WARNLOG("Profiling zones nested deeper than %d, zone %s and deeper not measured", PROFILER_MAX_DEPTH, profiler_zone_name(zone_kind));
+            depth_exceeded_logged = true;
+        }
+        return;
+    }
+    struct ProfilerZoneStats *zstat = &pmeas->zones[zone_kind];
+    if (zstat->open_count == 0)
+        zstat->depth = pmeas->stack_depth;
+    zstat->open_count++;
+    pmeas->stack_zone[pmeas->stack_depth] = zone_kind;
+    pmeas->starting_measurement[pmeas->stack_depth] = profiler_current_milliseconds();
+    pmeas->stack_depth++;
+}
+
+/**
+ * Leaves a profiling zone. Time spent in recursive entries of the same zone is only counted once.
+ */
+void profiler_zone_end(int zone_kind)
+{
+    struct ProfilerMeasurements *pmeas = &profiler_measurements;
+    // The profiler could have been enabled while inside the zone; then there is nothing to close
+    if ((pmeas->stack_depth == 0) || (pmeas->stack_zone[pmeas->stack_depth-1] != zone_kind))
+        return;
+    pmeas->stack_depth--;
+    double start = pmeas->starting_measurement[pmeas->stack_depth];
+    double result = profiler_current_milliseconds() - start;
+    struct ProfilerZoneStats *zstat = &pmeas->zones[zone_kind];
+    zstat->open_count--;
+    zstat->frame_calls++;
+    zstat->total_calls++;
+    if (zstat->open_count == 0)
+    {
+        zstat->frame_time += result;
+        zstat->total_time += result;
+    }
+    if (profiler_trace_file != NULL)
+    {
+        double start_us = profiler_trace_microseconds() - result * 1000.0;
+        profiler_trace_write_event(profiler_zone_names[zone_kind], start_us, result * 1000.0);
+    }
+}
+
+/**
+ * Moves time gathered by zones during the current frame into rolling statistics.
+ */
+void profiler_frame_end(void)
+{
+    struct ProfilerMeasurements *pmeas = &profiler_measurements;
+    int ridx = pmeas->rolling_index;
+    for (int i = 0; i < TOTAL_PROFILER_ZONES; i++)
+    {
+        struct ProfilerZoneStats *zstat = &pmeas->zones[i];
+        zstat->rolling_time[ridx] = zstat->frame_time;
+        double sum = 0.0;
+        double max_time = 0.0;
+        for (int k = 0; k < PROFILER_ROLLING_FRAMES; k++)
+        {
+            sum += zstat->rolling_time[k];
+            if (zstat->rolling_time[k] > max_time)
+                max_time = zstat->rolling_time[k];
+        }
+        zstat->rolling_avg = sum / PROFILER_ROLLING_FRAMES;
+        zstat->rolling_max = max_time;
+        zstat->frame_time = 0.0;
+        zstat->frame_calls = 0;
+    }
+    pmeas->rolling_index = (ridx + 1) % PROFILER_ROLLING_FRAMES;
+}
+
+void profiler_reset(void)
+{
+    memset(&profiler_measurements, 0, sizeof(profiler_measurements));
+}
+
+/**
+ * Starts writing profiling zones into a Chrome trace-event JSON file.
+ * The file can be opened in chrome://tracing or any compatible viewer.
+ */
+TbBool profiler_trace_start(const char *fname)
+{
+    profiler_trace_stop();
+    if ((fname == NULL) || (fname[0] == '\0'))
+    {
+        ERRORLOG("No trace file name given");
+        return false;
+    }
+    profiler_trace_file = fopen(fname, "w");
+    if (profiler_trace_file == NULL)
+    {
+        ERRORLOG("Cannot open trace file \"%s\"", fname);
+        return false;
+    }
+    profiler_trace_time_point = TimeNow;
+    profiler_trace_events = 0;
+    fprintf(profiler_trace_file, "[");
+    SYNCMSG("Profiler trace started, \"%s\"", fname);
+    return true;
+}
+
+void profiler_trace_stop(void)
+{
+    if (profiler_trace_file == NULL)
+        return;
+    fprintf(profiler_trace_file, "\n]\n");
+    fclose(profiler_trace_file);
+    profiler_trace_file = NULL;
+    SYNCMSG("Profiler trace finished, %lu events written", profiler_trace_events);
+}
+
+TbBool profiler_trace_active(void)
+{
+    return (profiler_trace_file != NULL);
+}
+
+/**
+ * Clears benchmark totals and starts measuring the whole benchmark loop.
+ */
+void benchmark_begin(void)
+{
+    memset(&benchmark_measurements, 0, sizeof(benchmark_measurements));
+    profiler_reset();
+    benchmark_measurements.active = true;
+    benchmark_measurements.loop_start = profiler_current_milliseconds();
+}
+
+/**
+ * Stops measuring; the totals stay available for benchmark_report().
+ * @param turns Amount of game turns processed since benchmark_begin().
+ */
+void benchmark_finish(unsigned long turns)
+{
+    if (!benchmark_measurements.active)
+        return;
+    benchmark_measurements.loop_time = profiler_current_milliseconds() - benchmark_measurements.loop_start;
+    benchmark_measurements.turns = turns;
+    benchmark_measurements.active = false;
+}
+
+/**
+ * Writes benchmark results into the log and to standard output.
+ */
+void benchmark_report(void)
+{
+    struct BenchmarkMeasurements *bmeas = &benchmark_measurements;
+    double turns_per_sec = 0.0;
+    if (bmeas->loop_time > 0.0)
+        turns_per_sec = 1000.0 * bmeas->turns / bmeas->loop_time;
+    JUSTMSG("Benchmark: %lu turns in %.1f ms, %.2f turns/sec", bmeas->turns, bmeas->loop_time, turns_per_sec);
+    fprintf(stdout, "Benchmark: %lu turns in %.1f ms, %.2f turns/sec\n", bmeas->turns, bmeas->loop_time, turns_per_sec);
+    for (int i = 0; i < TOTAL_PROFILER_ZONES; i++)
+    {
+        struct ProfilerZoneStats *zstat = &profiler_measurements.zones[i];
+        if (zstat->total_calls == 0)
+            continue;
+        double per_turn = (bmeas->turns > 0) ? (zstat->total_time / bmeas->turns) : 0.0;
+        JUSTMSG("Benchmark: %*s%-*s total %10.1f ms, %8.4f ms/turn, %lu calls", 2*zstat->depth, "", 28-2*zstat->depth,
+            profiler_zone_names[i], zstat->total_time, per_turn, zstat->total_calls);
+        fprintf(stdout, "Benchmark: %*s%-*s total %10.1f ms, %8.4f ms/turn, %lu calls\n", 2*zstat->depth, "", 28-2*zstat->depth,
+            profiler_zone_names[i], zstat->total_time, per_turn, zstat->total_calls);
     }
+    fflush(stdout);
 }
 /******************************************************************************/
 /**
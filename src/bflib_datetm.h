@@ -68,6 +68,67 @@ extern void frametime_end_measurement(int frametime_kind);
 extern float get_delta_time();
 
 extern struct FrametimeMeasurements frametime_measurements;
+
+#define PROFILER_ROLLING_FRAMES 32
+#define PROFILER_MAX_DEPTH 16
+/** Named profiling zones. Zones may be nested; the nesting depth is stored for display. */
+enum ProfilerZones {
+    Zone_UpdateThings = 0,
+    Zone_ProcessRooms,
+    Zone_ProcessDungeons,
+    Zone_LevelScript,
+    Zone_ComputerPlayers,
+    Zone_ComputerEvents,
+    Zone_ComputerChecks,
+    Zone_ComputerProcesses,
+    Zone_ProcessPlayers,
+    Zone_AriadneFollowRoute,
+    Zone_AriadnePrepareRoute,
+    Zone_LightRenderArea,
+    Zone_DisplayDrawlist,
+    TOTAL_PROFILER_ZONES,
+};
+struct ProfilerZoneStats {
+    double frame_time;
+    double total_time;
+    double rolling_time[PROFILER_ROLLING_FRAMES];
+    double rolling_avg;
+    double rolling_max;
+    unsigned long frame_calls;
+    unsigned long total_calls;
+    unsigned char depth;
+    unsigned char open_count;
+};
+struct ProfilerMeasurements {
+    struct ProfilerZoneStats zones[TOTAL_PROFILER_ZONES];
+    double starting_measurement[PROFILER_MAX_DEPTH];
+    unsigned char stack_zone[PROFILER_MAX_DEPTH];
+    unsigned char stack_depth;
+    unsigned short rolling_index;
+};
+/** Totals gathered by headless benchmark mode. */
+struct BenchmarkMeasurements {
+    TbBool active;
+    double loop_start;
+    double loop_time;
+    unsigned long turns;
+};
+
+extern void profiler_zone_start(int zone_kind);
+extern void profiler_zone_end(int zone_kind);
+extern void profiler_frame_end(void);
+extern void profiler_reset(void);
+extern const char *profiler_zone_name(int zone_kind);
+extern TbBool profiler_trace_start(const char *fname);
+extern void profiler_trace_stop(void);
+extern TbBool profiler_trace_active(void);
+
+extern void benchmark_begin(void);
+extern void benchmark_finish(unsigned long turns);
+extern void benchmark_report(void);
+
+extern struct ProfilerMeasurements profiler_measurements;
+extern struct BenchmarkMeasurements benchmark_measurements;
 /******************************************************************************/
 #ifdef __cplusplus
 }
@@ -32,6 +32,7 @@
 #include <limits.h>
 #include <time.h>
 #include <share.h>
+#include <windows.h>
 
 #include "bflib_basics.h"
 #include "bflib_datetm.h"
@@ -483,6 +484,17 @@ int LbFileRename(const char *fname_old, const char *fname_new)
   return result;
 }
 
+//Renames a disk file, atomically replacing the target if it exists
+int LbFileReplace(const char *fname_old, const char *fname_new)
+{
+  int result;
+  if ( MoveFileEx(fname_old, fname_new, MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH) )
+    result = 1;
+  else
+    result = -1;
+  return result;
+}
+
 //Removes a disk file
 int LbFileDelete(const char *filename)
 {
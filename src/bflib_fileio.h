@@ -70,6 +70,7 @@ int LbFileFindFirst(const char *filespec, struct TbFileFind *ffind,unsigned int
 int LbFileFindNext(struct TbFileFind *ffind);
 int LbFileFindEnd(struct TbFileFind *ffind);
 int LbFileRename(const char *fname_old, const char *fname_new);
+int LbFileReplace(const char *fname_old, const char *fname_new);
 int LbFileDelete(const char *filename);
 short LbFileFlush(TbFileHandle handle);
 char *LbGetCurrWorkDir(char *dest, const unsigned long maxlen);
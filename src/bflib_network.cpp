@@ -25,11 +25,13 @@
 #include "bflib_datetm.h"
 #include "bflib_memory.h"
 #include "bflib_netsession.h"
+#include "bflib_netsync.h"
 #include "bflib_netsp.hpp"
 #include "bflib_netsp_ipx.hpp"
 #include "globals.h"
 #include <assert.h>
 #include <ctype.h>
+#include <zlib.h>
 
 //TODO: get rid of the following headers later by refactoring, they're here for testing primarily
 #include "frontend.h"
@@ -191,6 +193,32 @@ struct NetworkMessageExample
     } body;
 };
 
+/**
+ * Resync works on fixed size chunks of the synced buffer. Clients send hashes
+ * of their chunks, server answers only with the chunks which differ, packed
+ * into zlib compressed batches of bounded size.
+ */
+#define RESYNC_CHUNK_SIZE       4096
+#define RESYNC_BATCH_CHUNKS     16
+
+enum NetResyncMessageType
+{
+    RESYNC_HASHES,          //to server: hashes of all chunks the client has
+    RESYNC_DATA,            //from server: batch of compressed chunks
+    RESYNC_DONE,            //from server: all differing chunks were sent
+};
+
+#pragma pack(1)
+struct NetResyncHeader
+{
+    char            type; //enum NetMessageType, always NETMSG_RESYNC
+    char            subtype; //enum NetResyncMessageType
+    unsigned long   count; //chunk hashes, or chunks in batch, or chunks sent in total
+    unsigned long   raw_size; //uncompressed size of batch
+    unsigned long   packed_size; //compressed size of batch
+};
+#pragma pack()
+
 /**
  * Contains the entire network state.
  */
@@ -1139,42 +1167,252 @@ TbError LbNetwork_Exchange(void *send_buf, void *server_buf, size_t client_frame
     }
 }
 
+static size_t resync_chunk_len(size_t chunk_idx, size_t len)
+{
+    size_t offset = chunk_idx * RESYNC_CHUNK_SIZE;
+    return min(len - offset, (size_t)RESYNC_CHUNK_SIZE);
+}
+
+static void resync_compute_hashes(const char * buf, size_t len, unsigned long * hashes, size_t nchunks)
+{
+    for (size_t i = 0; i < nchunks; i++)
+    {
+        hashes[i] = crc32(0L, (const Bytef *)(buf + i * RESYNC_CHUNK_SIZE), resync_chunk_len(i, len));
+    }
+}
+
+/**
+ * Prepares netsync instructions covering given chunks of the buffer.
+ * The instruction list is NULL terminated, as LbNetsync functions expect.
+ */
+static void resync_prepare_instructions(char * buf, size_t len, const unsigned long * chunk_idx, size_t count,
+    struct NetsyncInstr * instr, const struct NetsyncInstr ** instr_list)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        instr[i].ptr = buf + chunk_idx[i] * RESYNC_CHUNK_SIZE;
+        instr[i].len = resync_chunk_len(chunk_idx[i], len);
+        instr[i].encoding = DELTA_NONE;
+        instr[i].on_collect = NULL;
+        instr[i].on_restore = NULL;
+        instr_list[i] = &instr[i];
+    }
+    instr_list[count] = NULL;
+}
+
+/**
+ * Reads messages from given user until a resync message is received.
+ * Anything else which was queued before the resync started is discarded.
+ */
+static size_t resync_read_message(NetUserId source, char * msg_buf, size_t msg_len)
+{
+    size_t size;
+    do {
+        size = netstate.sp->readmsg(source, msg_buf, msg_len);
+        if (size < 1) {
+            return 0;
+        }
+    } while (msg_buf[0] != NETMSG_RESYNC);
+    return size;
+}
+
+static TbBool resync_send_to_user(NetUserId user_id, char * buf, size_t len, size_t nchunks)
+{
+    size_t hash_msg_len = sizeof(struct NetResyncHeader) + nchunks * sizeof(unsigned long);
+    char * hash_msg = (char *) LbMemoryAlloc(hash_msg_len);
+    unsigned long * own_hashes = (unsigned long *) LbMemoryAlloc(nchunks * sizeof(unsigned long));
+    size_t max_packed = compressBound(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    size_t data_msg_len = sizeof(struct NetResyncHeader) + RESYNC_BATCH_CHUNKS * sizeof(unsigned long) + max_packed;
+    char * data_msg = (char *) LbMemoryAlloc(data_msg_len);
+    char * raw_buf = (char *) LbMemoryAlloc(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    char * state_buf = (char *) LbMemoryAlloc(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    struct NetsyncInstr instr[RESYNC_BATCH_CHUNKS];
+    const struct NetsyncInstr * instr_list[RESYNC_BATCH_CHUNKS + 1];
+    TbBool result = false;
+
+    if ((hash_msg == NULL) || (own_hashes == NULL) || (data_msg == NULL) || (raw_buf == NULL) || (state_buf == NULL))
+    {
+        ERRORLOG("Can't allocate resync buffers");
+        goto finish;
+    }
+    if (resync_read_message(user_id, hash_msg, hash_msg_len) < hash_msg_len)
+    {
+        NETLOG("Bad reception of resync hashes from user %d", (int)user_id);
+        goto finish;
+    }
+    {
+        struct NetResyncHeader * hdr = (struct NetResyncHeader *)hash_msg;
+        unsigned long * user_hashes = (unsigned long *)(hash_msg + sizeof(struct NetResyncHeader));
+        if ((hdr->subtype != RESYNC_HASHES) || (hdr->count != nchunks))
+        {
+            NETLOG("Resync hashes from user %d do not match the synced buffer", (int)user_id);
+            goto finish;
+        }
+        resync_compute_hashes(buf, len, own_hashes, nchunks);
+        struct NetResyncHeader * data_hdr = (struct NetResyncHeader *)data_msg;
+        unsigned long * chunk_idx = (unsigned long *)(data_msg + sizeof(struct NetResyncHeader));
+        size_t count = 0;
+        unsigned long total = 0;
+        unsigned long total_packed = 0;
+        for (size_t i = 0; i <= nchunks; i++)
+        {
+            if ((i < nchunks) && (own_hashes[i] != user_hashes[i]))
+            {
+                chunk_idx[count] = i;
+                count++;
+            }
+            if ((count == 0) || ((count < RESYNC_BATCH_CHUNKS) && (i < nchunks))) {
+                continue;
+            }
+            // Batch is full or this is the last one - gather, pack and send it
+            resync_prepare_instructions(buf, len, chunk_idx, count, instr, instr_list);
+            size_t raw_size = LbNetsyncBufferSize(instr_list);
+            LbNetsyncCollect(instr_list, raw_buf, NULL, state_buf);
+            uLongf packed_size = max_packed;
+            char * packed = (char *)(chunk_idx + count);
+            if (compress2((Bytef *)packed, &packed_size, (const Bytef *)raw_buf, raw_size, Z_BEST_SPEED) != Z_OK)
+            {
+                ERRORLOG("Can't compress resync data");
+                goto finish;
+            }
+            data_hdr->type = NETMSG_RESYNC;
+            data_hdr->subtype = RESYNC_DATA;
+            data_hdr->count = count;
+            data_hdr->raw_size = raw_size;
+            data_hdr->packed_size = packed_size;
+            netstate.sp->sendmsg_single(user_id, data_msg, packed + packed_size - data_msg);
+            total += count;
+            total_packed += packed_size;
+            count = 0;
+        }
+        data_hdr->type = NETMSG_RESYNC;
+        data_hdr->subtype = RESYNC_DONE;
+        data_hdr->count = total;
+        data_hdr->raw_size = 0;
+        data_hdr->packed_size = 0;
+        netstate.sp->sendmsg_single(user_id, data_msg, sizeof(struct NetResyncHeader));
+        NETLOG("Sent %lu of %lu chunks to user %d, %lu bytes packed", total, (unsigned long)nchunks, (int)user_id, total_packed);
+        result = true;
+    }
+finish:
+    LbMemoryFree(state_buf);
+    LbMemoryFree(raw_buf);
+    LbMemoryFree(data_msg);
+    LbMemoryFree(own_hashes);
+    LbMemoryFree(hash_msg);
+    return result;
+}
+
+static TbBool resync_receive_from_server(char * buf, size_t len, size_t nchunks)
+{
+    size_t hash_msg_len = sizeof(struct NetResyncHeader) + nchunks * sizeof(unsigned long);
+    char * hash_msg = (char *) LbMemoryAlloc(hash_msg_len);
+    size_t max_packed = compressBound(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    size_t data_msg_len = sizeof(struct NetResyncHeader) + RESYNC_BATCH_CHUNKS * sizeof(unsigned long) + max_packed;
+    char * data_msg = (char *) LbMemoryAlloc(data_msg_len);
+    char * raw_buf = (char *) LbMemoryAlloc(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    char * state_buf = (char *) LbMemoryAlloc(RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE);
+    struct NetsyncInstr instr[RESYNC_BATCH_CHUNKS];
+    const struct NetsyncInstr * instr_list[RESYNC_BATCH_CHUNKS + 1];
+    TbBool result = false;
+
+    if ((hash_msg == NULL) || (data_msg == NULL) || (raw_buf == NULL) || (state_buf == NULL))
+    {
+        ERRORLOG("Can't allocate resync buffers");
+        goto finish;
+    }
+    {
+        struct NetResyncHeader * hdr = (struct NetResyncHeader *)hash_msg;
+        hdr->type = NETMSG_RESYNC;
+        hdr->subtype = RESYNC_HASHES;
+        hdr->count = nchunks;
+        hdr->raw_size = 0;
+        hdr->packed_size = 0;
+        resync_compute_hashes(buf, len, (unsigned long *)(hash_msg + sizeof(struct NetResyncHeader)), nchunks);
+        netstate.sp->sendmsg_single(SERVER_ID, hash_msg, hash_msg_len);
+    }
+    unsigned long total;
+    total = 0;
+    while (1)
+    {
+        //discard all frames until next resync message
+        size_t size = resync_read_message(SERVER_ID, data_msg, data_msg_len);
+        struct NetResyncHeader * hdr = (struct NetResyncHeader *)data_msg;
+        if (size < sizeof(struct NetResyncHeader))
+        {
+            NETLOG("Bad reception of resync message");
+            goto finish;
+        }
+        if (hdr->subtype == RESYNC_DONE)
+        {
+            if (hdr->count != total) {
+                NETLOG("Received %lu resync chunks, but server sent %lu", total, hdr->count);
+                goto finish;
+            }
+            break;
+        }
+        unsigned long * chunk_idx = (unsigned long *)(data_msg + sizeof(struct NetResyncHeader));
+        if ((hdr->subtype != RESYNC_DATA) || (hdr->count < 1) || (hdr->count > RESYNC_BATCH_CHUNKS) ||
+            (size < sizeof(struct NetResyncHeader) + hdr->count * sizeof(unsigned long) + hdr->packed_size))
+        {
+            NETLOG("Malformed resync data message");
+            goto finish;
+        }
+        for (size_t i = 0; i < hdr->count; i++)
+        {
+            if (chunk_idx[i] >= nchunks) {
+                NETLOG("Resync chunk %lu out of range", chunk_idx[i]);
+                goto finish;
+            }
+        }
+        resync_prepare_instructions(buf, len, chunk_idx, hdr->count, instr, instr_list);
+        uLongf raw_size = RESYNC_BATCH_CHUNKS * RESYNC_CHUNK_SIZE;
+        if ((uncompress((Bytef *)raw_buf, &raw_size, (const Bytef *)(chunk_idx + hdr->count), hdr->packed_size) != Z_OK) ||
+            (raw_size != hdr->raw_size) || (raw_size != LbNetsyncBufferSize(instr_list)))
+        {
+            NETLOG("Can't unpack resync data");
+            goto finish;
+        }
+        LbNetsyncRestore(instr_list, raw_buf, NULL, state_buf);
+        total += hdr->count;
+    }
+    NETLOG("Received %lu of %lu chunks", total, (unsigned long)nchunks);
+    result = true;
+finish:
+    LbMemoryFree(state_buf);
+    LbMemoryFree(raw_buf);
+    LbMemoryFree(data_msg);
+    LbMemoryFree(hash_msg);
+    return result;
+}
+
+/**
+ * Re-synchronizes given buffer from server to all clients.
+ * Only chunks which differ between server and client are transferred.
+ */
 TbBool LbNetwork_Resync(void * buf, size_t len)
 {
-    char * full_buf;
-    int i;
+    size_t nchunks = (len + RESYNC_CHUNK_SIZE - 1) / RESYNC_CHUNK_SIZE;
+    TbBool result = true;
 
     NETLOG("Starting");
 
-    full_buf = (char *) LbMemoryAlloc(len + 1);
-
     if (netstate.users[netstate.my_id].progress == USER_SERVER) {
-        full_buf[0] = NETMSG_RESYNC;
-        LbMemoryCopy(full_buf + 1, buf, len);
-
-        for (i = 0; i < MAX_N_USERS; ++i) {
+        for (int i = 0; i < MAX_N_USERS; ++i) {
             if (netstate.users[i].progress != USER_LOGGEDIN) {
                 continue;
             }
 
-            netstate.sp->sendmsg_single(netstate.users[i].id, full_buf, len + 1);
+            if (!resync_send_to_user(netstate.users[i].id, (char *)buf, len, nchunks)) {
+                result = false;
+            }
         }
     }
     else {
-        //discard all frames until next resync frame
-        do {
-            if (netstate.sp->readmsg(SERVER_ID, full_buf, len + 1) < 1) {
-                NETLOG("Bad reception of resync message");
-                return false;
-            }
-        } while (full_buf[0] != NETMSG_RESYNC);
-
-        LbMemoryCopy(buf, full_buf + 1, len);
+        result = resync_receive_from_server((char *)buf, len, nchunks);
     }
 
-    LbMemoryFree(full_buf);
-
-    return true;
+    return result;
 }
 
 TbError LbNetwork_EnableNewPlayers(TbBool allow)
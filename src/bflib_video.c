@@ -56,6 +56,8 @@ volatile TbBool lbHasSecondSurface;
 TbBool lbDoubleBufferingRequested;
 /** Name of the video driver to be used. Must be set before LbScreenInitialize().
  * Under Win32 and with SDL, choises are windib or directx. */
+/** True if no window should be shown and no audio device opened. Must be set before LbScreenInitialize(). */
+TbBool lbScreenHeadless = false;
 /** Colour palette buffer, to be used inside lbDisplay. */
 unsigned char lbPalette[PALETTE_SIZE];
 /** Driver-specific colour palette buffer. */
@@ -395,6 +397,11 @@ TbResult LbScreenInitialize(void)
     if (lbScreenModeInfoNum == 0) {
         LbRegisterStandardVideoModes();
     }
+    // Headless mode uses SDL dummy drivers, so that no window nor audio device is ever opened
+    if (lbScreenHeadless) {
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    }
     // Initialize SDL library
     if (SDL_Init(SDL_INIT_VIDEO|SDL_INIT_NOPARACHUTE|SDL_INIT_AUDIO) < 0) {
         ERRORLOG("SDL init: %s",SDL_GetError());
@@ -405,6 +412,15 @@ TbResult LbScreenInitialize(void)
     return Lb_SUCCESS;
 }
 
+/**
+ * Sets whether the screen should be initialized without showing any window.
+ * Has to be called before LbScreenInitialize().
+ */
+void LbScreenSetHeadless(TbBool headless)
+{
+    lbScreenHeadless = headless;
+}
+
 // this function is unused
 LPCTSTR MsResourceMapping(int index)
 {
@@ -266,6 +266,7 @@ extern unsigned short units_per_pixel;
 extern TbDisplayStruct lbDisplay;
 /******************************************************************************/
 TbResult LbScreenInitialize(void);
+void LbScreenSetHeadless(TbBool headless);
 TbResult LbScreenSetDoubleBuffering(TbBool state);
 TbBool LbScreenIsDoubleBufferred(void);
 TbResult LbScreenSetup(TbScreenMode mode, TbScreenCoord width, TbScreenCoord height,
@@ -21,6 +21,9 @@
 #include "config.h"
 
 #include <stdarg.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
 #include "globals.h"
 #include "bflib_basics.h"
 #include "bflib_memory.h"
@@ -318,6 +321,292 @@ TbBool skip_conf_spaces(const char *buf, long *pos, long buflen)
   return ((*pos) < buflen);
 }
 
+/******************************************************************************/
+/** Max amount of NamedCommand arrays which have lookup tables built at the same time. */
+#define NAMED_COMMAND_INDEXES_COUNT 256
+/** Max amount of config buffers which have their blocks indexed at the same time. */
+#define CONF_BLOCK_INDEXES_COUNT 4
+
+/**
+ * Case-insensitive hash lookup table for a NamedCommand array.
+ * Arrays filled while loading configs may change after the table is built, so every
+ * item found is verified against the array, and if nothing is found, the array is
+ * searched the old way; if that finds anything, the table is rebuilt.
+ */
+struct NamedCommandIndex {
+    const struct NamedCommand *commands;
+    /** Amount of items before the one with NULL name. */
+    int count;
+    /** Amount of items before the one with non-positive num; config commands end there. */
+    int cmd_count;
+    /** Set if some names can't be matched as a single word; then the array is always searched. */
+    TbBool words_only;
+    unsigned long slots_mask;
+    short *slots;
+};
+
+/** Block headers of config file buffer, found in one pass over it. */
+struct ConfBlockIndex {
+    const char *buf;
+    long buflen;
+    long count;
+    struct ConfBlockIndexItem {
+        long name_pos;
+        long name_len;
+        long data_pos;
+        unsigned long line_num;
+    } *items;
+};
+
+static struct NamedCommandIndex named_command_indexes[NAMED_COMMAND_INDEXES_COUNT];
+static struct ConfBlockIndex conf_block_indexes[CONF_BLOCK_INDEXES_COUNT];
+static int conf_block_index_next = 0;
+/******************************************************************************/
+
+static unsigned long named_command_hash(const char *name, long len)
+{
+    unsigned long hash = 2166136261UL;
+    for (long i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)tolower((unsigned char)name[i]);
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static void named_command_index_clear(struct NamedCommandIndex *ncidx)
+{
+    LbMemoryFree(ncidx->slots);
+    LbMemorySet(ncidx, 0, sizeof(struct NamedCommandIndex));
+}
+
+static TbBool named_command_index_build(struct NamedCommandIndex *ncidx, const struct NamedCommand *commands)
+{
+    named_command_index_clear(ncidx);
+    ncidx->commands = commands;
+    ncidx->words_only = true;
+    ncidx->cmd_count = -1;
+    int count = 0;
+    while ((commands[count].name != NULL) && (count < SHRT_MAX/2))
+    {
+        if ((ncidx->cmd_count < 0) && (commands[count].num <= 0))
+            ncidx->cmd_count = count;
+        const char *name = commands[count].name;
+        if (name[0] == '\0')
+            ncidx->words_only = false;
+        for (; *name != '\0'; name++)
+        {
+            if ((*name == ' ') || (*name == '\t') || (*name == '=') || (*name == '\r') || (*name == '\n') || ((unsigned char)*name < 7))
+                ncidx->words_only = false;
+        }
+        count++;
+    }
+    ncidx->count = count;
+    if (ncidx->cmd_count < 0)
+        ncidx->cmd_count = count;
+    unsigned long nslots = 16;
+    while (nslots < 2 * (unsigned long)count)
+        nslots <<= 1;
+    ncidx->slots = (short *)LbMemoryAlloc(nslots * sizeof(short));
+    if (ncidx->slots == NULL)
+    {
+        named_command_index_clear(ncidx);
+        return false;
+    }
+    ncidx->slots_mask = nslots - 1;
+    for (unsigned long k = 0; k < nslots; k++)
+        ncidx->slots[k] = -1;
+    for (int i = 0; i < count; i++)
+    {
+        long len = strlen(commands[i].name);
+        unsigned long k = named_command_hash(commands[i].name, len) & ncidx->slots_mask;
+        TbBool duplicate = false;
+        while (ncidx->slots[k] >= 0)
+        {
+            // If the name repeats, the first one is what linear search would find
+            if (strcasecmp(commands[ncidx->slots[k]].name, commands[i].name) == 0) {
+                duplicate = true;
+                break;
+            }
+            k = (k + 1) & ncidx->slots_mask;
+        }
+        if (!duplicate)
+            ncidx->slots[k] = i;
+    }
+    return true;
+}
+
+static struct NamedCommandIndex *get_named_command_index(const struct NamedCommand *commands)
+{
+    unsigned long k = ((unsigned long)(uintptr_t)commands / sizeof(struct NamedCommand)) % NAMED_COMMAND_INDEXES_COUNT;
+    for (int n = 0; n < NAMED_COMMAND_INDEXES_COUNT; n++)
+    {
+        struct NamedCommandIndex *ncidx = &named_command_indexes[k];
+        if (ncidx->commands == commands)
+            return ncidx;
+        if (ncidx->commands == NULL)
+            break;
+        k = (k + 1) % NAMED_COMMAND_INDEXES_COUNT;
+    }
+    // Not indexed yet; if there's no free slot, re-use the one at the place the array hashes to
+    struct NamedCommandIndex *ncidx = &named_command_indexes[k];
+    if (!named_command_index_build(ncidx, commands))
+        return NULL;
+    return ncidx;
+}
+
+/**
+ * Finds the item with given name in NamedCommand array, using its lookup table.
+ * @param name The name; doesn't have to be NUL-terminated.
+ * @param len Length of the name.
+ * @param cmd_only If set, only items before the first one with non-positive num are searched.
+ * @return Index of the item, -1 if not found, -2 if the array has to be searched the old way.
+ */
+static int named_command_index_find(const struct NamedCommand *commands, const char *name, long len, TbBool cmd_only)
+{
+    struct NamedCommandIndex *ncidx = get_named_command_index(commands);
+    if ((ncidx == NULL) || (!ncidx->words_only))
+        return -2;
+    int max_count = cmd_only ? ncidx->cmd_count : ncidx->count;
+    unsigned long k = named_command_hash(name, len) & ncidx->slots_mask;
+    while (ncidx->slots[k] >= 0)
+    {
+        int i = ncidx->slots[k];
+        const char *cmdname = commands[i].name;
+        if ((cmdname != NULL) && (strncasecmp(cmdname, name, len) == 0) && (cmdname[len] == '\0'))
+            return (i < max_count) ? i : -1;
+        k = (k + 1) & ncidx->slots_mask;
+    }
+    return -1;
+}
+
+/**
+ * Drops lookup table of NamedCommand array which was found to be outdated.
+ */
+static void named_command_index_outdated(const struct NamedCommand *commands)
+{
+    struct NamedCommandIndex *ncidx = get_named_command_index(commands);
+    if (ncidx != NULL)
+        named_command_index_build(ncidx, commands);
+}
+
+/**
+ * Finds all block headers in config buffer, in the same way find_conf_block() would.
+ */
+static TbBool conf_block_index_build(struct ConfBlockIndex *cbidx, const char *buf, long buflen)
+{
+    LbMemoryFree(cbidx->items);
+    LbMemorySet(cbidx, 0, sizeof(struct ConfBlockIndex));
+    long items_max = 0;
+    unsigned long prev_line_num = text_line_number;
+    text_line_number = 1;
+    long pos = 0;
+    while (pos < buflen)
+    {
+        if (!skip_conf_spaces(buf,&pos,buflen))
+            break;
+        if (buf[pos] != '[')
+        {
+            skip_conf_to_next_line(buf,&pos,buflen);
+            continue;
+        }
+        pos++;
+        if (!skip_conf_spaces(buf,&pos,buflen))
+            break;
+        long name_pos = pos;
+        long end_pos = pos;
+        while ((end_pos < buflen) && (buf[end_pos] != ']') && (buf[end_pos] != '\r') && (buf[end_pos] != '\n'))
+            end_pos++;
+        if ((end_pos >= buflen) || (buf[end_pos] != ']'))
+        {
+            skip_conf_to_next_line(buf,&pos,buflen);
+            continue;
+        }
+        long name_len = end_pos - name_pos;
+        // Spaces between name and bracket are skipped
+        while ((name_len > 0) && ((buf[name_pos+name_len-1] == ' ') || (buf[name_pos+name_len-1] == '\t')
+          || (buf[name_pos+name_len-1] == 26) || ((unsigned char)buf[name_pos+name_len-1] < 7)))
+            name_len--;
+        pos = end_pos;
+        skip_conf_to_next_line(buf,&pos,buflen);
+        if (cbidx->count >= items_max)
+        {
+            items_max = (items_max > 0) ? 2 * items_max : 64;
+            struct ConfBlockIndexItem *items = (struct ConfBlockIndexItem *)LbMemoryGrow(cbidx->items, items_max * sizeof(struct ConfBlockIndexItem));
+            if (items == NULL)
+            {
+                LbMemoryFree(cbidx->items);
+                LbMemorySet(cbidx, 0, sizeof(struct ConfBlockIndex));
+                text_line_number = prev_line_num;
+                return false;
+            }
+            cbidx->items = items;
+        }
+        struct ConfBlockIndexItem *item = &cbidx->items[cbidx->count];
+        item->name_pos = name_pos;
+        item->name_len = name_len;
+        item->data_pos = pos;
+        item->line_num = text_line_number;
+        cbidx->count++;
+    }
+    text_line_number = prev_line_num;
+    cbidx->buf = buf;
+    cbidx->buflen = buflen;
+    return true;
+}
+
+/**
+ * Gives block index of config buffer, building it on first use of the buffer.
+ * The buffer content must not change until conf_block_index_forget() is called for it.
+ */
+static struct ConfBlockIndex *get_conf_block_index(const char *buf, long buflen)
+{
+    for (int i = 0; i < CONF_BLOCK_INDEXES_COUNT; i++)
+    {
+        struct ConfBlockIndex *cbidx = &conf_block_indexes[i];
+        if ((cbidx->buf == buf) && (cbidx->buflen == buflen))
+            return cbidx;
+    }
+    struct ConfBlockIndex *cbidx = &conf_block_indexes[conf_block_index_next];
+    conf_block_index_next = (conf_block_index_next + 1) % CONF_BLOCK_INDEXES_COUNT;
+    if (!conf_block_index_build(cbidx, buf, buflen))
+        return NULL;
+    return cbidx;
+}
+
+/**
+ * Drops block index of config buffer. Should be called before the buffer is freed,
+ * so that another buffer allocated at the same place won't use it.
+ */
+void conf_block_index_forget(const char *buf)
+{
+    if (buf == NULL)
+        return;
+    for (int i = 0; i < CONF_BLOCK_INDEXES_COUNT; i++)
+    {
+        struct ConfBlockIndex *cbidx = &conf_block_indexes[i];
+        if (cbidx->buf == buf)
+        {
+            LbMemoryFree(cbidx->items);
+            LbMemorySet(cbidx, 0, sizeof(struct ConfBlockIndex));
+        }
+    }
+}
+
+/**
+ * Frees all lookup tables used for reading config files.
+ */
+void free_conf_lookup_indexes(void)
+{
+    for (int i = 0; i < NAMED_COMMAND_INDEXES_COUNT; i++)
+        named_command_index_clear(&named_command_indexes[i]);
+    for (int i = 0; i < CONF_BLOCK_INDEXES_COUNT; i++)
+    {
+        LbMemoryFree(conf_block_indexes[i].items);
+        LbMemorySet(&conf_block_indexes[i], 0, sizeof(struct ConfBlockIndex));
+    }
+}
+
 /**
  * Searches for start of INI file block with given name.
  * Starts at position given with pos, and sets it to position of block data.
@@ -325,8 +614,26 @@ TbBool skip_conf_spaces(const char *buf, long *pos, long buflen)
  */
 short find_conf_block(const char *buf,long *pos,long buflen,const char *blockname)
 {
-  text_line_number = 1;
   int blname_len = strlen(blockname);
+  // Searches from start of the buffer use block index, so that the buffer isn't re-read for every block
+  struct ConfBlockIndex *cbidx = ((*pos) == 0) ? get_conf_block_index(buf, buflen) : NULL;
+  if (cbidx != NULL)
+  {
+      for (long i = 0; i < cbidx->count; i++)
+      {
+          struct ConfBlockIndexItem *item = &cbidx->items[i];
+          if ((item->name_len != blname_len) || (strncasecmp(&buf[item->name_pos],blockname,blname_len) != 0))
+              continue;
+          if (item->name_pos+blname_len+2 >= buflen)
+              break;
+          *pos = item->data_pos;
+          text_line_number = item->line_num;
+          return 1;
+      }
+      *pos = buflen;
+      return -1;
+  }
+  text_line_number = 1;
   while ((*pos)+blname_len+2 < buflen)
   {
     // Skipping starting spaces
@@ -392,43 +699,47 @@ int recognize_conf_command(const char *buf,long *pos,long buflen,const struct Na
     // Checking if this line is start of a block
     if (buf[*pos] == '[')
         return -3;
-    // Finding command number
-    int i = 0;
-    while (commands[i].num > 0)
+    // Finding command number; it's a single word, ended by parameters separator
+    long len = 0;
+    while (((*pos)+len < buflen) && (buf[(*pos)+len] != ' ') && (buf[(*pos)+len] != '\t')
+      && (buf[(*pos)+len] != '=') && ((unsigned char)buf[(*pos)+len] >= 7))
+        len++;
+    int i = named_command_index_find(commands, buf+(*pos), len, true);
+    if (i < 0)
     {
-        int cmdname_len = strlen(commands[i].name);
-        if ((*pos)+cmdname_len > buflen) {
-            i++;
-            continue;
-        }
-        // Find a matching command
-        if (strnicmp(buf+(*pos), commands[i].name, cmdname_len) == 0)
+        // Not in the lookup table - make sure by checking all commands
+        int idx_result = i;
+        for (i = 0; commands[i].num > 0; i++)
         {
-            (*pos) += cmdname_len;
-            // if we're not at end of input buffer..
-            if ((*pos) < buflen)
-            {
-                // make sure it's whole command, not just start of different one
-               if ((buf[(*pos)] != ' ') && (buf[(*pos)] != '\t')
-                && (buf[(*pos)] != '=')  && ((unsigned char)buf[(*pos)] >= 7))
-               {
-                  (*pos) -= cmdname_len;
-                  i++;
-                  continue;
-               }
-               // Skipping spaces between command and parameters
-               while ((buf[*pos] == ' ') || (buf[*pos] == '\t')
-                || (buf[*pos] == '=')  || ((unsigned char)buf[*pos] < 7))
-               {
-                 (*pos)++;
-                 if ((*pos) >= buflen) break;
-               }
-            }
-            return commands[i].num;
+            int cmdname_len = strlen(commands[i].name);
+            if ((*pos)+cmdname_len > buflen)
+                continue;
+            if (strnicmp(buf+(*pos), commands[i].name, cmdname_len) != 0)
+                continue;
+            // make sure it's whole command, not just start of different one
+            if (((*pos)+cmdname_len < buflen) && (buf[(*pos)+cmdname_len] != ' ') && (buf[(*pos)+cmdname_len] != '\t')
+              && (buf[(*pos)+cmdname_len] != '=') && ((unsigned char)buf[(*pos)+cmdname_len] >= 7))
+                continue;
+            break;
         }
-        i++;
+        if (commands[i].num <= 0)
+            return -2;
+        if (idx_result == -1)
+            named_command_index_outdated(commands);
     }
-    return -2;
+    (*pos) += strlen(commands[i].name);
+    // if we're not at end of input buffer..
+    if ((*pos) < buflen)
+    {
+       // Skipping spaces between command and parameters
+       while ((buf[*pos] == ' ') || (buf[*pos] == '\t')
+        || (buf[*pos] == '=')  || ((unsigned char)buf[*pos] < 7))
+       {
+         (*pos)++;
+         if ((*pos) >= buflen) break;
+       }
+    }
+    return commands[i].num;
 }
 
 int get_conf_parameter_whole(const char *buf,long *pos,long buflen,char *dst,long dstlen)
@@ -559,7 +870,23 @@ int recognize_conf_parameter(const char *buf,long *pos,long buflen,const struct
     (*pos)++;
     if ((*pos) >= buflen) return 0;
   }
-  int i = 0;
+  long len = 0;
+  while (((*pos)+len < buflen) && (buf[(*pos)+len] != '\n') && (buf[(*pos)+len] != '\r')
+    && (buf[(*pos)+len] != ' ') && (buf[(*pos)+len] != '\t') && ((unsigned char)buf[(*pos)+len] >= 7))
+      len++;
+  int i = named_command_index_find(commands, buf+(*pos), len, false);
+  if (i >= 0)
+  {
+      // If EOLN found, finish and return position before the EOLN
+      if (((*pos)+len < buflen) && ((buf[(*pos)+len] == '\n') || (buf[(*pos)+len] == '\r')))
+          (*pos) += len;
+      else
+          (*pos) += len+1;
+      return commands[i].num;
+  }
+  // Not in the lookup table - make sure by checking all parameters
+  int idx_result = i;
+  i = 0;
   while (commands[i].name != NULL)
   {
       int par_len = strlen(commands[i].name);
@@ -568,6 +895,8 @@ int recognize_conf_parameter(const char *buf,long *pos,long buflen,const struct
           // If EOLN found, finish and return position before the EOLN
           if ((buf[(*pos)+par_len] == '\n') || (buf[(*pos)+par_len] == '\r'))
           {
+            if (idx_result == -1)
+                named_command_index_outdated(commands);
             (*pos) += par_len;
             return commands[i].num;
           }
@@ -575,6 +904,8 @@ int recognize_conf_parameter(const char *buf,long *pos,long buflen,const struct
           if ((buf[(*pos)+par_len] == ' ') || (buf[(*pos)+par_len] == '\t')
            || ((unsigned char)buf[(*pos)+par_len] < 7))
           {
+            if (idx_result == -1)
+                named_command_index_outdated(commands);
             (*pos) += par_len+1;
             return commands[i].num;
           }
@@ -634,10 +965,18 @@ long get_id(const struct NamedCommand *desc, const char *itmname)
 {
   if ((desc == NULL) || (itmname == NULL))
     return -1;
+  int idx_result = named_command_index_find(desc, itmname, strlen(itmname), false);
+  if (idx_result >= 0)
+    return desc[idx_result].num;
+  // Not in the lookup table - make sure by checking all items
   for (long i = 0; desc[i].name != NULL; i++)
   {
     if (strcasecmp(desc[i].name, itmname) == 0)
+    {
+      if (idx_result == -1)
+        named_command_index_outdated(desc);
       return desc[i].num;
+    }
   }
   return -1;
 }
@@ -653,10 +992,18 @@ long get_rid(const struct NamedCommand *desc, const char *itmname)
   long i;
   if ((desc == NULL) || (itmname == NULL))
     return -1;
+  int idx_result = named_command_index_find(desc, itmname, strlen(itmname), false);
+  if (idx_result >= 0)
+    return desc[idx_result].num;
+  // Not in the lookup table - make sure by checking all items
   for (i=0; desc[i].name != NULL; i++)
   {
     if (strcasecmp(desc[i].name, itmname) == 0)
+    {
+      if (idx_result == -1)
+        named_command_index_outdated(desc);
       return desc[i].num;
+    }
   }
   if (strcasecmp("RANDOM", itmname) == 0)
   {
@@ -127,6 +127,7 @@ TbBool free_campaign(struct GameCampaign *campgn)
   LbMemoryFree(campgn->lvinfos);
   LbMemoryFree(campgn->hiscore_table);
   LbMemoryFree(campgn->strings_data);
+  conf_block_index_forget(campgn->credits_data);
   LbMemoryFree(campgn->credits_data);
   return true;
 }
@@ -1097,6 +1098,7 @@ TbBool load_campaign(const char *cmpgn_fname,struct GameCampaign *campgn,unsigne
           WARNMSG("Parsing campaign file \"%s\" map blocks failed.",cmpgn_fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     if ((flags & CnfLd_ListOnly) == 0)
     {
@@ -1114,6 +1114,7 @@ TbBool load_computer_player_config(unsigned short flags)
         parse_computer_player_computer_blocks(buf, len, textname, flags);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return true;
 }
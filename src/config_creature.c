@@ -1692,6 +1692,7 @@ TbBool load_creaturetypes_config_file(const char *textname, const char *fname, u
           WARNMSG("Parsing %s file \"%s\" attackpref blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
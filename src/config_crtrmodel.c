@@ -2528,6 +2528,7 @@ TbBool load_creaturemodel_config_file(long crtr_model,const char *textname,const
             WARNMSG("Parsing %s file \"%s\" sounds blocks failed.",textname,fname);
     }
     // Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
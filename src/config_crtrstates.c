@@ -233,6 +233,7 @@ TbBool load_creaturestates_config_file(const char *textname, const char *fname,
           WARNMSG("Parsing %s file \"%s\" state blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
@@ -280,6 +280,7 @@ TbBool load_cubes_config_file(const char *textname, const char *fname, unsigned
             WARNMSG("Parsing %s file \"%s\" cube blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
@@ -403,6 +403,7 @@ TbBool load_effects_config_file(const char *textname, const char *fname, unsigne
             WARNMSG("Parsing %s file \"%s\" effect blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     SYNCDBG(19,"Done");
     return result;
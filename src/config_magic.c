@@ -2218,6 +2218,7 @@ TbBool load_magic_config_file(const char *textname, const char *fname, unsigned
           WARNMSG("Parsing %s file \"%s\" special blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
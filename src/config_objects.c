@@ -619,6 +619,7 @@ TbBool load_objects_config_file(const char *textname, const char *fname, unsigne
             WARNMSG("Parsing %s file \"%s\" object blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
@@ -121,6 +121,9 @@ const struct NamedCommand rules_creatures_commands[] = {
   {"CRITICALHEALTHPERCENTAGE",     10},
   {"STUNEVILENEMYCHANCE",          11},
   {"STUNGOODENEMYCHANCE",          12},
+  {"COMBATCHECKINTERVAL",          13},
+  {"NEEDSCHECKINTERVAL",           14},
+  {"JOBCHECKINTERVAL",             15},
   {NULL,                            0},
   };
 
@@ -847,6 +850,9 @@ TbBool parse_rules_creatures_blocks(char *buf, long len, const char *config_text
       gameadd.critical_health_permil = 125;
       gameadd.stun_enemy_chance_good = 100;
       gameadd.stun_enemy_chance_evil = 100;
+      gameadd.combat_check_interval = 8;
+      gameadd.needs_check_interval = 4;
+      gameadd.job_check_interval = 128;
   }
   // Find the block
   char block_buf[COMMAND_WORD_LEN];
@@ -1026,6 +1032,54 @@ TbBool parse_rules_creatures_blocks(char *buf, long len, const char *config_text
                   COMMAND_TEXT(cmd_num), block_buf, config_textname);
           }
           break;
+      case 13: // COMBATCHECKINTERVAL
+          if (get_conf_parameter_single(buf, &pos, len, word_buf, sizeof(word_buf)) > 0)
+          {
+              k = atoi(word_buf);
+              if (k > 0)
+              {
+                  gameadd.combat_check_interval = k;
+                  n++;
+              }
+          }
+          if (n < 1)
+          {
+              CONFWRNLOG("Incorrect value of \"%s\" parameter in [%s] block of %s file.",
+                  COMMAND_TEXT(cmd_num), block_buf, config_textname);
+          }
+          break;
+      case 14: // NEEDSCHECKINTERVAL
+          if (get_conf_parameter_single(buf, &pos, len, word_buf, sizeof(word_buf)) > 0)
+          {
+              k = atoi(word_buf);
+              if (k > 0)
+              {
+                  gameadd.needs_check_interval = k;
+                  n++;
+              }
+          }
+          if (n < 1)
+          {
+              CONFWRNLOG("Incorrect value of \"%s\" parameter in [%s] block of %s file.",
+                  COMMAND_TEXT(cmd_num), block_buf, config_textname);
+          }
+          break;
+      case 15: // JOBCHECKINTERVAL
+          if (get_conf_parameter_single(buf, &pos, len, word_buf, sizeof(word_buf)) > 0)
+          {
+              k = atoi(word_buf);
+              if (k > 0)
+              {
+                  gameadd.job_check_interval = k;
+                  n++;
+              }
+          }
+          if (n < 1)
+          {
+              CONFWRNLOG("Incorrect value of \"%s\" parameter in [%s] block of %s file.",
+                  COMMAND_TEXT(cmd_num), block_buf, config_textname);
+          }
+          break;
       case 0: // comment
           break;
       case -1: // end of buffer
@@ -2258,6 +2312,7 @@ TbBool load_rules_config_file(const char *textname, const char *fname, unsigned
             WARNMSG("Parsing %s file \"%s\" sacrifices blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
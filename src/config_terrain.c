@@ -1197,6 +1197,7 @@ TbBool load_terrain_config_file(const char *textname, const char *fname, unsigne
             WARNMSG("Parsing %s file \"%s\" room blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     return result;
 }
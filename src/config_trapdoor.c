@@ -1281,6 +1281,7 @@ TbBool load_trapdoor_config_file(const char *textname, const char *fname, unsign
             WARNMSG("Parsing %s file \"%s\" door blocks failed.",textname,fname);
     }
     //Freeing and exiting
+    conf_block_index_forget(buf);
     LbMemoryFree(buf);
     SYNCDBG(19,"Done");
     return result;
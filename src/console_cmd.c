@@ -21,6 +21,7 @@
 #include "globals.h"
 
 #include "actionpt.h"
+#include "ariadne.h"
 #include "bflib_datetm.h"
 #include "bflib_sound.h"
 #include "bflib_sndlib.h"
@@ -350,6 +351,15 @@ TbBool cmd_exec(PlayerNumber plyr_idx, char *msg)
       targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "clock is %d, requested fps is %d",clock(),game.num_fps);
       return true;
     }
+    else if (strcasecmp(parstr, "route.stats") == 0)
+    {
+        const struct RouteCacheStats *rcstats = ariadne_get_route_cache_stats();
+        targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Route cache hits %lu, misses %lu, evictions %lu",
+            rcstats->hits, rcstats->misses, rcstats->evictions);
+        targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Too long routes %lu, navmesh changes %lu",
+            rcstats->too_long, rcstats->invalidations);
+        return true;
+    }
     else if (strcasecmp(parstr, "fps") == 0)
     {
         if (pr2str == NULL)
@@ -380,6 +390,33 @@ TbBool cmd_exec(PlayerNumber plyr_idx, char *msg)
         }
         return true;
     }
+    else if (strcasecmp(parstr, "frametime.zones") == 0 || strcasecmp(parstr, "ft.zones") == 0)
+    {
+        if (debug_display_frametime == 3) { // If already displaying, then turn off
+            debug_display_frametime = 0;
+        } else {
+            profiler_reset();
+            debug_display_frametime = 3;
+        }
+        return true;
+    }
+    else if (strcasecmp(parstr, "frametime.trace") == 0 || strcasecmp(parstr, "ft.trace") == 0)
+    {
+        if (profiler_trace_active())
+        {
+            profiler_trace_stop();
+            targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Trace finished");
+        } else
+        {
+            const char *fname = (pr2str != NULL) ? pr2str : "keeperfx_trace.json";
+            if (profiler_trace_start(fname)) {
+                targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Writing trace to %s", fname);
+            } else {
+                targeted_message_add(plyr_idx, plyr_idx, GUI_MESSAGES_DELAY, "Cannot write trace to %s", fname);
+            }
+        }
+        return true;
+    }
     else if (strcasecmp(parstr, "quit") == 0)
     {
         quit_game = 1;
@@ -430,11 +467,7 @@ TbBool cmd_exec(PlayerNumber plyr_idx, char *msg)
         player = get_player(plyr_idx);
         set_flag_byte(&game.operation_flags,GOF_Paused,true); // games are saved in a paused state
         TbBool result = save_game(slot_num);
-        if (result)
-        {
-            output_message(SMsg_GameSaved, 0, true);
-        }
-        else
+        if (!result)
         {
           ERRORLOG("Error in save!");
           create_error_box(GUIStr_ErrorSaving);
@@ -313,7 +313,7 @@ TbBool step_battles_forward(PlayerNumber plyr_idx)
 long battle_move_player_towards_battle(struct PlayerInfo *player, BattleIndex battle_idx)
 {
     struct CreatureBattle* battle = creature_battle_get(battle_idx);
-    struct Thing* thing = thing_get(battle->first_creatr);
+    struct Thing* thing = thing_get_if_generation(battle->first_creatr, battle->first_creatr_gen);
     TRACE_THING(thing);
     if (!thing_exists(thing))
     {
@@ -37,7 +37,9 @@ struct PlayerInfo;
 
 struct CreatureBattle { // sizeof = 17
   unsigned long fighters_num;
-  unsigned char field_4[9];
+  /** Generation of first creature slot, to detect when the index became stale. */
+  ThingGeneration first_creatr_gen;
+  unsigned char field_6[7];
   unsigned short first_creatr;
   unsigned short last_creatr;
 };
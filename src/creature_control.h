@@ -265,11 +265,11 @@ unsigned char sound_flag;
     MapSubtlCoord pole_stl_y;
     unsigned char search_timeout;
     short partner_idx;
-    long partner_creation;
+    ThingGeneration partner_gen;
   } training;
   struct {
     GameTurn seen_enemy_turn;
-    long battle_enemy_crtn;
+    ThingGeneration battle_enemy_gen;
     ThingIndex battle_enemy_idx;
     ThingIndex seen_enemy_idx;
     unsigned char state_id;
@@ -296,7 +296,7 @@ unsigned char sound_flag;
   } research;
   struct {
     short enemy_idx;
-    GameTurn enemy_creation_turn;
+    ThingGeneration enemy_gen;
     GameTurn turn_looked_for_enemy;
   } seek_enemy;
   struct {
@@ -409,6 +409,10 @@ unsigned short shot_shift_z;
     unsigned char stopped_for_hand_turns;
     long following_leader_since;
     unsigned char follow_leader_fails;
+    /* First turn on which decisions are no longer forced by an event; 0 if there was no such event. */
+    unsigned long decisions_forced_until;
+    /* Turn when the creature last checked its needs; anger which grows every turn is applied for the turns since. */
+    unsigned long needs_check_turn;
 };
 
 struct CreatureStats { // These stats are not compatible with original DK - they have more fields
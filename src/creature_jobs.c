@@ -25,6 +25,7 @@
 #include "thing_data.h"
 #include "thing_stats.h"
 #include "thing_navigate.h"
+#include "thing_creature.h"
 #include "config_creature.h"
 #include "config_terrain.h"
 #include "config_magic.h"
@@ -1192,7 +1193,7 @@ TbBool attempt_job_secondary_preference(struct Thing *creatng, long jobpref)
 TbBool creature_try_doing_secondary_job(struct Thing *creatng)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
-    if (game.play_gameturn - cctrl->job_secondary_check_turn <= 128) {
+    if ((game.play_gameturn - cctrl->job_secondary_check_turn <= gameadd.job_check_interval) && !creature_decisions_forced(creatng)) {
         return false;
     }
     cctrl->job_secondary_check_turn = game.play_gameturn;
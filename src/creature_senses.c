@@ -39,7 +39,91 @@
 const int CREATURE_EXPLORE_DISTANCE = 7;
 const int CREATURE_EXPLORE_DISTANCE_POSSESSED = 10;
 
+/** Amount of line of sight results remembered within one game turn. */
+#define LINE_OF_SIGHT_MEMO_SIZE 1024
+
+enum LineOfSightKind {
+    LoSK_None = 0,
+    LoSK_2D,
+    LoSK_3D,
+    LoSK_NoWibble3D,
+};
+
+struct LineOfSightMemo {
+    unsigned long stamp;
+    unsigned short fr_x;
+    unsigned short fr_y;
+    unsigned short fr_z;
+    unsigned short to_x;
+    unsigned short to_y;
+    unsigned short to_z;
+    unsigned char kind;
+    TbBool result;
+};
+
 /******************************************************************************/
+static struct LineOfSightMemo line_of_sight_memo[LINE_OF_SIGHT_MEMO_SIZE];
+static unsigned long line_of_sight_memo_stamp = 0;
+static GameTurn line_of_sight_memo_turn = 0;
+static unsigned long line_of_sight_memo_map_generation = 0;
+/******************************************************************************/
+/**
+ * Returns stamp of memo entries which are currently valid.
+ * Results are only remembered until the game turn ends or map solidity changes.
+ */
+static unsigned long line_of_sight_memo_current_stamp(void)
+{
+    unsigned long map_generation = get_map_solidity_generation();
+    if ((line_of_sight_memo_stamp == 0) || (line_of_sight_memo_turn != game.play_gameturn) ||
+        (line_of_sight_memo_map_generation != map_generation))
+    {
+        line_of_sight_memo_stamp++;
+        line_of_sight_memo_turn = game.play_gameturn;
+        line_of_sight_memo_map_generation = map_generation;
+    }
+    return line_of_sight_memo_stamp;
+}
+
+static struct LineOfSightMemo *line_of_sight_memo_entry(unsigned char kind, const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    unsigned long hash = 2166136261UL;
+    hash = (hash ^ kind) * 16777619UL;
+    hash = (hash ^ (frpos->x.val | ((unsigned long)frpos->y.val << 16))) * 16777619UL;
+    hash = (hash ^ frpos->z.val) * 16777619UL;
+    hash = (hash ^ (topos->x.val | ((unsigned long)topos->y.val << 16))) * 16777619UL;
+    hash = (hash ^ topos->z.val) * 16777619UL;
+    return &line_of_sight_memo[(hash ^ (hash >> 16)) & (LINE_OF_SIGHT_MEMO_SIZE-1)];
+}
+
+static TbBool line_of_sight_memo_get(unsigned char kind, const struct Coord3d *frpos, const struct Coord3d *topos, TbBool *result)
+{
+    if (!map_solidity_caching_enabled())
+        return false;
+    struct LineOfSightMemo *memo = line_of_sight_memo_entry(kind, frpos, topos);
+    if ((memo->stamp != line_of_sight_memo_current_stamp()) || (memo->kind != kind) ||
+        (memo->fr_x != frpos->x.val) || (memo->fr_y != frpos->y.val) || (memo->fr_z != frpos->z.val) ||
+        (memo->to_x != topos->x.val) || (memo->to_y != topos->y.val) || (memo->to_z != topos->z.val))
+        return false;
+    *result = memo->result;
+    return true;
+}
+
+static void line_of_sight_memo_put(unsigned char kind, const struct Coord3d *frpos, const struct Coord3d *topos, TbBool result)
+{
+    if (!map_solidity_caching_enabled())
+        return;
+    struct LineOfSightMemo *memo = line_of_sight_memo_entry(kind, frpos, topos);
+    memo->stamp = line_of_sight_memo_current_stamp();
+    memo->kind = kind;
+    memo->fr_x = frpos->x.val;
+    memo->fr_y = frpos->y.val;
+    memo->fr_z = frpos->z.val;
+    memo->to_x = topos->x.val;
+    memo->to_y = topos->y.val;
+    memo->to_z = topos->z.val;
+    memo->result = result;
+}
+
 TbBool sibling_line_of_sight_ignoring_door(const struct Coord3d *prevpos,
     const struct Coord3d *nextpos, const struct Thing *doortng)
 {
@@ -692,7 +776,7 @@ TbBool jonty_creature_can_see_thing_including_lava_check(const struct Thing *cre
     }
 }
 
-TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos)
+static TbBool compute_line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos)
 {
 
     MapCoordDelta pos_delta_x;
@@ -760,7 +844,17 @@ TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos
     return false;
 }
 
-TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+TbBool line_of_sight_2d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    TbBool result;
+    if (line_of_sight_memo_get(LoSK_2D, frpos, topos, &result))
+        return result;
+    result = compute_line_of_sight_2d(frpos, topos);
+    line_of_sight_memo_put(LoSK_2D, frpos, topos, result);
+    return result;
+}
+
+static TbBool compute_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
 {
     MapCoordDelta dx = topos->x.val - (MapCoordDelta)frpos->x.val;
     MapCoordDelta dy = topos->y.val - (MapCoordDelta)frpos->y.val;
@@ -870,7 +964,17 @@ TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos
     return true;
 }
 
-TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+TbBool line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    TbBool result;
+    if (line_of_sight_memo_get(LoSK_3D, frpos, topos, &result))
+        return result;
+    result = compute_line_of_sight_3d(frpos, topos);
+    line_of_sight_memo_put(LoSK_3D, frpos, topos, result);
+    return result;
+}
+
+static TbBool compute_nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
 {
     MapCoordDelta dx,dy,dz;
     dx = topos->x.val - (MapCoordDelta)frpos->x.val;
@@ -977,6 +1081,16 @@ TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord
     return true;
 }
 
+TbBool nowibble_line_of_sight_3d(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    TbBool result;
+    if (line_of_sight_memo_get(LoSK_NoWibble3D, frpos, topos, &result))
+        return result;
+    result = compute_nowibble_line_of_sight_3d(frpos, topos);
+    line_of_sight_memo_put(LoSK_NoWibble3D, frpos, topos, result);
+    return result;
+}
+
 TbBool line_of_room_move_2d(const struct Coord3d *frpos, const struct Coord3d *topos, struct Room *room)
 {
     MapCoordDelta delta_x;
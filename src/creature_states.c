@@ -22,6 +22,7 @@
 
 #include "bflib_math.h"
 #include "thing_list.h"
+#include "thing_creature.h"
 #include "creature_control.h"
 #include "creature_instances.h"
 #include "creature_graphics.h"
@@ -78,6 +79,7 @@
 #include "creature_states_tresr.h"
 #include "creature_states_barck.h"
 
+#include "net_sync.h"
 #include "keeperfx.hpp"
 #include "post_inc.h"
 
@@ -1373,7 +1375,7 @@ short cleanup_seek_the_enemy(struct Thing *creatng)
     TRACE_THING(creatng);
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     cctrl->seek_enemy.enemy_idx = 0;
-    cctrl->seek_enemy.enemy_creation_turn = 0;
+    cctrl->seek_enemy.enemy_gen = 0;
     return 1;
 }
 
@@ -1404,6 +1406,8 @@ short creature_being_dropped(struct Thing *creatng)
         return 1;
     }
     set_creature_assigned_job(creatng, Job_NULL);
+    // Dropped at a new place, so decisions made before are outdated
+    creature_force_decisions_check(creatng);
     // If the creature has flight ability, return it to flying state
     restore_creature_flight_flag(creatng);
     // Set creature to default state, in case giving it job will fail
@@ -1740,7 +1744,8 @@ short creature_doing_nothing(struct Thing *creatng)
         cctrl->job_assigned_check_turn = game.play_gameturn;
     }
     struct CreatureStats* crstat = creature_stats_get_from_thing(creatng);
-    if ((crstat->job_primary != Job_NULL) && (game.play_gameturn - cctrl->job_primary_check_turn > 128))
+    if ((crstat->job_primary != Job_NULL) &&
+        ((game.play_gameturn - cctrl->job_primary_check_turn > gameadd.job_check_interval) || creature_decisions_forced(creatng)))
     {
         if (attempt_job_preference(creatng, crstat->job_primary)) {
             SYNCDBG(8,"The %s index %d will do primary job with state %s",thing_model_name(creatng),
@@ -2393,6 +2398,7 @@ void creature_drag_object(struct Thing *creatng, struct Thing *dragtng)
     dragtng->alloc_flags |= TAlF_IsDragged;
     dragtng->state_flags |= TF1_IsDragged1;
     dragtng->owner = game.neutral_player_num;
+    mark_thing_sync_hash_dirty(dragtng);
     if (dragtng->light_id != 0) {
       light_turn_light_off(dragtng->light_id);
     }
@@ -3665,7 +3671,7 @@ char new_slab_tunneller_check_for_breaches(struct Thing *creatng)
         if ((col->bitfields & CLF_CEILING_MASK) != 0)
             continue;
 
-        if (!creature_can_navigate_to(creatng, &game.things.lookup[dgn->dnheart_idx]->mappos, NavRtF_Default))
+        if (!creature_can_navigate_to(creatng, &thing_get(dgn->dnheart_idx)->mappos, NavRtF_Default))
             continue;
 
         cctrl->party.player_broken_into_flags |= 1 << i;
@@ -4127,12 +4133,11 @@ struct Thing *thing_update_enemy_to_fight_with(struct Thing *thing)
     struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
     if (cctrl->seek_enemy.enemy_idx != 0)
     {
-        enemytng = thing_get(cctrl->seek_enemy.enemy_idx);
+        enemytng = thing_get_if_generation(cctrl->seek_enemy.enemy_idx, cctrl->seek_enemy.enemy_gen);
         TRACE_THING(enemytng);
-        if (((enemytng->alloc_flags & TAlF_Exists) == 0) || (cctrl->seek_enemy.enemy_creation_turn != enemytng->creation_turn))
+        if (thing_is_invalid(enemytng))
         {
-          enemytng = INVALID_THING;
-          cctrl->seek_enemy.enemy_creation_turn = 0;
+          cctrl->seek_enemy.enemy_gen = 0;
           cctrl->seek_enemy.enemy_idx = 0;
         }
     } else
@@ -4150,7 +4155,7 @@ struct Thing *thing_update_enemy_to_fight_with(struct Thing *thing)
         return NULL;
     }
     cctrl->seek_enemy.enemy_idx = enemytng->index;
-    cctrl->seek_enemy.enemy_creation_turn = enemytng->creation_turn;
+    cctrl->seek_enemy.enemy_gen = get_thing_generation(enemytng);
     return enemytng;
 }
 
@@ -4668,10 +4673,10 @@ long creature_free_for_toking(struct Thing* creatng)
 
 /**
  * If creature health is very low, go back to lair immediately for healing.
- * @param thing
- * @param crstat
+ * @param creatng The creature.
+ * @param turns Game turns since previous check of needs; anger growing every turn is multiplied by it.
  */
-long process_creature_needs_to_heal_critical(struct Thing *creatng)
+long process_creature_needs_to_heal_critical(struct Thing *creatng, long turns)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     if (get_creature_health_permil(creatng) >= gameadd.critical_health_permil) {
@@ -4708,7 +4713,7 @@ long process_creature_needs_to_heal_critical(struct Thing *creatng)
         } else
         {
             struct CreatureStats* crstat = creature_stats_get_from_thing(creatng);
-            anger_apply_anger_to_creature(creatng, crstat->annoy_no_lair, AngR_NoLair, 1);
+            anger_apply_anger_to_creature(creatng, crstat->annoy_no_lair * turns, AngR_NoLair, 1);
         }
         cctrl->healing_sleep_check_turn = game.play_gameturn;
     }
@@ -4801,7 +4806,7 @@ char creature_free_for_lunchtime(struct Thing *creatng)
         && can_change_from_state_to(creatng, creatng->active_state, CrSt_CreatureToGarden);
 }
 
-long process_creature_needs_to_eat(struct Thing *creatng, const struct CreatureStats *crstat)
+long process_creature_needs_to_eat(struct Thing *creatng, const struct CreatureStats *crstat, long turns)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     if ((crstat->hunger_rate == 0) || (cctrl->hunger_level <= (long)crstat->hunger_rate)) {
@@ -4823,11 +4828,11 @@ long process_creature_needs_to_eat(struct Thing *creatng, const struct CreatureS
     if (!player_has_room_of_role(creatng->owner, RoRoF_FoodStorage))
     {
         output_message_room_related_from_computer_or_player_action(creatng->owner, RoK_GARDEN, OMsg_RoomNeeded);
-        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery, AngR_Hungry, 1);
+        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery * turns, AngR_Hungry, 1);
         return 0;
     }
     if (game.play_gameturn - cctrl->garden_eat_check_turn <= 128) {
-        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery, AngR_Hungry, 1);
+        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery * turns, AngR_Hungry, 1);
         return 0;
     }
     struct Room* nroom = find_nearest_room_of_role_for_thing_with_used_capacity(creatng, creatng->owner, RoRoF_FoodStorage, NavRtF_Default, 1);
@@ -4848,12 +4853,12 @@ long process_creature_needs_to_eat(struct Thing *creatng, const struct CreatureS
     }
     if (room_is_invalid(nroom)) {
         event_create_event_or_update_nearby_existing_event(0, 0, EvKind_CreatrHungry, creatng->owner, 0);
-        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery, AngR_Hungry, 1);
+        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery * turns, AngR_Hungry, 1);
         return 0;
     }
     if (!external_set_thing_state(creatng, CrSt_CreatureToGarden)) {
         event_create_event_or_update_nearby_existing_event(0, 0, EvKind_CreatrHungry, creatng->owner, 0);
-        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery, AngR_Hungry, 1);
+        anger_apply_anger_to_creature(creatng, crstat->annoy_no_hatchery * turns, AngR_Hungry, 1);
         return 0;
     }
     short hunger_loss = cctrl->hunger_loss;
@@ -4875,7 +4880,7 @@ long process_creature_needs_to_eat(struct Thing *creatng, const struct CreatureS
     return 1;
 }
 
-long anger_process_creature_anger(struct Thing *creatng, const struct CreatureStats *crstat)
+long anger_process_creature_anger(struct Thing *creatng, const struct CreatureStats *crstat, long turns)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     // Creatures with no annoyance level will never get angry
@@ -4889,7 +4894,7 @@ long anger_process_creature_anger(struct Thing *creatng, const struct CreatureSt
         // If the creature is mad killing, don't allow it not to be angry
         if ((cctrl->spell_flags & CSAfF_MadKilling) != 0) {
             // Mad creature's mind is tortured, so apply torture anger
-            anger_apply_anger_to_creature(creatng, crstat->annoy_in_torture, AngR_Other, 1);
+            anger_apply_anger_to_creature(creatng, crstat->annoy_in_torture * turns, AngR_Other, 1);
         }
         return 0;
     }
@@ -4992,7 +4997,7 @@ long anger_process_creature_anger(struct Thing *creatng, const struct CreatureSt
     return 0;
 }
 
-long process_creature_needs_to_heal(struct Thing *creatng, const struct CreatureStats *crstat)
+long process_creature_needs_to_heal(struct Thing *creatng, const struct CreatureStats *crstat, long turns)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     if (!creature_requires_healing(creatng)) {
@@ -5024,7 +5029,7 @@ long process_creature_needs_to_heal(struct Thing *creatng, const struct Creature
         }
     } else
     {
-      anger_apply_anger_to_creature(creatng, crstat->annoy_no_lair, AngR_NoLair, 1);
+      anger_apply_anger_to_creature(creatng, crstat->annoy_no_lair * turns, AngR_NoLair, 1);
     }
     cctrl->healing_sleep_check_turn = game.play_gameturn;
     return 0;
@@ -5081,9 +5086,22 @@ void process_person_moods_and_needs(struct Thing *thing)
         return;
     }
     struct CreatureStats* crstat = creature_stats_get_from_thing(thing);
+    struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
     // Now process the needs
     process_creature_hunger(thing);
-    if (process_creature_needs_to_heal_critical(thing)) {
+    // Needs are checked once per interval; anger which grows every turn is applied for all turns since previous check
+    long turns = 0;
+    if (creature_decision_check_due(thing, gameadd.needs_check_interval))
+    {
+        turns = game.play_gameturn - cctrl->needs_check_turn;
+        if ((turns < 1) || (turns > gameadd.needs_check_interval))
+            turns = gameadd.needs_check_interval;
+        cctrl->needs_check_turn = game.play_gameturn;
+    }
+    if (turns == 0) {
+        SYNCDBG(19,"The %s index %d doesn't check its needs this turn",thing_model_name(thing),(long)thing->index);
+    } else
+    if (process_creature_needs_to_heal_critical(thing, turns)) {
         SYNCDBG(17,"The %s index %d has a critical need to heal",thing_model_name(thing),(long)thing->index);
     } else
     if (creature_affected_by_call_to_arms(thing)) {
@@ -5092,13 +5110,13 @@ void process_person_moods_and_needs(struct Thing *thing)
     if (process_creature_needs_a_wage(thing, crstat)) {
         SYNCDBG(17,"The %s index %d has a need to get its wage",thing_model_name(thing),(long)thing->index);
     } else
-    if (process_creature_needs_to_eat(thing, crstat)) {
+    if (process_creature_needs_to_eat(thing, crstat, turns)) {
         SYNCDBG(17,"The %s index %d has a need to eat",thing_model_name(thing),(long)thing->index);
     } else
-    if (anger_process_creature_anger(thing, crstat)) {
+    if (anger_process_creature_anger(thing, crstat, turns)) {
         SYNCDBG(17,"The %s index %d has a need to cool its anger",thing_model_name(thing),(long)thing->index);
     } else
-    if (process_creature_needs_to_heal(thing, crstat)) {
+    if (process_creature_needs_to_heal(thing, crstat, turns)) {
         SYNCDBG(17,"The %s index %d has a need to heal",thing_model_name(thing),(long)thing->index);
     }
     process_training_need(thing, crstat);
@@ -413,6 +413,12 @@ CrAttackType creature_can_have_combat_with_object(struct Thing* fightng, struct
     return AttckT_Ranged;
 }
 
+static void set_battle_first_creature(struct CreatureBattle *battle, ThingIndex tng_idx)
+{
+    battle->first_creatr = tng_idx;
+    battle->first_creatr_gen = get_thing_generation(thing_get(tng_idx));
+}
+
 void remove_thing_from_battle_list(struct Thing *thing)
 {
     SYNCDBG(9,"Starting for %s index %d",thing_model_name(thing),(int)thing->index);
@@ -432,13 +438,13 @@ void remove_thing_from_battle_list(struct Thing *thing)
         if ( creature_control_invalid(attcctrl) ) {
             WARNLOG("Invalid next in battle, %s index %d",thing_model_name(attctng),(int)cctrl->battle_next_creatr);
             // Truncate the list of creatures in battle
-            battle->first_creatr = partner_id;
+            set_battle_first_creature(battle, partner_id);
         } else {
             attcctrl->battle_prev_creatr = partner_id;
         }
     } else
     {
-        battle->first_creatr = partner_id;
+        set_battle_first_creature(battle, partner_id);
     }
     // Change prev index in next creature
     partner_id = cctrl->battle_next_creatr;
@@ -464,7 +470,7 @@ void remove_thing_from_battle_list(struct Thing *thing)
     {
         ERRORLOG("The %s index %d was in invalid battle",thing_model_name(thing),(int)thing->index);
         battle->fighters_num = 0;
-        battle->first_creatr = 0;
+        set_battle_first_creature(battle, 0);
         battle->last_creatr = 0;
         return;
     }
@@ -484,7 +490,7 @@ void insert_thing_in_battle_list(struct Thing *thing, BattleIndex battle_id)
     cctrl->battle_prev_creatr = 0;
     cctrl->battle_id = battle_id;
     if (battle->first_creatr <= 0) {
-        battle->first_creatr = thing->index;
+        set_battle_first_creature(battle, thing->index);
     }
     if (battle->last_creatr > 0) {
         struct Thing* enmtng = thing_get(battle->last_creatr);
@@ -903,7 +909,7 @@ TbBool remove_melee_attacker(struct Thing *fightng, struct Thing *enmtng)
     }
     figctrl->combat_flags &= ~CmbtF_Melee;
     figctrl->combat.battle_enemy_idx = 0;
-    figctrl->combat.battle_enemy_crtn = 0;
+    figctrl->combat.battle_enemy_gen = 0;
     figctrl->fight_til_death = 0;
     delay_teleport(fightng);
 
@@ -945,7 +951,7 @@ TbBool remove_ranged_attacker(struct Thing *fightng, struct Thing *enmtng)
     }
     figctrl->combat_flags &= ~CmbtF_Ranged;
     figctrl->combat.battle_enemy_idx = 0;
-    figctrl->combat.battle_enemy_crtn = 0;
+    figctrl->combat.battle_enemy_gen = 0;
     figctrl->fight_til_death = 0;
     delay_teleport(fightng);
 
@@ -1022,12 +1028,12 @@ long add_ranged_attacker(struct Thing *fighter, struct Thing *enemy)
     }
     figctrl->combat_flags |= CmbtF_Ranged;
     figctrl->combat.battle_enemy_idx = enemy->index;
-    figctrl->combat.battle_enemy_crtn = enemy->creation_turn;
+    figctrl->combat.battle_enemy_gen = get_thing_generation(enemy);
     if (!add_ranged_combat_attacker(enemy, fighter->index)) {
         ERRORLOG("Cannot add a ranged attacker, but there was free space - internal error");
         figctrl->combat_flags &= ~CmbtF_Ranged;
         figctrl->combat.battle_enemy_idx = 0;
-        figctrl->combat.battle_enemy_crtn = 0;
+        figctrl->combat.battle_enemy_gen = 0;
         figctrl->fight_til_death = 0;
         return false;
     }
@@ -1035,7 +1041,7 @@ long add_ranged_attacker(struct Thing *fighter, struct Thing *enemy)
         remove_ranged_combat_attacker(enemy, fighter->index);
         figctrl->combat_flags &= ~CmbtF_Ranged;
         figctrl->combat.battle_enemy_idx = 0;
-        figctrl->combat.battle_enemy_crtn = 0;
+        figctrl->combat.battle_enemy_gen = 0;
         figctrl->fight_til_death = 0;
         return false;
     }
@@ -1063,12 +1069,12 @@ long add_melee_attacker(struct Thing *fighter, struct Thing *enemy)
     }
     figctrl->combat_flags |= CmbtF_Melee;
     figctrl->combat.battle_enemy_idx = enemy->index;
-    figctrl->combat.battle_enemy_crtn = enemy->creation_turn;
+    figctrl->combat.battle_enemy_gen = get_thing_generation(enemy);
     if (!add_melee_combat_attacker(enemy, fighter->index)) {
         ERRORLOG("Cannot add a melee attacker, but %s index %d had free slot - internal error",thing_model_name(fighter),(int)fighter->index);
         figctrl->combat_flags &= ~CmbtF_Melee;
         figctrl->combat.battle_enemy_idx = 0;
-        figctrl->combat.battle_enemy_crtn = 0;
+        figctrl->combat.battle_enemy_gen = 0;
         figctrl->fight_til_death = 0;
         return false;
     }
@@ -1076,7 +1082,7 @@ long add_melee_attacker(struct Thing *fighter, struct Thing *enemy)
         remove_melee_combat_attacker(enemy, fighter->index);
         figctrl->combat_flags &= ~CmbtF_Melee;
         figctrl->combat.battle_enemy_idx = 0;
-        figctrl->combat.battle_enemy_crtn = 0;
+        figctrl->combat.battle_enemy_gen = 0;
         figctrl->fight_til_death = 0;
         return false;
     }
@@ -1092,13 +1098,13 @@ TbBool add_waiting_attacker(struct Thing *fighter, struct Thing *enemy)
     }
     figctrl->combat_flags |= CmbtF_Waiting;
     figctrl->combat.battle_enemy_idx = enemy->index;
-    figctrl->combat.battle_enemy_crtn = enemy->creation_turn;
+    figctrl->combat.battle_enemy_gen = get_thing_generation(enemy);
     if (!battle_add(fighter, enemy)) {
         //TODO COMBAT write the function to remove the waiting attacker (might be dummy)
         //remove_waiting_combat_attacker(enemy, fighter->index);
         figctrl->combat_flags &= ~CmbtF_Waiting;
         figctrl->combat.battle_enemy_idx = 0;
-        figctrl->combat.battle_enemy_crtn = 0;
+        figctrl->combat.battle_enemy_gen = 0;
         figctrl->fight_til_death = 0;
         return false;
     }
@@ -1366,7 +1372,7 @@ short creature_combat_flee(struct Thing *creatng)
 TbBool combat_enemy_exists(struct Thing *thing, struct Thing *enmtng)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
-    if ( (!thing_exists(enmtng)) || (cctrl->combat.battle_enemy_crtn != enmtng->creation_turn) )
+    if ( (!thing_exists(enmtng)) || (cctrl->combat.battle_enemy_gen != get_thing_generation(enmtng)) )
     {
         SYNCDBG(8,"Enemy creature doesn't exist");
         return false;
@@ -2350,7 +2356,7 @@ TbBool remove_waiting_attacker(struct Thing *fightng)
     figctrl->combat_flags &= ~CmbtF_Waiting;
     figctrl->combat.battle_enemy_idx = 0;
     figctrl->fight_til_death = 0;
-    figctrl->combat.battle_enemy_crtn = 0;
+    figctrl->combat.battle_enemy_gen = 0;
     delay_teleport(fightng);
 
     battle_remove(fightng);
@@ -2526,7 +2532,7 @@ long change_creature_with_existing_attacker(struct Thing *fighter, struct Thing
             figctrl->combat_flags &= ~0x04;
             figctrl->combat.battle_enemy_idx = 0;
             figctrl->fight_til_death = 0;
-            figctrl->combat.battle_enemy_crtn = 0;
+            figctrl->combat.battle_enemy_gen = 0;
             battle_remove(fighter);
         }
         set_creature_combat_state(fighter, enemy, attack_type);
@@ -49,6 +49,7 @@
 #include "gui_topmsg.h"
 #include "game_legacy.h"
 #include "map_locations.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -1130,6 +1131,7 @@ short creature_hero_entering(struct Thing *thing)
     if (cctrl->countdown_282 == 0)
     {
         thing->mappos.z.val = get_ceiling_height(&thing->mappos) - (long)thing->clipbox_size_yz - 1;
+        mark_thing_sync_hash_dirty(thing);
         cctrl->countdown_282--;
         return CrStRet_Modified;
     }
@@ -41,6 +41,7 @@
 #include "map_blocks.h"
 #include "gui_soundmsgs.h"
 #include "game_legacy.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 /******************************************************************************/
@@ -211,6 +212,7 @@ long process_torture_visuals(struct Thing *creatng, struct Room *room, CreatureJ
         creatng->movement_flags &= ~TMvF_Flying;
         cctrl->spell_flags &= ~CSAfF_Flying;
         creatng->mappos.z.val = get_thing_height_at(creatng, &creatng->mappos);
+        mark_thing_sync_hash_dirty(creatng);
         if (cctrl->instance_id == CrInst_NULL) {
             set_creature_instance(creatng, CrInst_TORTURED, 0, 0);
         }
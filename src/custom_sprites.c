@@ -85,6 +85,9 @@ struct PaletteNode
 
 static struct PaletteRecord pal_records[PALETTE_COLORS]; // for each color of a palette
 static struct PaletteNode pal_tree[MAX_COLOR_VALUE]; // For each component of a palette
+static unsigned char pal_lut[MAX_COLOR_VALUE * MAX_COLOR_VALUE * MAX_COLOR_VALUE]; // rgb -> palette index
+static unsigned char pal_lut_source[PALETTE_SIZE]; // palette pal_lut was built from
+static TbBool pal_lut_valid = false;
 static struct NamedCommand added_sprites[KEEPERSPRITE_ADD_NUM];
 static struct NamedCommand added_icons[GUI_PANEL_SPRITES_NEW];
 static int num_added_sprite = 0;
@@ -264,6 +267,29 @@ void init_custom_sprites(LevelNumber lvnum)
     }
 }
 
+/**
+ * Search pal_tree for palette color nearest to given one (components are 0-63)
+ */
+static unsigned char find_nearest_color(int r, int g, int b)
+{
+    const struct PaletteNode *node = &pal_tree[g];
+    uint8_t max_val = 255;
+    uint32_t max_dst = 3 * 64 * 64;
+
+    for (struct PaletteRecord *rec = node->rec; rec != node->rec + node->size; rec++)
+    {
+        int8_t dr = (rec->color & 0x00000FF) - r;
+        int8_t dg = ((rec->color & 0xFF00) >> 8) - g;
+        int8_t db = ((rec->color & 0xFF0000) >> 16) - b;
+        if (dr * dr + dg * dg + db * db < max_dst)
+        {
+            max_dst = dr * dr + dg * dg + db * db;
+            max_val = rec->color_idx;
+        }
+    }
+    return max_val;
+}
+
 /**
  * Setup data for rgb -> indexed conversion
  */
@@ -335,6 +361,21 @@ static void init_pal_conversion()
         }
     }
 #undef NEAREST_DEPTH
+    // 5. Filling lookup table; palette is the same between levels, so it is rebuilt only on change
+    if (pal_lut_valid && (memcmp(pal_lut_source, base_pal, PALETTE_SIZE) == 0))
+        return;
+    for (int b = 0; b < MAX_COLOR_VALUE; b++)
+    {
+        for (int g = 0; g < MAX_COLOR_VALUE; g++)
+        {
+            for (int r = 0; r < MAX_COLOR_VALUE; r++)
+            {
+                pal_lut[(b * MAX_COLOR_VALUE + g) * MAX_COLOR_VALUE + r] = find_nearest_color(r, g, b);
+            }
+        }
+    }
+    memcpy(pal_lut_source, base_pal, PALETTE_SIZE);
+    pal_lut_valid = true;
 }
 
 /**
@@ -807,23 +848,10 @@ static void convert_row(unsigned char *dst_buf, uint32_t *src_buf, int len)
     for (int i = 0; i < len; i++, src_buf++, dst_buf++)
     {
         uint32_t data = *src_buf;
-        int idx = ((data & 0x00FF00) >> 8) / SCALE;
-        const struct PaletteNode *node = &pal_tree[idx];
-        uint8_t max_val = 255;
-        uint32_t max_dst = 3 * 64 * 64;
-
-        for (struct PaletteRecord *rec = node->rec; rec != node->rec + node->size; rec++)
-        {
-            int8_t dr = (rec->color & 0x00000FF) - (data & 0x0000FF) / SCALE;
-            int8_t dg = ((rec->color & 0xFF00) >> 8) - ((data & 0xFF00) >> 8) / SCALE;
-            int8_t db = ((rec->color & 0xFF0000) >> 16) - ((data & 0xFF0000) >> 16) / SCALE;
-            if (dr * dr + dg * dg + db * db < max_dst)
-            {
-                max_dst = dr * dr + dg * dg + db * db;
-                max_val = rec->color_idx;
-            }
-        }
-        *dst_buf = max_val;
+        int r = (data & 0x0000FF) / SCALE;
+        int g = ((data & 0x00FF00) >> 8) / SCALE;
+        int b = ((data & 0xFF0000) >> 16) / SCALE;
+        *dst_buf = pal_lut[(b * MAX_COLOR_VALUE + g) * MAX_COLOR_VALUE + r];
     }
 #undef SCALE
 }
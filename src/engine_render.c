@@ -23,6 +23,7 @@
 
 #include "globals.h"
 #include "bflib_basics.h"
+#include "bflib_datetm.h"
 #include "bflib_fileio.h"
 #include "bflib_memory.h"
 #include "bflib_math.h"
@@ -58,6 +59,7 @@
 #include "player_states.h"
 #include "custom_sprites.h"
 #include "sprites.h"
+#include "thing_particles.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -518,6 +520,7 @@ static const char splittypes[64] = {
 #endif
 /******************************************************************************/
 static void do_map_who(short tnglist_idx);
+static void do_map_who_particles(const struct Map *mapblk);
 static void (*render_sprite_debug_fn) (struct Thing*, long scrpos_x, long scrpos_y) = NULL;
 static int render_sprite_debug_level = 0;
 static void draw_keepsprite_unscaled_in_buffer(unsigned short kspr_n, short a2, unsigned char field48, unsigned char *a4);
@@ -4170,6 +4173,7 @@ static void do_a_plane_of_engine_columns_perspective(long stl_x, long stl_y, lon
             n = get_mapwho_thing_index(mapblk);
             if (n != 0)
                 do_map_who(n);
+            do_map_who_particles(mapblk);
             colmn = get_map_column(mapblk);
         }
         // Retrieve solidmasks for surrounding area
@@ -4559,6 +4563,7 @@ static void do_a_plane_of_engine_columns_cluedo(long stl_x, long stl_y, long pla
             if (i > 0) {
               do_map_who(i);
             }
+            do_map_who_particles(cur_mapblk);
             cur_colmn = get_map_column(cur_mapblk);
             solidmsk_cur_raw = cur_colmn->solidmask;
             solidmsk_cur = solidmsk_cur_raw;
@@ -4754,6 +4759,7 @@ static void do_a_plane_of_engine_columns_isometric(long stl_x, long stl_y, long
             if (i > 0) {
               do_map_who(i);
             }
+            do_map_who_particles(cur_mapblk);
             cur_colmn = get_map_column(cur_mapblk);
         }
         // Get solidmasks of sibling columns
@@ -6908,7 +6914,9 @@ void draw_view(struct Camera *cam, unsigned char a2)
         process_isometric_map_volume_box(x, y, z, my_player_number);
     }
 
+    profiler_zone_start(Zone_DisplayDrawlist);
     display_drawlist();
+    profiler_zone_end(Zone_DisplayDrawlist);
     cam->zoom = zoom_mem;//TODO [zoom] remove when all cam->zoom will be changed to camera_zoom
     SYNCDBG(9,"Finished");
 }
@@ -7576,10 +7584,14 @@ static long load_single_frame(TbSpriteData *data_ptr, unsigned short kspr_idx)
 {
     long nlength;
     nlength = creature_table[kspr_idx+1].DataOffset - creature_table[kspr_idx].DataOffset;
-    *data_ptr = he_alloc(nlength);
-
-    LbFileSeek(jty_file_handle, creature_table[kspr_idx].DataOffset, 0);
-    LbFileRead(jty_file_handle, *data_ptr, nlength);
+    *data_ptr = keepsprite_store_get_data(creature_table[kspr_idx].DataOffset, nlength);
+    if (*data_ptr == NULL)
+    {
+        *data_ptr = he_alloc(nlength);
+        LbFileSeek(jty_file_handle, creature_table[kspr_idx].DataOffset, 0);
+        LbFileRead(jty_file_handle, *data_ptr, nlength);
+        keepsprite_store_count_read();
+    }
 
     keepsprite[kspr_idx] = data_ptr;
     return 1;
@@ -8963,6 +8975,34 @@ static void do_map_who(short tnglist_idx)
     }
 }
 
+/**
+ * Draws particles placed on given map block.
+ * Particles never move, so unlike things they need no interpolation.
+ */
+static void do_map_who_particles(const struct Map *mapblk)
+{
+    int bckt_idx;
+    struct EngineCoord ecor;
+    ParticleIndex i = get_mapwho_particle_index(mapblk);
+    while (i != 0)
+    {
+        struct Thing* thing = get_particle_draw_thing(i);
+        i = get_next_particle_on_mapblk(i);
+        if (getpoly >= poly_pool_end)
+            break;
+        ecor.field_8 = 0;
+        ecor.x = (thing->mappos.x.val - map_x_pos);
+        ecor.z = (map_y_pos - thing->mappos.y.val);
+        ecor.y = (thing->mappos.z.val - map_z_pos);
+        rotpers(&ecor, &camera_matrix);
+        if ( lens_mode )
+          bckt_idx = (ecor.z - 64) / 16;
+        else
+          bckt_idx = (ecor.z - 64) / 16 - 6;
+        add_thing_sprite_to_polypool(thing, ecor.view_width, ecor.view_height, ecor.z, bckt_idx);
+    }
+}
+
 static void draw_frontview_thing_on_element(struct Thing *thing, struct Map *map, struct Camera *cam)
 {
     // The draw_frontview_thing_on_element() function is the FrontView equivalent of do_map_who_for_thing()
@@ -9062,6 +9102,20 @@ static void draw_frontview_things_on_element(struct Map *mapblk, struct Camera *
             break;
         }
     }
+    // Particles; the FrontView equivalent of do_map_who_particles()
+    i = get_mapwho_particle_index(mapblk);
+    while (i != 0)
+    {
+        thing = get_particle_draw_thing(i);
+        i = get_next_particle_on_mapblk(i);
+        long cx;
+        long cy;
+        long cz;
+        convert_world_coord_to_front_view_screen_coord(&thing->mappos,cam,&cx,&cy,&cz);
+        if (!is_free_space_in_poly_pool(1))
+            break;
+        add_thing_sprite_to_polypool(thing, cx, cy, cy, cz-3);
+    }
 }
 
 void draw_frontview_engine(struct Camera *cam)
@@ -42,6 +42,7 @@
 #include "vidfade.h"
 #include "game_legacy.h"
 #include "sprites.h"
+#include "game_heap.h"
 
 #include "keeperfx.hpp"
 #include "post_inc.h"
@@ -685,6 +686,25 @@ void draw_frametime()
         }
         LbTextDrawResized(0, (28+i)*tx_units_per_px, tx_units_per_px, text);
     }
+    // Profiling zones; average and max over last frames, nested zones indented
+    if (debug_display_frametime == 3)
+    {
+        int line = 28 + TOTAL_FRAMETIME_KINDS;
+        for (int i = 0; i < TOTAL_PROFILER_ZONES; i++)
+        {
+            struct ProfilerZoneStats* zstat = &profiler_measurements.zones[i];
+            if (zstat->total_calls == 0)
+                continue;
+            text = buf_sprintf("%*s%s: %.3f avg %.3f max ms", 2*zstat->depth, "", profiler_zone_name(i), zstat->rolling_avg, zstat->rolling_max);
+            LbTextDrawResized(0, line*tx_units_per_px, tx_units_per_px, text);
+            line++;
+        }
+        struct KeepSpriteStoreStats kspstats;
+        get_keepsprite_store_stats(&kspstats);
+        text = buf_sprintf("Sprites: %lu served %lu read, %lu/%lu KiB preloaded", kspstats.frames_served,
+            kspstats.frames_read, kspstats.preloaded_size / 1024, kspstats.file_size / 1024);
+        LbTextDrawResized(0, line*tx_units_per_px, tx_units_per_px, text);
+    }
     lbDisplay.DrawFlags = Lb_TEXT_HALIGN_LEFT;
 }
 /******************************************************************************/
@@ -45,6 +45,9 @@ static unsigned char *sound_heap_memory;
 static unsigned char *heap;
 static long heap_size;
 static long sound_heap_size;
+/** Whole content of the JTY file, frames are served directly from it. */
+static unsigned char *jty_data;
+static struct KeepSpriteStoreStats keepsprite_store;
 /******************************************************************************/
 long get_smaller_memory_amount(long amount)
 {
@@ -87,9 +90,53 @@ TbBool setup_heap_manager(void)
         keepsprite[i] = NULL;
     for (i=0; i < KEEPSPRITE_LENGTH; i++)
         sprite_heap_handle[i] = NULL;
+    // Read the whole file at once, so that drawing a creature for the first time won't require file access
+    LbMemorySet(&keepsprite_store, 0, sizeof(keepsprite_store));
+    long len = LbFileLengthHandle(jty_file_handle);
+    if (len > 0)
+    {
+        keepsprite_store.file_size = len;
+        jty_data = (unsigned char *)he_alloc(len);
+        if (jty_data != NULL)
+        {
+            LbFileSeek(jty_file_handle, 0, Lb_FILE_SEEK_BEGINNING);
+            if (LbFileRead(jty_file_handle, jty_data, len) == len)
+            {
+                keepsprite_store.preloaded_size = len;
+            } else
+            {
+                WARNLOG("Could not preload JTY file, \"%s\"; frames will be loaded on demand",fname);
+                he_free(jty_data);
+                jty_data = NULL;
+            }
+        }
+    }
     return true;
 }
 
+/**
+ * Returns pointer to given part of the preloaded JTY file.
+ * @return The data pointer, or NULL if the file wasn't preloaded and the data has to be read.
+ */
+unsigned char *keepsprite_store_get_data(long offset, long length)
+{
+    if ((jty_data == NULL) || (offset < 0) || (length < 0)
+      || (offset + length > (long)keepsprite_store.preloaded_size))
+        return NULL;
+    keepsprite_store.frames_served++;
+    return &jty_data[offset];
+}
+
+void keepsprite_store_count_read(void)
+{
+    keepsprite_store.frames_read++;
+}
+
+void get_keepsprite_store_stats(struct KeepSpriteStoreStats *stats)
+{
+    *stats = keepsprite_store;
+}
+
 /**
  * Allocates graphics heap.
  */
@@ -137,6 +184,9 @@ void reset_heap_manager(void)
         LbFileClose(jty_file_handle);
         jty_file_handle = -1;
     }
+    he_free(jty_data);
+    jty_data = NULL;
+    keepsprite_store.preloaded_size = 0;
     for (i=0; i < KEEPSPRITE_LENGTH; i++)
         keepsprite[i] = NULL;
     for (i=0; i < KEEPSPRITE_LENGTH; i++)
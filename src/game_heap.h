@@ -26,12 +26,23 @@
 extern "C" {
 #endif
 
+/******************************************************************************/
+struct KeepSpriteStoreStats {
+    unsigned long file_size;
+    unsigned long preloaded_size;
+    unsigned long frames_served;
+    unsigned long frames_read;
+};
+
 /******************************************************************************/
 TbBool setup_heap_manager(void);
 TbBool setup_heap_memory(void);
 void reset_heap_manager(void);
 void reset_heap_memory(void);
 TbBool setup_heaps(void);
+unsigned char *keepsprite_store_get_data(long offset, long length);
+void keepsprite_store_count_read(void);
+void get_keepsprite_store_stats(struct KeepSpriteStoreStats *stats);
 
 /******************************************************************************/
 void *he_alloc(size_t size);
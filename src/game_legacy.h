@@ -141,7 +141,6 @@ char numfield_1A;
     unsigned char land_map_start;
     struct LightsShadows lish;
     struct CreatureControl cctrl_data[CREATURES_COUNT];
-    struct Thing things_data[THINGS_COUNT];
     unsigned char navigation_map[MAX_SUBTILES_X*MAX_SUBTILES_Y];
     struct Map map[MAX_SUBTILES_X*MAX_SUBTILES_Y]; // field offset 0xDC157
     struct ComputerTask computer_task[COMPUTER_TASKS_COUNT];
@@ -181,9 +180,6 @@ unsigned int packet_file_pos;
     short texture_animation[8*TEXTURE_BLOCKS_ANIM_COUNT];
     unsigned short columns_used;
     unsigned char texture_id;
-    unsigned short free_things[THINGS_COUNT-1];
-    /** Index of the first used element in free things array. All elements BEYOND this index are free. If all things are free, it is set to 0. */
-    ThingIndex free_things_start_index;
     GameTurn play_gameturn;
     GameTurn pckt_gameturn;
     /** Synchronized random seed. used for game actions, as it's always identical for clients of network game. */
@@ -31,6 +31,7 @@
 #include "sounds.h"
 #include "game_legacy.h"
 #include "game_loop.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -134,6 +135,7 @@ void process_dungeon_destroy(struct Thing* heartng)
                 struct Thing* bheartng = thing_get(dungeonadd->backup_heart_idx);
                 soultng->mappos = bheartng->mappos;
                 soultng->mappos.z.val = get_ceiling_height_at(&bheartng->mappos);
+                mark_thing_sync_hash_dirty(soultng);
             }
             else if (dungeon->heart_destroy_turn == 28)
             {
@@ -216,7 +216,10 @@ void update_extra_levels_visibility(void)
 
 struct ThingAdd *get_thingadd(Thingid thing_idx)
 {
-    return &gameadd.things[thing_idx];
+    struct ThingsPage* page = get_things_page(thing_idx / THINGS_PAGE_SIZE);
+    if (page == NULL)
+        return &things_page_first.adds[0];
+    return &page->adds[thing_idx % THINGS_PAGE_SIZE];
 }
 struct LightAdd *get_lightadd(unsigned short light_idx)
 {
@@ -160,6 +160,9 @@ struct GameAdd {
     unsigned char stun_enemy_chance_evil;
     unsigned char stun_enemy_chance_good;
     long critical_health_permil;
+    unsigned short combat_check_interval;
+    unsigned short needs_check_interval;
+    unsigned short job_check_interval;
     long friendly_fight_area_damage_permil;
     long friendly_fight_area_range_permil;
     unsigned char torture_death_chance;
@@ -206,7 +209,6 @@ struct GameAdd {
     struct ActionPoint action_points[ACTN_POINTS_COUNT];
     struct DungeonAdd dungeon[DUNGEONS_COUNT];
 
-    struct ThingAdd things[THINGS_COUNT];
     struct LightAdd lights[LIGHTS_COUNT];
 
     struct Objects thing_objects_data[OBJECT_TYPES_COUNT];
@@ -44,6 +44,8 @@
 #include "frontmenu_ingame_map.h"
 #include "gui_boxmenu.h"
 #include "keeperfx.hpp"
+#include <zlib.h>
+#include <SDL2/SDL.h>
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -94,49 +96,140 @@ short save_version_compatible(long filesize,struct Game *header)
   return false;
 }*/
 
-TbBool save_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
+/**
+ * Appends a chunk to memory buffer, in the same form as it would be written to a file.
+ */
+static unsigned char *store_game_chunk(unsigned char *dst, unsigned long id, const void *data, unsigned long len)
 {
     struct FileChunkHeader hdr;
-    long chunks_done = 0;
+    hdr.id = id;
+    hdr.ver = 0;
+    hdr.len = len;
+    LbMemoryCopy(dst, &hdr, sizeof(struct FileChunkHeader));
+    dst += sizeof(struct FileChunkHeader);
+    LbMemoryCopy(dst, data, len);
+    return dst + len;
+}
+
+/**
+ * Appends all pages of things storage to memory buffer, as one chunk.
+ */
+static unsigned char *store_things_pages_chunk(unsigned char *dst)
+{
+    struct FileChunkHeader hdr;
+    hdr.id = SGC_ThingsPages;
+    hdr.ver = 0;
+    hdr.len = game.things.pages_count * sizeof(struct ThingsPage);
+    LbMemoryCopy(dst, &hdr, sizeof(struct FileChunkHeader));
+    dst += sizeof(struct FileChunkHeader);
+    for (long i = 0; i < game.things.pages_count; i++)
+    {
+        LbMemoryCopy(dst, get_things_page(i), sizeof(struct ThingsPage));
+        dst += sizeof(struct ThingsPage);
+    }
+    return dst;
+}
+
+/**
+ * Copies the saved game chunks into a memory buffer, in their raw form.
+ * The copy is what gets written, so the game may go on while it is stored.
+ * @param staged_len Receives size of the data.
+ * @return The buffer, to be freed with LbMemoryFree(); NULL on failure.
+ */
+static unsigned char *stage_game_chunks(struct CatalogueEntry *centry, unsigned long *staged_len)
+{
+    const unsigned long len = 5 * sizeof(struct FileChunkHeader) + sizeof(struct CatalogueEntry)
+        + sizeof(struct Game) + sizeof(struct GameAdd) + sizeof(struct IntralevelData)
+        + game.things.pages_count * sizeof(struct ThingsPage);
+    unsigned char* buf = LbMemoryAlloc(len);
+    if (buf == NULL)
+        return NULL;
     // Currently there is some game data oustide of structs - make sure it is updated
     light_export_system_state(&gameadd.lightst);
-    { // Info chunk
-        hdr.id = SGC_InfoBlock;
-        hdr.ver = 0;
-        hdr.len = sizeof(struct CatalogueEntry);
+    unsigned char* dst = buf;
+    dst = store_game_chunk(dst, SGC_InfoBlock, centry, sizeof(struct CatalogueEntry));
+    dst = store_game_chunk(dst, SGC_GameOrig, &game, sizeof(struct Game));
+    dst = store_things_pages_chunk(dst);
+    dst = store_game_chunk(dst, SGC_GameAdd, &gameadd, sizeof(struct GameAdd));
+    dst = store_game_chunk(dst, SGC_IntralevelData, &intralvl, sizeof(struct IntralevelData));
+    *staged_len = dst - buf;
+    return buf;
+}
+
+/**
+ * Writes staged chunks to a file. Game state chunks are compressed, the info block
+ * is left raw so that the saves catalogue can be read without unpacking.
+ * @note Called from the saving thread - must not access game state nor log.
+ */
+static TbBool write_staged_game_chunks(TbFileHandle fhandle, const unsigned char *staged, unsigned long staged_len)
+{
+    long chunks_done = 0;
+    const unsigned char* src = staged;
+    while (src + sizeof(struct FileChunkHeader) <= staged + staged_len)
+    {
+        struct FileChunkHeader hdr;
+        LbMemoryCopy(&hdr, src, sizeof(struct FileChunkHeader));
+        src += sizeof(struct FileChunkHeader);
+        const unsigned char* data = src;
+        src += hdr.len;
+        unsigned char* packed = NULL;
+        if (hdr.id != SGC_InfoBlock)
+        {
+            uLongf packed_len = compressBound(hdr.len);
+            packed = LbMemoryAlloc(packed_len);
+            if (packed == NULL)
+                break;
+            if (compress2(packed, &packed_len, data, hdr.len, Z_BEST_SPEED) != Z_OK)
+            {
+                LbMemoryFree(packed);
+                break;
+            }
+            data = packed;
+            hdr.ver = SGV_Compressed;
+            hdr.len = packed_len;
+        }
+        TbBool written = false;
         if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
-        if (LbFileWrite(fhandle, centry, sizeof(struct CatalogueEntry)) == sizeof(struct CatalogueEntry))
+        if (LbFileWrite(fhandle, data, hdr.len) == hdr.len)
+            written = true;
+        LbMemoryFree(packed);
+        if (!written)
+            break;
+        switch (hdr.id)
+        {
+        case SGC_InfoBlock:
             chunks_done |= SGF_InfoBlock;
-    }
-    { // Game data chunk
-        hdr.id = SGC_GameOrig;
-        hdr.ver = 0;
-        hdr.len = sizeof(struct Game);
-        if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
-        if (LbFileWrite(fhandle, &game, sizeof(struct Game)) == sizeof(struct Game))
+            break;
+        case SGC_GameOrig:
             chunks_done |= SGF_GameOrig;
-    }
-    { // GameAdd data chunk
-        hdr.id = SGC_GameAdd;
-        hdr.ver = 0;
-        hdr.len = sizeof(struct GameAdd);
-        if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
-        if (LbFileWrite(fhandle, &gameadd, sizeof(struct GameAdd)) == sizeof(struct GameAdd))
+            break;
+        case SGC_GameAdd:
             chunks_done |= SGF_GameAdd;
-    }
-    { // IntralevelData data chunk
-        hdr.id = SGC_IntralevelData;
-        hdr.ver = 0;
-        hdr.len = sizeof(struct IntralevelData);
-        if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
-        if (LbFileWrite(fhandle, &intralvl, sizeof(struct IntralevelData)) == sizeof(struct IntralevelData))
+            break;
+        case SGC_IntralevelData:
             chunks_done |= SGF_IntralevelData;
+            break;
+        case SGC_ThingsPages:
+            chunks_done |= SGF_ThingsPages;
+            break;
+        }
     }
     if (chunks_done != SGF_SavedGame)
         return false;
     return true;
 }
 
+TbBool save_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
+{
+    unsigned long staged_len;
+    unsigned char* staged = stage_game_chunks(centry, &staged_len);
+    if (staged == NULL)
+        return false;
+    TbBool result = write_staged_game_chunks(fhandle, staged, staged_len);
+    LbMemoryFree(staged);
+    return result;
+}
+
 TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
 {
     struct FileChunkHeader hdr;
@@ -168,6 +261,22 @@ TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
             if (LbFileWrite(fhandle, &game, sizeof(struct Game)) == sizeof(struct Game))
                 chunks_done |= SGF_GameOrig;
         }
+        { // Things storage chunk
+            hdr.id = SGC_ThingsPages;
+            hdr.ver = 0;
+            hdr.len = game.things.pages_count * sizeof(struct ThingsPage);
+            if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
+            {
+                long i;
+                for (i = 0; i < game.things.pages_count; i++)
+                {
+                    if (LbFileWrite(fhandle, get_things_page(i), sizeof(struct ThingsPage)) != sizeof(struct ThingsPage))
+                        break;
+                }
+                if (i == game.things.pages_count)
+                    chunks_done |= SGF_ThingsPages;
+            }
+        }
         { // GameAdd data chunk
             hdr.id = SGC_GameAdd;
             hdr.ver = 0;
@@ -179,7 +288,7 @@ TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
     }
     { // Packet file data start indicator
         hdr.id = SGC_PacketData;
-        hdr.ver = 0;
+        hdr.ver = PckDV_Keyframes;
         hdr.len = 0;
         if (LbFileWrite(fhandle, &hdr, sizeof(struct FileChunkHeader)) == sizeof(struct FileChunkHeader))
             chunks_done |= SGF_PacketData;
@@ -189,9 +298,96 @@ TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
     return true;
 }
 
+/**
+ * Reads game state chunk into given struct. Supports raw and compressed chunks;
+ * either way, the stored data must have exactly the size of the struct.
+ */
+static TbBool load_game_state_chunk(TbFileHandle fhandle, const struct FileChunkHeader *hdr, void *data, unsigned long data_len, const char *name)
+{
+    if (hdr->ver == SGV_Compressed)
+    {
+        unsigned char* packed = LbMemoryAlloc(hdr->len);
+        if (packed == NULL)
+        {
+            if (LbFileSeek(fhandle, hdr->len, Lb_FILE_SEEK_CURRENT) < 0)
+                LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
+            WARNLOG("Cannot allocate buffer for %s chunk",name);
+            return false;
+        }
+        if (LbFileRead(fhandle, packed, hdr->len) != hdr->len)
+        {
+            LbMemoryFree(packed);
+            WARNLOG("Could not read %s chunk",name);
+            return false;
+        }
+        // Unpack to a temporary buffer, so that a broken chunk won't leave the struct half-filled
+        uLongf raw_len = data_len;
+        unsigned char* raw = LbMemoryAlloc(data_len);
+        TbBool result = false;
+        if (raw != NULL)
+        {
+            if ((uncompress(raw, &raw_len, packed, hdr->len) == Z_OK) && (raw_len == data_len))
+            {
+                LbMemoryCopy(data, raw, data_len);
+                result = true;
+            } else
+            {
+                WARNLOG("Incompatible %s chunk",name);
+            }
+            LbMemoryFree(raw);
+        }
+        LbMemoryFree(packed);
+        return result;
+    }
+    if ((hdr->ver != SGV_Raw) || (hdr->len != data_len))
+    {
+        if (LbFileSeek(fhandle, hdr->len, Lb_FILE_SEEK_CURRENT) < 0)
+            LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
+        WARNLOG("Incompatible %s chunk",name);
+        return false;
+    }
+    if (LbFileRead(fhandle, data, data_len) != data_len)
+    {
+        WARNLOG("Could not read %s chunk",name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Reads things storage chunk. Amount of pages is stored in game struct,
+ * so the chunk must follow GameOrig chunk.
+ * @param pages_count Amount of pages read from GameOrig chunk.
+ */
+static TbBool load_things_pages_chunk(TbFileHandle fhandle, const struct FileChunkHeader *hdr, long chunks_done, unsigned short pages_count)
+{
+    if (((chunks_done & SGF_GameOrig) == 0) || (pages_count < 1) || (pages_count > THINGS_PAGES_MAX))
+    {
+        if (LbFileSeek(fhandle, hdr->len, Lb_FILE_SEEK_CURRENT) < 0)
+            LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
+        WARNLOG("Incompatible ThingsPages chunk");
+        return false;
+    }
+    unsigned long data_len = pages_count * sizeof(struct ThingsPage);
+    unsigned char* data = LbMemoryAlloc(data_len);
+    if (data == NULL)
+    {
+        if (LbFileSeek(fhandle, hdr->len, Lb_FILE_SEEK_CURRENT) < 0)
+            LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
+        WARNLOG("Cannot allocate buffer for ThingsPages chunk");
+        return false;
+    }
+    TbBool result = false;
+    if (load_game_state_chunk(fhandle, hdr, data, data_len, "ThingsPages"))
+        result = restore_things_pages(data, data_len);
+    LbMemoryFree(data);
+    return result;
+}
+
 int load_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
 {
     long chunks_done = 0;
+    unsigned short pages_count = 0;
     while (!LbFileEof(fhandle))
     {
         struct FileChunkHeader hdr;
@@ -217,33 +413,24 @@ int load_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
             }
             break;
         case SGC_GameAdd:
-            if (hdr.len != sizeof(struct GameAdd))
-            {
-                if (LbFileSeek(fhandle, hdr.len, Lb_FILE_SEEK_CURRENT) < 0)
-                    LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
-                WARNLOG("Incompatible GameAdd chunk");
-                break;
-            }
-            if (LbFileRead(fhandle, &gameadd, sizeof(struct GameAdd)) == sizeof(struct GameAdd)) {
-            //accept invalid saves -- if (LbFileRead(fhandle, &gameadd, hdr.len) == hdr.len) {
+            if (load_game_state_chunk(fhandle, &hdr, &gameadd, sizeof(struct GameAdd), "GameAdd"))
                 chunks_done |= SGF_GameAdd;
-            } else {
-                WARNLOG("Could not read GameAdd chunk");
-            }
             break;
         case SGC_GameOrig:
-            if (hdr.len != sizeof(struct Game))
+        {
+            // Amount of pages is only updated when pages are restored, so that it always matches allocated storage
+            unsigned short allocated_pages_count = game.things.pages_count;
+            if (load_game_state_chunk(fhandle, &hdr, &game, sizeof(struct Game), "GameOrig"))
             {
-                if (LbFileSeek(fhandle, hdr.len, Lb_FILE_SEEK_CURRENT) < 0)
-                    LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
-                WARNLOG("Incompatible GameOrig chunk");
-                break;
-            }
-            if (LbFileRead(fhandle, &game, sizeof(struct Game)) == sizeof(struct Game)) {
                 chunks_done |= SGF_GameOrig;
-            } else {
-                WARNLOG("Could not read GameOrig chunk");
+                pages_count = game.things.pages_count;
             }
+            game.things.pages_count = allocated_pages_count;
+            break;
+        }
+        case SGC_ThingsPages:
+            if (load_things_pages_chunk(fhandle, &hdr, chunks_done, pages_count))
+                chunks_done |= SGF_ThingsPages;
             break;
         case SGC_PacketHeader:
             if (hdr.len != sizeof(struct PacketSaveHead))
@@ -275,18 +462,8 @@ int load_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
                 return GLoad_PacketStart;
             return GLoad_Failed;
         case SGC_IntralevelData:
-            if (hdr.len != sizeof(struct IntralevelData))
-            {
-                if (LbFileSeek(fhandle, hdr.len, Lb_FILE_SEEK_CURRENT) < 0)
-                    LbFileSeek(fhandle, 0, Lb_FILE_SEEK_END);
-                WARNLOG("Incompatible IntralevelData chunk");
-                break;
-            }
-            if (LbFileRead(fhandle, &intralvl, sizeof(struct IntralevelData)) == sizeof(struct IntralevelData)) {
+            if (load_game_state_chunk(fhandle, &hdr, &intralvl, sizeof(struct IntralevelData), "IntralevelData"))
                 chunks_done |= SGF_IntralevelData;
-            } else {
-                WARNLOG("Could not read IntralevelData chunk");
-            }
             break;
         default:
             WARNLOG("Unrecognized chunk, ID = %08lx",hdr.id);
@@ -302,34 +479,246 @@ int load_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry)
     return GLoad_Failed;
 }
 
+/**
+ * Makes a compressed snapshot of game state, consisting of the same game
+ * state chunks which are stored in saved game.
+ * @param packed_len Receives size of the snapshot.
+ * @return The snapshot buffer, to be freed with LbMemoryFree(); NULL on failure.
+ */
+unsigned char *pack_game_state_snapshot(unsigned long *packed_len)
+{
+    const unsigned long raw_len = 4 * sizeof(struct FileChunkHeader)
+        + sizeof(struct Game) + sizeof(struct GameAdd) + sizeof(struct IntralevelData)
+        + game.things.pages_count * sizeof(struct ThingsPage);
+    // Currently there is some game data oustide of structs - make sure it is updated
+    light_export_system_state(&gameadd.lightst);
+    unsigned char* raw = LbMemoryAlloc(raw_len);
+    uLongf len = compressBound(raw_len);
+    unsigned char* packed = LbMemoryAlloc(len);
+    if ((raw == NULL) || (packed == NULL))
+    {
+        LbMemoryFree(raw);
+        LbMemoryFree(packed);
+        return NULL;
+    }
+    unsigned char* dst = raw;
+    dst = store_game_chunk(dst, SGC_GameOrig, &game, sizeof(struct Game));
+    dst = store_things_pages_chunk(dst);
+    dst = store_game_chunk(dst, SGC_GameAdd, &gameadd, sizeof(struct GameAdd));
+    dst = store_game_chunk(dst, SGC_IntralevelData, &intralvl, sizeof(struct IntralevelData));
+    if (compress2(packed, &len, raw, raw_len, Z_BEST_SPEED) != Z_OK)
+    {
+        LbMemoryFree(raw);
+        LbMemoryFree(packed);
+        return NULL;
+    }
+    LbMemoryFree(raw);
+    *packed_len = len;
+    return packed;
+}
+
+/**
+ * Restores game state from snapshot made by pack_game_state_snapshot().
+ * Chunks are verified the same way load_game_chunks() does; the state is
+ * only modified if all of them are correct.
+ */
+TbBool unpack_game_state_snapshot(const unsigned char *packed, unsigned long packed_len)
+{
+    // Amount of things pages is not known before unpacking, so make room for the max
+    const unsigned long raw_max_len = 4 * sizeof(struct FileChunkHeader)
+        + sizeof(struct Game) + sizeof(struct GameAdd) + sizeof(struct IntralevelData)
+        + THINGS_PAGES_MAX * sizeof(struct ThingsPage);
+    unsigned char* raw = LbMemoryAlloc(raw_max_len);
+    if (raw == NULL)
+        return false;
+    uLongf raw_len = raw_max_len;
+    if (uncompress(raw, &raw_len, packed, packed_len) != Z_OK)
+    {
+        WARNLOG("Could not unpack game state snapshot");
+        LbMemoryFree(raw);
+        return false;
+    }
+    const unsigned char* src = raw;
+    long chunks_done = 0;
+    void* data[4] = {NULL, NULL, NULL, NULL};
+    unsigned long things_len = 0;
+    while (src + sizeof(struct FileChunkHeader) <= raw + raw_len)
+    {
+        struct FileChunkHeader hdr;
+        LbMemoryCopy(&hdr, src, sizeof(struct FileChunkHeader));
+        src += sizeof(struct FileChunkHeader);
+        if (src + hdr.len > raw + raw_len) {
+            WARNLOG("Truncated chunk in game state snapshot, ID = %08lx",hdr.id);
+            break;
+        }
+        if ((hdr.id == SGC_GameOrig) && (hdr.len == sizeof(struct Game))) {
+            data[0] = (void *)src;
+            chunks_done |= SGF_GameOrig;
+        } else
+        if ((hdr.id == SGC_GameAdd) && (hdr.len == sizeof(struct GameAdd))) {
+            data[1] = (void *)src;
+            chunks_done |= SGF_GameAdd;
+        } else
+        if ((hdr.id == SGC_IntralevelData) && (hdr.len == sizeof(struct IntralevelData))) {
+            data[2] = (void *)src;
+            chunks_done |= SGF_IntralevelData;
+        } else
+        if ((hdr.id == SGC_ThingsPages) && (hdr.len > 0) && ((hdr.len % sizeof(struct ThingsPage)) == 0)) {
+            data[3] = (void *)src;
+            things_len = hdr.len;
+            chunks_done |= SGF_ThingsPages;
+        } else
+        {
+            WARNLOG("Incompatible chunk in game state snapshot, ID = %08lx",hdr.id);
+            break;
+        }
+        src += hdr.len;
+    }
+    if (chunks_done != (SGF_GameOrig|SGF_GameAdd|SGF_IntralevelData|SGF_ThingsPages))
+    {
+        LbMemoryFree(raw);
+        return false;
+    }
+    if (((const struct Game *)data[0])->things.pages_count * sizeof(struct ThingsPage) != things_len)
+    {
+        WARNLOG("Things pages in game state snapshot don't match game data");
+        LbMemoryFree(raw);
+        return false;
+    }
+    if (!restore_things_pages(data[3], things_len))
+    {
+        LbMemoryFree(raw);
+        return false;
+    }
+    LbMemoryCopy(&game, data[0], sizeof(struct Game));
+    LbMemoryCopy(&gameadd, data[1], sizeof(struct GameAdd));
+    LbMemoryCopy(&intralvl, data[2], sizeof(struct IntralevelData));
+    LbMemoryFree(raw);
+    return true;
+}
+
+/** Saved game which is being written in background. */
+struct SaveGameJob {
+    SDL_Thread *thread;
+    SDL_atomic_t done;
+    unsigned char *staged;
+    unsigned long staged_len;
+    char fname[DISKPATH_SIZE];
+    char tmp_fname[DISKPATH_SIZE];
+    TbBool result;
+};
+
+static struct SaveGameJob save_job;
+
+/**
+ * Saving thread; writes staged chunks to a temporary file, then replaces the saved game with it.
+ * The previous save stays untouched if anything fails.
+ */
+static TbBool write_save_game_job(struct SaveGameJob *job)
+{
+    LbFileDelete(job->tmp_fname);
+    TbFileHandle handle = LbFileOpen(job->tmp_fname, Lb_FILE_MODE_NEW);
+    if (handle == -1)
+        return false;
+    TbBool written = write_staged_game_chunks(handle, job->staged, job->staged_len);
+    LbFileClose(handle);
+    if (!written)
+    {
+        LbFileDelete(job->tmp_fname);
+        return false;
+    }
+    if (LbFileReplace(job->tmp_fname, job->fname) != 1)
+    {
+        LbFileDelete(job->tmp_fname);
+        return false;
+    }
+    return true;
+}
+
+static int SDLCALL save_game_worker(void *data)
+{
+    struct SaveGameJob* job = (struct SaveGameJob *)data;
+    job->result = write_save_game_job(job);
+    SDL_AtomicSet(&job->done, 1);
+    return job->result;
+}
+
+/**
+ * Waits for the saved game being written in background, if there is one,
+ * and tells the player whether it was written.
+ * @return False if the pending save has failed, true otherwise.
+ */
+TbBool finish_pending_save_game(void)
+{
+    if (save_job.staged == NULL)
+        return true;
+    if (save_job.thread != NULL)
+    {
+        SDL_WaitThread(save_job.thread, NULL);
+        save_job.thread = NULL;
+    }
+    TbBool result = save_job.result;
+    if (result) {
+        SYNCDBG(7,"Saved game written to \"%s\"",save_job.fname);
+        output_message(SMsg_GameSaved, 0, true);
+    } else {
+        WARNMSG("Cannot write to save file, \"%s\".",save_job.fname);
+        create_error_box(GUIStr_ErrorSaving);
+    }
+    LbMemoryFree(save_job.staged);
+    save_job.staged = NULL;
+    save_job.staged_len = 0;
+    return result;
+}
+
+/**
+ * Finishes the saved game being written in background, if writing it has ended.
+ * To be called every turn; doesn't wait for the writing thread.
+ */
+void update_pending_save_game(void)
+{
+    if ((save_job.staged == NULL) || (SDL_AtomicGet(&save_job.done) == 0))
+        return;
+    finish_pending_save_game();
+}
+
 /**
  * Saves the game state file (savegame).
+ * The state is copied when this function is called; compressing and writing it
+ * to disk is done by a background thread, while the game goes on.
+ * Result of writing is reported to the player when the thread ends.
  * @note fill_game_catalogue_entry() should be called before to fill level information.
  *
  * @param slot_num
- * @return
+ * @return True if saving has started, false if the state couldn't be copied.
  */
 TbBool save_game(long slot_num)
 {
+    // Only one save may be written at a time
+    finish_pending_save_game();
     if (!save_game_save_catalogue())
         return false;
 /*  game.version_major = VersionMajor;
     game.version_minor = VersionMinor;
     game.load_restart_level = get_loaded_level_number();*/
     char* fname = prepare_file_fmtpath(FGrp_Save, saved_game_filename, slot_num);
-    TbFileHandle handle = LbFileOpen(fname, Lb_FILE_MODE_NEW);
-    if (handle == -1)
+    snprintf(save_job.fname, sizeof(save_job.fname), "%s", fname);
+    snprintf(save_job.tmp_fname, sizeof(save_job.tmp_fname), "%s.tmp", fname);
+    save_job.staged = stage_game_chunks(&save_game_catalogue[slot_num], &save_job.staged_len);
+    if (save_job.staged == NULL)
     {
-        WARNMSG("Cannot open file to save, \"%s\".",fname);
+        WARNMSG("Cannot allocate buffer to save, \"%s\".",save_job.fname);
         return false;
     }
-    if (!save_game_chunks(handle,&save_game_catalogue[slot_num]))
+    save_job.result = false;
+    SDL_AtomicSet(&save_job.done, 0);
+    save_job.thread = SDL_CreateThread(save_game_worker, "SaveGame", &save_job);
+    if (save_job.thread == NULL)
     {
-        LbFileClose(handle);
-        WARNMSG("Cannot write to save file, \"%s\".",fname);
-        return false;
+        // Cannot write in background; do it now
+        save_game_worker(&save_job);
+        finish_pending_save_game();
     }
-    LbFileClose(handle);
     return true;
 }
 
@@ -358,6 +747,8 @@ TbBool load_game(long slot_num)
 //  unsigned char buf[14];
 //  char cmpgn_fname[CAMPAIGN_FNAME_LEN];
     SYNCDBG(6,"Starting");
+    // The save being written may be the one to load
+    finish_pending_save_game();
     reset_eye_lenses();
     {
         // Use fname only here - it is overwritten by next use of prepare_file_fmtpath()
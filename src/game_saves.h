@@ -38,6 +38,7 @@ enum SaveGameChunks {
      SGC_PacketHeader   = 0x52444850, //"PHDR"
      SGC_PacketData     = 0x544B4350, //"PCKT"
      SGC_IntralevelData = 0x4C564C49, //"ILVL"
+     SGC_ThingsPages    = 0x50474E54, //"TNGP"
 };
 
 enum SaveGameChunkFlags {
@@ -47,10 +48,23 @@ enum SaveGameChunkFlags {
      SGF_PacketHeader   = 0x0100,
      SGF_PacketData     = 0x0200,
      SGF_IntralevelData = 0x0400,
+     SGF_ThingsPages    = 0x0800,
 };
-#define SGF_SavedGame      (SGF_InfoBlock|SGF_GameOrig|SGF_GameAdd|SGF_IntralevelData)
+/** Formats of turn data which follows SGC_PacketData chunk header; stored as chunk version. */
+enum PacketDataVersions {
+     PckDV_Raw          = 0, // fixed size record for every turn
+     PckDV_Indexed      = 1, // run-length coded records, with trailing index of turns
+     PckDV_Keyframes    = 2, // indexed, with game state snapshots between records
+};
+/** Formats of game state chunks in saved games; stored as chunk version. */
+enum SaveGameChunkVersions {
+     SGV_Raw            = 0, // struct stored as-is
+     SGV_Compressed     = 1, // struct compressed with zlib, chunk length is the packed size
+};
+
+#define SGF_SavedGame      (SGF_InfoBlock|SGF_GameOrig|SGF_GameAdd|SGF_IntralevelData|SGF_ThingsPages)
 #define SGF_PacketStart    (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock)
-#define SGF_PacketContinue (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock|SGF_GameOrig|SGF_GameAdd)
+#define SGF_PacketContinue (SGF_PacketHeader|SGF_PacketData|SGF_InfoBlock|SGF_GameOrig|SGF_GameAdd|SGF_ThingsPages)
 
 enum GameLoadStatus {
     GLoad_Failed = 0,
@@ -98,9 +112,13 @@ int load_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry);
 TbBool fill_game_catalogue_entry(struct CatalogueEntry *centry,const char *textname);
 TbBool save_game_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry);
 TbBool save_packet_chunks(TbFileHandle fhandle,struct CatalogueEntry *centry);
+unsigned char *pack_game_state_snapshot(unsigned long *packed_len);
+TbBool unpack_game_state_snapshot(const unsigned char *packed, unsigned long packed_len);
 /******************************************************************************/
 TbBool load_game(long slot_idx);
 TbBool save_game(long slot_idx);
+TbBool finish_pending_save_game(void);
+void update_pending_save_game(void);
 TbBool initialise_load_game_slots(void);
 int count_valid_saved_games(void);
 TbBool is_save_game_loadable(long slot_num);
@@ -200,6 +200,8 @@ typedef unsigned char ThingClass;
 typedef unsigned char ThingModel;
 /** Type which stores thing index. */
 typedef unsigned short ThingIndex;
+/** Type which stores allocation counter of a thing slot, used to detect stale thing indices. */
+typedef unsigned short ThingGeneration;
 /** Type which stores creature state index. */
 typedef unsigned short CrtrStateId;
 /** Type which stores creature experience level. */
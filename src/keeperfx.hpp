@@ -88,6 +88,7 @@ enum FFlags {
 enum DebugFlags {
     DFlg_ShotsDamage        =  0x01,
     DFlg_CreatrPaths        =  0x02,
+    DFlg_SyncHash           =  0x04,
 };
 
 #ifdef AUTOTESTING
@@ -128,6 +129,9 @@ struct StartupParameters {
     unsigned char force_ppro_poly;
     int frame_skip;
     char selected_campaign[CMDLN_MAXLEN+1];
+    unsigned char benchmark;
+    unsigned long exit_at_turn;
+    unsigned long packet_seek_turn;
 #ifdef AUTOTESTING
     unsigned char autotest_flags;
     unsigned long autotest_exit_turn;
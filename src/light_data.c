@@ -24,6 +24,7 @@
 #include "bflib_memory.h"
 #include "bflib_math.h"
 #include "bflib_planar.h"
+#include "bflib_datetm.h"
 
 #include "engine_render.h"
 #include "player_data.h"
@@ -51,8 +52,107 @@ static long light_rendered_dynamic_lights;
 static long light_rendered_optimised_dynamic_lights;
 static long light_updated_stat_lights;
 static long light_out_of_date_stat_lights;
+
+struct LightRenderParams {
+    MapCoord pos_x;
+    MapCoord pos_y;
+    long radius;
+    long render_intensity;
+    unsigned int lighting_tables_idx;
+};
+
+/** What a dynamic light looked like when it was last rendered into subtile_lightness. */
+struct LightRenderState {
+    unsigned long frame;
+    TbBool changed;
+    unsigned char flags;
+    unsigned short shadow_index;
+    MapCoord pos_z;
+    struct LightRenderParams params;
+};
+
+static struct LightRenderState light_render_state[LIGHTS_COUNT];
+static unsigned long light_render_frame = 1;
+static TbBool light_render_full_update = true;
+static MapSubtlCoord light_render_last_area[4];
+static long light_render_last_ambient;
+static TbBool light_render_last_enabled;
+/** Per row range of subtiles which have to be recomposed in the next light_render_area() call; empty if start > end. */
+static MapSubtlCoord light_dirty_start_x[MAX_SUBTILES_Y];
+static MapSubtlCoord light_dirty_end_x[MAX_SUBTILES_Y];
 /******************************************************************************/
 
+/**
+ * Marks subtiles in given rectangle (inclusive) as needing to be recomposed
+ * by the next light_render_area() call.
+ */
+static void light_mark_dirty_area(MapSubtlCoord start_stl_x, MapSubtlCoord start_stl_y, MapSubtlCoord end_stl_x, MapSubtlCoord end_stl_y)
+{
+    if (start_stl_x < 0) start_stl_x = 0;
+    if (start_stl_y < 0) start_stl_y = 0;
+    if (end_stl_x > gameadd.map_subtiles_x) end_stl_x = gameadd.map_subtiles_x;
+    if (end_stl_y > gameadd.map_subtiles_y) end_stl_y = gameadd.map_subtiles_y;
+    if ((end_stl_x < start_stl_x) || (end_stl_y < start_stl_y))
+        return;
+    for (MapSubtlCoord stl_y = start_stl_y; stl_y <= end_stl_y; stl_y++)
+    {
+        if (light_dirty_start_x[stl_y] > start_stl_x)
+            light_dirty_start_x[stl_y] = start_stl_x;
+        if (light_dirty_end_x[stl_y] < end_stl_x)
+            light_dirty_end_x[stl_y] = end_stl_x;
+    }
+}
+
+static TbBool light_area_is_dirty(MapSubtlCoord start_stl_x, MapSubtlCoord start_stl_y, MapSubtlCoord end_stl_x, MapSubtlCoord end_stl_y)
+{
+    if (start_stl_y < 0) start_stl_y = 0;
+    if (end_stl_y > gameadd.map_subtiles_y) end_stl_y = gameadd.map_subtiles_y;
+    for (MapSubtlCoord stl_y = start_stl_y; stl_y <= end_stl_y; stl_y++)
+    {
+        if ((light_dirty_start_x[stl_y] <= end_stl_x) && (light_dirty_end_x[stl_y] >= start_stl_x))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Area which may be touched when rendering a light with given params.
+ * Lighting tables never reach further than lighting_tables_idx subtiles; one more is added for safety.
+ */
+static void light_mark_dirty_render_area(const struct LightRenderParams *params)
+{
+    MapSubtlCoord stl_x = coord_subtile(params->pos_x);
+    MapSubtlCoord stl_y = coord_subtile(params->pos_y);
+    MapSubtlDelta range = params->lighting_tables_idx + 1;
+    light_mark_dirty_area(stl_x - range, stl_y - range, stl_x + range, stl_y + range);
+}
+
+static TbBool light_render_area_is_dirty(const struct LightRenderParams *params)
+{
+    MapSubtlCoord stl_x = coord_subtile(params->pos_x);
+    MapSubtlCoord stl_y = coord_subtile(params->pos_y);
+    MapSubtlDelta range = params->lighting_tables_idx + 1;
+    return light_area_is_dirty(stl_x - range, stl_y - range, stl_x + range, stl_y + range);
+}
+
+static void light_clear_dirty_area(void)
+{
+    for (MapSubtlCoord stl_y = 0; stl_y < MAX_SUBTILES_Y; stl_y++)
+    {
+        light_dirty_start_x[stl_y] = MAX_SUBTILES_X;
+        light_dirty_end_x[stl_y] = -1;
+    }
+}
+
+/**
+ * Forces the next light_render_area() call to recompose the whole area.
+ * Needs to be called whenever subtile_lightness is modified outside of the lights rendering.
+ */
+void light_render_area_invalidate(void)
+{
+    light_render_full_update = true;
+}
+
 struct Light *light_allocate_light(void)
 {
     for (long i = 1; i < LIGHTS_COUNT; i++)
@@ -289,6 +389,7 @@ void light_import_system_state(const struct LightSystemState *lightst)
     light_rendered_optimised_dynamic_lights = lightst->rendered_optimised_dynamic_lights;
     light_updated_stat_lights = lightst->updated_stat_lights;
     light_out_of_date_stat_lights = lightst->out_of_date_stat_lights;
+    light_render_area_invalidate();
 }
 
 TbBool lights_stats_debug_dump(void)
@@ -574,6 +675,7 @@ void light_signal_update_in_area(long sx, long sy, long ex, long ey)
     lgt++;
   }
   while ( lgt < (struct Light *)game.lish.shadow_cache );
+  light_mark_dirty_area(sx, sy, ex, ey);
   light_signal_stat_light_update_in_area(sx, sy, ex, ey);
 }
 
@@ -714,6 +816,7 @@ void light_set_light_intensity(long idx, unsigned char intensity)
 
 void clear_stat_light_map(void)
 {
+    light_render_area_invalidate();
     game.lish.global_ambient_light = 32;
     game.lish.light_enabled = 0;
     game.lish.light_rand_seed = 0;
@@ -1483,6 +1586,7 @@ void light_initialise(void)
         game.lish.lighting_tables_initialised = true;
     }
     stat_light_needs_updating = 1;
+    light_render_area_invalidate();
     light_total_dynamic_lights = 0;
     light_total_stat_lights = 0;
     light_rendered_dynamic_lights = 0;
@@ -1495,6 +1599,7 @@ static void light_stat_light_map_clear_area(MapSubtlCoord start_stl_x, MapSubtlC
 {
   MapSubtlCoord stl_x,stl_y_min_1,stl_x_min_1,stl_y;
   unsigned short *light_map;
+  light_mark_dirty_area(start_stl_x, start_stl_y, end_stl_x, end_stl_y);
   if ( end_stl_y >= start_stl_y )
   {
     for (stl_y = start_stl_y; stl_y <= end_stl_y; stl_y++)
@@ -2024,11 +2129,14 @@ static int light_render_light_static(struct Light *lgt, int radius, int intensit
 }
 
 
-static char light_render_light(struct Light* lgt)
+/**
+ * Advances the light interpolation and flicker state, and computes the values
+ * the light will be rendered with. Has to be called exactly once per rendered frame
+ * for each light in view, as it consumes the light random seed.
+ */
+static void light_render_light_prepare(struct Light* lgt, struct LightRenderParams *params)
 {
   struct LightAdd* lightadd = get_lightadd(lgt->index);
-  int remember_original_lgt_mappos_x = lgt->mappos.x.val;
-  int remember_original_lgt_mappos_y = lgt->mappos.y.val;
   if ((lightadd->interp_has_been_initialized == false) || (game.play_gameturn - lightadd->last_turn_drawn > 1)) {
     lightadd->interp_has_been_initialized = true;
     lightadd->interp_mappos.x.val = lgt->mappos.x.val;
@@ -2040,8 +2148,6 @@ static char light_render_light(struct Light* lgt)
     lightadd->interp_mappos.y.val = interpolate(lightadd->interp_mappos.y.val, lightadd->previous_mappos.y.val, lgt->mappos.y.val);
   }
   lightadd->last_turn_drawn = game.play_gameturn;
-  lgt->mappos.x.val = lightadd->interp_mappos.x.val;
-  lgt->mappos.y.val = lightadd->interp_mappos.y.val;
   TbBool is_dynamic = lgt->flags & LgtF_Dynamic;
 
   int intensity;
@@ -2081,6 +2187,24 @@ static char light_render_light(struct Light* lgt)
 
   lgt->range = lighting_tables_idx;
 
+  params->pos_x = lightadd->interp_mappos.x.val;
+  params->pos_y = lightadd->interp_mappos.y.val;
+  params->radius = radius;
+  params->render_intensity = render_intensity;
+  params->lighting_tables_idx = lighting_tables_idx;
+}
+
+static char light_render_light_draw(struct Light* lgt, const struct LightRenderParams *params)
+{
+  int remember_original_lgt_mappos_x = lgt->mappos.x.val;
+  int remember_original_lgt_mappos_y = lgt->mappos.y.val;
+  lgt->mappos.x.val = params->pos_x;
+  lgt->mappos.y.val = params->pos_y;
+  TbBool is_dynamic = lgt->flags & LgtF_Dynamic;
+  int radius = params->radius;
+  int render_intensity = params->render_intensity;
+  unsigned int lighting_tables_idx = params->lighting_tables_idx;
+
   if ( (radius > 0) && (render_intensity > 0) )
   {
     if ( is_dynamic )
@@ -2182,6 +2306,21 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
   light_out_of_date_stat_lights = 0;
   half_width_x = (endx - startx) / 2 + 1;
   half_width_y = (endy - starty) / 2 + 1;
+  light_render_frame++;
+  // Anything affecting the whole area requires all of it to be recomposed
+  if ( light_render_full_update || (light_render_last_area[0] != startx) || (light_render_last_area[1] != starty)
+    || (light_render_last_area[2] != endx) || (light_render_last_area[3] != endy)
+    || (light_render_last_ambient != game.lish.global_ambient_light) || (light_render_last_enabled != game.lish.light_enabled) )
+  {
+    light_render_full_update = false;
+    light_render_last_area[0] = startx;
+    light_render_last_area[1] = starty;
+    light_render_last_area[2] = endx;
+    light_render_last_area[3] = endy;
+    light_render_last_ambient = game.lish.global_ambient_light;
+    light_render_last_enabled = game.lish.light_enabled;
+    light_mark_dirty_area(0, 0, gameadd.map_subtiles_x, gameadd.map_subtiles_y);
+  }
 
 
   // this block applies to static lights
@@ -2202,7 +2341,10 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
           && (int)abs(half_width_y + starty - lgt->mappos.y.stl.num) < half_width_y + range )
         {
           ++light_updated_stat_lights;
-          light_render_light(lgt);
+          struct LightRenderParams params;
+          light_render_light_prepare(lgt, &params);
+          light_render_light_draw(lgt, &params);
+          light_mark_dirty_render_area(&params);
           lgt->flags &= ~(LgtF_Unkn80 | LgtF_Unkn08);
         }
       }
@@ -2210,25 +2352,7 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
   }
 
 
-  SubtlCodedCoords start_num = get_subtile_number(startx, starty);
-
-  
-  if ( starty <= endy )
-  {
-    unsigned short *stl_lightness = &game.lish.subtile_lightness[start_num];
-    unsigned short *stat_light_map = &game.lish.stat_light_map[start_num];
-
-    MapSubtlDelta y = endy - starty + 1;
-    do
-    {
-      memcpy(stl_lightness, stat_light_map, 2 * (endx - startx));
-      stl_lightness  += (gameadd.map_subtiles_x + 1);
-      stat_light_map += (gameadd.map_subtiles_x + 1);
-      --y;
-    }
-    while ( y );
-  }
-
+  // this block applies to dynamic lights
   if ( game.lish.light_enabled )
   {
     for ( lgt = &game.lish.lights[game.thing_lists[TngList_DynamLights].index]; lgt > game.lish.lights; lgt = &game.lish.lights[lgt->next_in_list] )
@@ -2297,10 +2421,63 @@ static void light_render_area(MapSubtlCoord startx, MapSubtlCoord starty, MapSub
         {
           lgt->flags |= LgtF_Unkn08;
         }
-        light_render_light(lgt);
+        // Lights which look exactly as in previous frame only need to be redrawn over recomposed subtiles
+        struct LightRenderState *lrst = &light_render_state[lgt->index];
+        struct LightRenderParams params;
+        light_render_light_prepare(lgt, &params);
+        TbBool changed = ((lgt->flags & (LgtF_NeverCached | LgtF_Unkn08)) != 0)
+            || (lrst->frame + 1 != light_render_frame) || (lrst->flags != lgt->flags)
+            || (lrst->shadow_index != lgt->shadow_index) || (lrst->pos_z != lgt->mappos.z.val)
+            || (lrst->params.pos_x != params.pos_x) || (lrst->params.pos_y != params.pos_y)
+            || (lrst->params.radius != params.radius) || (lrst->params.render_intensity != params.render_intensity)
+            || (lrst->params.lighting_tables_idx != params.lighting_tables_idx);
+        if (changed)
+        {
+          if (lrst->frame + 1 == light_render_frame)
+            light_mark_dirty_render_area(&lrst->params);
+          light_mark_dirty_render_area(&params);
+        }
+        lrst->frame = light_render_frame;
+        lrst->changed = changed;
+        lrst->flags = lgt->flags;
+        lrst->shadow_index = lgt->shadow_index;
+        lrst->pos_z = lgt->mappos.z.val;
+        lrst->params = params;
       }
     }
   }
+  // Lights which were drawn in previous frame but are gone now leave their area to be recomposed
+  for (long i = 1; i < LIGHTS_COUNT; i++)
+  {
+    struct LightRenderState *lrst = &light_render_state[i];
+    if (lrst->frame + 1 == light_render_frame)
+      light_mark_dirty_render_area(&lrst->params);
+  }
+
+  // Restore static lighting on dirty subtiles within the area; x range is exclusive
+  for (MapSubtlCoord stl_y = starty; stl_y <= endy; stl_y++)
+  {
+    MapSubtlCoord stl_sx = max(startx, light_dirty_start_x[stl_y]);
+    MapSubtlCoord stl_ex = min(endx, light_dirty_end_x[stl_y] + 1);
+    if (stl_sx < stl_ex)
+    {
+      SubtlCodedCoords stl_num = get_subtile_number(stl_sx, stl_y);
+      memcpy(&game.lish.subtile_lightness[stl_num], &game.lish.stat_light_map[stl_num], sizeof(unsigned short) * (stl_ex - stl_sx));
+    }
+  }
+
+  if ( game.lish.light_enabled )
+  {
+    for ( lgt = &game.lish.lights[game.thing_lists[TngList_DynamLights].index]; lgt > game.lish.lights; lgt = &game.lish.lights[lgt->next_in_list] )
+    {
+      struct LightRenderState *lrst = &light_render_state[lgt->index];
+      if (lrst->frame != light_render_frame)
+        continue;
+      if (lrst->changed || light_render_area_is_dirty(&lrst->params))
+        light_render_light_draw(lgt, &lrst->params);
+    }
+  }
+  light_clear_dirty_area();
 }
 
 void update_light_render_area(void)
@@ -2352,7 +2529,9 @@ void update_light_render_area(void)
     if (endx < startx) endx = startx;
     if (endx > gameadd.map_subtiles_x) endx = gameadd.map_subtiles_x;
     // Set the area
+    profiler_zone_start(Zone_LightRenderArea);
     light_render_area(startx, starty, endx, endy);
+    profiler_zone_end(Zone_LightRenderArea);
 }
 
 void light_set_light_minimum_size_to_cache(long lgt_id, long min_radius, long min_intensity)
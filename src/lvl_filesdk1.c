@@ -32,6 +32,7 @@
 #include "config_campaigns.h"
 #include "config_terrain.h"
 #include "light_data.h"
+#include "map_blocks.h"
 #include "map_ceiling.h"
 #include "map_utils.h"
 #include "thing_factory.h"
@@ -711,6 +712,7 @@ TbBool load_column_file(LevelNumber lv_num)
         i += sizeof(struct Column);
     }
     LbMemoryFree(buf);
+    rebuild_column_index();
     return true;
 }
 
@@ -744,11 +746,13 @@ TbBool load_map_data_file(LevelNumber lv_num)
             mapblk = get_map_block_at(x,y);
             unsigned short* wptr = &game.lish.subtile_lightness[get_subtile_number(x, y)];
             *wptr = 32;
-            mapblk->mapwho = 0;
+            set_mapwho_thing_index(mapblk, 0);
             mapblk->data &= ~0x0F000000; //filled subtiles
             mapblk->revealed = 0;
         }
     }
+    invalidate_map_solidity_cache();
+    light_render_area_invalidate();
     return true;
 }
 
@@ -768,10 +772,10 @@ static TbBool load_thing_file(LevelNumber lv_num)
         total = (fsize-2)/sizeof(struct LegacyInitThing);
         WARNMSG("Bad amount of things in TNG file; corrected to %d.",(int)total);
     }
-    if (total > THINGS_COUNT-2)
+    if (total > THINGS_COUNT_MAX-2)
     {
-        WARNMSG("Only %d things supported, TNG file has %d.",(int)(THINGS_COUNT-2),(int)total);
-        total = THINGS_COUNT-2;
+        WARNMSG("Only %d things supported, TNG file has %d.",(int)(THINGS_COUNT_MAX-2),(int)total);
+        total = THINGS_COUNT_MAX-2;
     }
     // Create things
     for (long k = 0; k < total; k++)
@@ -882,7 +886,7 @@ static TbBool load_kfx_toml_file(LevelNumber lv_num, const char *ext, const char
 static TbBool load_tngfx_file(LevelNumber lv_num)
 {
     return load_kfx_toml_file(lv_num, "tngfx", "TNGFX",
-                              "thing", "ThingsCount", "thing%d", THINGS_COUNT - 2,
+                              "thing", "ThingsCount", "thing%d", THINGS_COUNT_MAX - 2,
                               &thing_create_thing_adv);
 }
 
@@ -1359,6 +1363,7 @@ short load_map_flag_file(unsigned long lv_num)
         }
     }
     LbMemoryFree(buf);
+    map_solidity_changed();
     return true;
 }
 
@@ -519,6 +519,7 @@ void slap_creature(struct PlayerInfo *player, struct Thing *thing)
     cctrl = creature_control_get_from_thing(thing);
 
     anger_apply_anger_to_creature(thing, crstat->annoy_slapped, AngR_Other, 1);
+    creature_force_decisions_check(thing);
     if (crstat->slaps_to_kill > 0)
     {
       i = compute_creature_max_health(crstat->health,cctrl->explevel) / crstat->slaps_to_kill;
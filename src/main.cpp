@@ -50,6 +50,7 @@
 #include "vidmode.h"
 #include "kjm_input.h"
 #include "packets.h"
+#include "net_sync.h"
 #include "config.h"
 #include "config_strings.h"
 #include "config_campaigns.h"
@@ -65,6 +66,7 @@
 #include "player_utils.h"
 #include "player_states.h"
 #include "player_computer.h"
+#include "player_complookup.h"
 #include "game_heap.h"
 #include "game_saves.h"
 #include "engine_render.h"
@@ -80,6 +82,7 @@
 #include "thing_creature.h"
 #include "thing_objects.h"
 #include "thing_effects.h"
+#include "thing_particles.h"
 #include "thing_doors.h"
 #include "thing_traps.h"
 #include "thing_navigate.h"
@@ -308,7 +311,7 @@ void process_keeper_spell_effect(struct Thing *thing)
         pos.x.val = thing->mappos.x.val + (delta_x >> 8);
         pos.y.val = thing->mappos.y.val - (delta_y >> 8);
         pos.z.val = thing->mappos.z.val;
-        create_effect_element(&pos, TngEffElm_Heal, thing->owner); // Heal
+        create_cosmetic_effect_element(&pos, TngEffElm_Heal, thing->owner); // Heal
     }
 }
 
@@ -581,6 +584,7 @@ long apply_wallhug_force_to_boulder(struct Thing *thing)
         new_angle = 0;
       }
       thing->move_angle_xy = new_angle;
+      mark_thing_sync_hash_dirty(thing);
     }
   }
   angle = thing->move_angle_xy;
@@ -1589,6 +1593,13 @@ void reinit_level_after_load(void)
     player->lens_palette = 0;
     init_lookups();
     init_navigation();
+    rebuild_column_index();
+    invalidate_things_sync_hash();
+    rebuild_mapwho_bits();
+    rebuild_creature_grid();
+    rebuild_creature_list_counters();
+    rebuild_gold_veins();
+    clear_effect_particles();
     reinit_packets_after_load();
     game.flags_font |= start_params.flags_font;
     parchment_loaded = 0;
@@ -1663,14 +1674,16 @@ void clear_things_and_persons_data(void)
 {
     struct Thing *thing;
     long i;
+    reset_things_pages();
     for (i=0; i < THINGS_COUNT; i++)
     {
-        thing = &game.things_data[i];
+        thing = &get_things_page(i / THINGS_PAGE_SIZE)->things[i % THINGS_PAGE_SIZE];
         memset(thing, 0, sizeof(struct Thing));
         thing->owner = PLAYERS_COUNT;
         thing->mappos.x.val = subtile_coord_center(gameadd.map_subtiles_x/2);
         thing->mappos.y.val = subtile_coord_center(gameadd.map_subtiles_y/2);
     }
+    invalidate_things_sync_hash();
     for (i=0; i < CREATURES_COUNT; i++)
     {
       memset(&game.cctrl_data[i], 0, sizeof(struct CreatureControl));
@@ -1689,6 +1702,7 @@ void clear_computer(void)
     {
         LbMemorySet(&game.gold_lookup[i], 0, sizeof(struct GoldLookup));
     }
+    clear_gold_veins();
     for (i=0; i < PLAYERS_COUNT; i++)
     {
         LbMemorySet(&game.computer[i], 0, sizeof(struct Computer2));
@@ -1749,10 +1763,8 @@ void delete_all_thing_structures(void)
           delete_thing_structure(thing, 1);
       }
     }
-    for (i=0; i < THINGS_COUNT-1; i++) {
-      game.free_things[i] = i+1;
-    }
-    game.free_things_start_index = 0;
+    reset_things_pages();
+    clear_effect_particles();
 }
 
 void delete_all_structures(void)
@@ -2166,11 +2178,7 @@ void clear_lookups(void)
 {
     long i;
     SYNCDBG(8,"Starting");
-    for (i=0; i < THINGS_COUNT; i++)
-    {
-      game.things.lookup[i] = NULL;
-    }
-    game.things.end = NULL;
+    reset_things_pages();
 
     memset(&game.persons, 0, sizeof(struct Persons));
 
@@ -2313,7 +2321,7 @@ void blast_slab(MapSlabCoord slb_x, MapSlabCoord slb_y, PlayerNumber plyr_idx)
       pos.x.val = subtile_coord_center(slab_subtile_center(slb_x));
       pos.y.val = subtile_coord_center(slab_subtile_center(slb_y));
       pos.z.val = get_floor_height_at(&pos);
-      create_effect_element(&pos, TngEffElm_RedFlameBig, plyr_idx);
+      create_cosmetic_effect_element(&pos, TngEffElm_RedFlameBig, plyr_idx);
     }
 }
 
@@ -2778,17 +2786,31 @@ void update(void)
         update_creature_pool_state();
         if ((game.play_gameturn & 0x01) != 0)
             update_animating_texture_maps();
+        profiler_zone_start(Zone_UpdateThings);
         update_things();
+        profiler_zone_end(Zone_UpdateThings);
+        profiler_zone_start(Zone_ProcessRooms);
         process_rooms();
+        profiler_zone_end(Zone_ProcessRooms);
+        profiler_zone_start(Zone_ProcessDungeons);
         process_dungeons();
+        profiler_zone_end(Zone_ProcessDungeons);
         update_research();
         update_manufacturing();
         event_process_events();
         update_all_events();
+        profiler_zone_start(Zone_LevelScript);
         process_level_script();
+        profiler_zone_end(Zone_LevelScript);
         if ((game.numfield_D & GNFldD_Unkn04) != 0)
+        {
+            profiler_zone_start(Zone_ComputerPlayers);
             process_computer_players2();
+            profiler_zone_end(Zone_ComputerPlayers);
+        }
+        profiler_zone_start(Zone_ProcessPlayers);
         process_players();
+        profiler_zone_end(Zone_ProcessPlayers);
         process_action_points();
         player = get_my_player();
         if (player->view_mode == PVM_CreatureView)
@@ -3414,6 +3436,7 @@ void gameplay_loop_logic()
     LbWindowsControl();
     input_eastegg();
     input();
+    update_pending_save_game();
     update();
     frametime_end_measurement(Frametime_Logic);
 }
@@ -3468,9 +3491,44 @@ void gameplay_loop_timestep()
     if (game.turns_packetoff == game.play_gameturn) {
         exit_keeper = 1;
     }
+    if ((start_params.exit_at_turn != 0) && (start_params.exit_at_turn == game.play_gameturn)) {
+        exit_keeper = 1;
+    }
     frametime_end_measurement(Frametime_Sleep);
 }
 
+/**
+ * Headless variant of the gameplay loop, used for benchmarking.
+ * Processes game logic only, as fast as possible - there is no drawing and no waiting
+ * for next turn. Ends when the packet file has no more turns, or at requested turn.
+ */
+static void keeper_benchmark_loop(void)
+{
+    GameTurn start_turn = game.play_gameturn;
+    SYNCMSG("Benchmark started at turn %lu",(unsigned long)start_turn);
+    benchmark_begin();
+    while ((!quit_game) && (!exit_keeper))
+    {
+        if ((game.packet_load_enable) && (game.pckt_gameturn >= game.turns_stored)) {
+            SYNCMSG("Benchmark reached end of packet file");
+            break;
+        }
+        // Make every loop iteration process exactly one game turn
+        gameadd.delta_time = 1;
+        gameadd.process_turn_time = 1;
+        gameplay_loop_logic();
+        profiler_frame_end();
+        if (game.turns_packetoff == game.play_gameturn) {
+            exit_keeper = 1;
+        }
+        if ((start_params.exit_at_turn != 0) && (start_params.exit_at_turn <= game.play_gameturn)) {
+            exit_keeper = 1;
+        }
+    }
+    benchmark_finish(game.play_gameturn - start_turn);
+    benchmark_report();
+}
+
 void keeper_gameplay_loop(void)
 {
     struct PlayerInfo *player;
@@ -3490,6 +3548,12 @@ void keeper_gameplay_loop(void)
     KeeperSpeechClearEvents();
     LbErrorParachuteUpdate(); // For some reasone parachute keeps changing; Remove when won't be needed anymore
     initial_time_point();
+    if (start_params.benchmark)
+    {
+        keeper_benchmark_loop();
+        SYNCDBG(0,"Benchmark loop finished after %lu turns",(unsigned long)game.play_gameturn);
+        return;
+    }
     //the main gameplay loop starts
     while ((!quit_game) && (!exit_keeper))
     {
@@ -3889,6 +3953,7 @@ short reset_game(void)
     LbScreenReset();
     LbDataFreeAll(game_load_files);
     free_gui_strings_data();
+    free_conf_lookup_indexes();
     FreeAudio();
     return LbMemoryReset();
 }
@@ -4007,6 +4072,11 @@ short process_command_line(unsigned short argc, char *argv[])
          snprintf(start_params.packet_fname, sizeof(start_params.packet_fname), "%s", pr2str);
          narg++;
       } else
+      if (strcasecmp(parstr,"packetseek") == 0)
+      {
+         start_params.packet_seek_turn = atol(pr2str);
+         narg++;
+      } else
       if (strcasecmp(parstr,"packetsave") == 0)
       {
          if (start_params.packet_load_enable)
@@ -4036,6 +4106,15 @@ short process_command_line(unsigned short argc, char *argv[])
       {
 	      start_params.debug_flags |= DFlg_CreatrPaths;
       } else
+      if (strcasecmp(parstr, "dbgsynchash") == 0)
+      {
+          start_params.debug_flags |= DFlg_SyncHash;
+      } else
+      if (strcasecmp(parstr, "binlog") == 0)
+      {
+          if (LbErrorLogSetBinaryFormat(true) != 1)
+              WARNMSG("Log file already created, cannot switch it to binary format");
+      } else
       if (strcasecmp(parstr, "compuchat") == 0)
       {
           if (strcasecmp(pr2str,"scarce") == 0) {
@@ -4084,14 +4163,34 @@ short process_command_line(unsigned short argc, char *argv[])
           }
           narg++;
       }
-#ifdef AUTOTESTING
+      else if (strcasecmp(parstr, "benchmark") == 0)
+      {
+          start_params.benchmark = true;
+          SoundDisabled = 1;
+      }
+      else if (strcasecmp(parstr, "trace") == 0)
+      {
+          if (pr2str[0] == '\0')
+          {
+              WARNMSG("The -trace parameter requires a file name.");
+              bad_param=narg;
+          } else
+          {
+              profiler_trace_start(pr2str);
+              narg++;
+          }
+      }
       else if (strcasecmp(parstr, "exit_at_turn") == 0)
       {
+         start_params.exit_at_turn = atol(pr2str);
+#ifdef AUTOTESTING
          set_flag_byte(&start_params.autotest_flags, ATF_ExitOnTurn, true);
-         start_params.autotest_exit_turn = atol(pr2str);
+         start_params.autotest_exit_turn = start_params.exit_at_turn;
+#endif
          narg++;
-      } else
-      if (strcasecmp(parstr, "fixed_seed") == 0)
+      }
+#ifdef AUTOTESTING
+      else if (strcasecmp(parstr, "fixed_seed") == 0)
       {
          set_flag_byte(&start_params.autotest_flags, ATF_FixedSeed, true);
       } else
@@ -4143,6 +4242,16 @@ short process_command_line(unsigned short argc, char *argv[])
           AssignCpuKeepers = 1;
       }
   }
+  if (start_params.benchmark)
+  {
+      if (!start_params.packet_load_enable)
+      {
+          WARNMSG("Benchmark mode requires a packet file to be given with -packetload.");
+          bad_param=narg;
+      }
+      // Benchmark plays one level only, then quits
+      set_flag_byte(&start_params.operation_flags,GOF_SingleLevel,true);
+  }
   start_params.selected_level_number = level_num;
   my_player_number = default_loc_player;
   return (bad_param==0);
@@ -4165,6 +4274,8 @@ int LbBullfrogMain(unsigned short argc, char *argv[])
 
     retval = true;
     retval &= (LbTimerInit() != Lb_FAIL);
+    if (start_params.benchmark)
+        LbScreenSetHeadless(true);
     retval &= (LbScreenInitialize() != Lb_FAIL);
     LbSetTitle(PROGRAM_NAME);
     LbSetIcon(1);
@@ -4222,8 +4333,11 @@ int LbBullfrogMain(unsigned short argc, char *argv[])
 #ifdef AUTO_TESTING
     ev_done();
 #endif
+    // Don't quit while a saved game is still being written
+    finish_pending_save_game();
     reset_game();
     LbScreenReset();
+    profiler_trace_stop();
     if ( !retval )
     {
         static const char *msg_text="Setting up game failed.\n";
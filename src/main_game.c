@@ -100,11 +100,9 @@ void init_lookups(void)
 {
     long i;
     SYNCDBG(8,"Starting");
-    for (i=0; i < THINGS_COUNT; i++)
-    {
-        game.things.lookup[i] = &game.things_data[i];
-    }
-    game.things.end = &game.things_data[THINGS_COUNT];
+    // Things storage pages are allocated according to the amount stored in game struct
+    if ((game.things.pages_count < 1) || !resize_things_pages(game.things.pages_count))
+        reset_things_pages();
 
     memset(&game.persons, 0, sizeof(struct Persons));
     for (i=0; i < CREATURES_COUNT; i++)
@@ -158,6 +156,7 @@ static void init_level(void)
 
     erstats_clear();
     init_dungeons();
+    rebuild_creature_list_counters();
     init_map_size(get_selected_level_number());
     clear_messages();
     // Load the actual level files
@@ -295,6 +294,8 @@ void startup_saved_packet_game(void)
     post_init_level();
     post_init_players();
     set_selected_level_number(0);
+    if (start_params.packet_seek_turn > 0)
+        seek_packet_file_to_turn(start_params.packet_seek_turn);
     if (is_key_pressed(KC_LALT, KMod_NONE))
     {
         struct PlayerInfo* player = get_my_player();
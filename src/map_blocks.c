@@ -28,6 +28,7 @@
 #include "room_data.h"
 #include "map_utils.h"
 #include "thing_effects.h"
+#include "thing_particles.h"
 #include "thing_objects.h"
 #include "thing_physics.h"
 #include "config_terrain.h"
@@ -35,6 +36,7 @@
 #include "config_creature.h"
 #include "creature_senses.h"
 #include "player_utils.h"
+#include "player_complookup.h"
 #include "ariadne_wallhug.h"
 #include "spdigger_stack.h"
 #include "frontmenu_ingame_map.h"
@@ -42,6 +44,7 @@
 #include "engine_render.h"
 #include "thing_navigate.h"
 #include "thing_physics.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -570,6 +573,7 @@ unsigned long remove_unwanted_things_from_wall_slab(MapSlabCoord slb_x, MapSlabC
     for (long n=0; n < AROUND_MAP_LENGTH; n++)
     {
         struct Map *mapblk = get_map_block_at_pos(stl_num+gameadd.around_map[n]);
+        removed_num += remove_effect_particles_in_wall(mapblk);
         unsigned long k = 0;
         long i = get_mapwho_thing_index(mapblk);
         while (i != 0)
@@ -768,10 +772,12 @@ static TbBool get_against(unsigned char agnst_plyr_idx, long agnst_slbkind, long
 void delete_column(long col_idx)
 {
     game.columns_used--;
+    column_index_unlink(col_idx);
     struct Column *col;
     col = &game.columns_data[col_idx];
     memcpy(col, &game.columns_data[0], sizeof(struct Column));
     col->use = 0;
+    column_index_link(col_idx);
 }
 
 void remove_block_from_map_element(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
@@ -1640,6 +1646,7 @@ void dump_slab_on_map(SlabKind slbkind, long slabct_num, MapSubtlCoord stl_x, Ma
                 {
                     if (thing->model != 2) {
                         thing->mappos.z.val = subtile_coord(floor_height,0);
+                        mark_thing_sync_hash_dirty(thing);
                     }
                 }
                 // Per thing code end
@@ -1659,6 +1666,7 @@ void dump_slab_on_map(SlabKind slbkind, long slabct_num, MapSubtlCoord stl_x, Ma
 
     slb = get_slabmap_block(slb_x, slb_y);
     slb->kind = slbkind;
+    update_gold_veins_for_slab(slb_x, slb_y);
     pannel_map_update(stl_xa, stl_ya, STL_PER_SLB, STL_PER_SLB);
     if ((slbkind == SlbT_SLAB50) || (slbkind == SlbT_GUARDPOST) || (slbkind == SlbT_BRIDGE) || (slbkind == SlbT_GEMS) || (slbkind == SlbT_PURPLE))
     {
@@ -1846,6 +1854,7 @@ void place_slab_type_on_map_f(SlabKind nslab, MapSubtlCoord stl_x, MapSubtlCoord
                   slb->kind = SlbT_EARTH;
               else
                   slb->kind = SlbT_TORCHDIRT;
+              update_gold_veins_for_slab(spos_x, spos_y);
           }
       }
     } else
@@ -1860,6 +1869,7 @@ void place_slab_type_on_map_f(SlabKind nslab, MapSubtlCoord stl_x, MapSubtlCoord
           if (!slab_kind_is_animated(slb->kind))
           {
               slb->kind = alter_rock_style(slb->kind, spos_x, spos_y, owner);
+              update_gold_veins_for_slab(spos_x, spos_y);
           }
       }
     }
@@ -2006,6 +2016,105 @@ void update_floor_and_ceiling_heights_at(MapSubtlCoord stl_x, MapSubtlCoord stl_
     }
 }
 
+/**
+ * Packed solidity of map subtiles, derived from map blocks and their columns.
+ * Each entry keeps a mask of open heights in low 16 bits, and the column index and filled
+ * subtiles of the map block it was computed from in higher bits; so a change to map block data
+ * makes the entry stale by itself, and only changes to columns content require clearing the cache.
+ */
+static uint32_t map_solidity_cache[MAX_SUBTILES_X*MAX_SUBTILES_Y];
+static TbBool map_solidity_cache_valid = false;
+/** Incremented on every change which may affect solidity checks; allows caching their results. */
+static unsigned long map_solidity_generation = 1;
+/** If cleared, solidity is computed from map blocks on every check, and results derived from it are not cached. */
+static TbBool map_solidity_caching = true;
+
+#define MAP_SOLIDITY_ENTRY_VALID 0x80000000u
+#define MAP_SOLIDITY_KEY_MASK    0x0F0007FFu
+
+static unsigned long map_solidity_key(const struct Map *mapblk)
+{
+    unsigned long key = (mapblk->data & MAP_SOLIDITY_KEY_MASK);
+    // Pack column index (11 bits) and filled subtiles (4 bits) into 15 bits
+    return (key & 0x7FF) | ((key >> 24) << 11);
+}
+
+/**
+ * Marks the solidity cache as outdated. Needs to be called when content of columns changes.
+ */
+void invalidate_map_solidity_cache(void)
+{
+    map_solidity_cache_valid = false;
+    map_solidity_generation++;
+}
+
+/**
+ * Notes a change in map blocks which may affect solidity checks, without clearing the cache.
+ */
+void map_solidity_changed(void)
+{
+    map_solidity_generation++;
+}
+
+/**
+ * Returns a value which changes every time the solidity of map could have changed.
+ */
+unsigned long get_map_solidity_generation(void)
+{
+    return map_solidity_generation;
+}
+
+/**
+ * Switches caching of map solidity, and of results derived from it, on or off.
+ * Switching it off allows comparing cached results with the computed ones.
+ * Changes of map are still tracked while it's off, so cached data stays valid.
+ */
+void set_map_solidity_caching(TbBool enabled)
+{
+    map_solidity_caching = enabled;
+}
+
+TbBool map_solidity_caching_enabled(void)
+{
+    return map_solidity_caching;
+}
+
+/**
+ * Returns mask of heights at which given subtile is not solid; bit N is set if point at height N is open.
+ */
+static unsigned short get_map_open_heights_mask(MapSubtlCoord stl_x, MapSubtlCoord stl_y, const struct Map *mapblk)
+{
+    SubtlCodedCoords stl_num = get_subtile_number(stl_x, stl_y);
+    if (!map_solidity_cache_valid)
+    {
+        LbMemorySet(map_solidity_cache, 0, sizeof(map_solidity_cache));
+        map_solidity_cache_valid = true;
+    }
+    unsigned long key = map_solidity_key(mapblk);
+    uint32_t entry = map_solidity_cache[stl_num];
+    if ((entry & MAP_SOLIDITY_ENTRY_VALID) && (((entry >> 16) & 0x7FFF) == key)) {
+        return (entry & 0xFFFF);
+    }
+    MapSubtlCoord floor_height;
+    MapSubtlCoord ceiling_height;
+    if (get_map_ceiling_filled_subtiles(mapblk) > 0)
+    {
+        floor_height = 0;
+        ceiling_height = 15;
+        update_floor_and_ceiling_heights_at(stl_x, stl_y, &floor_height, &ceiling_height);
+    } else
+    {
+        floor_height = get_map_floor_filled_subtiles(mapblk);
+        ceiling_height = get_mapblk_filled_subtiles(mapblk);
+    }
+    unsigned short mask = 0;
+    if (ceiling_height > floor_height) {
+        mask = ((1u << ceiling_height) - 1) & ~((1u << floor_height) - 1);
+    }
+    map_solidity_cache[stl_num] = MAP_SOLIDITY_ENTRY_VALID | (key << 16) | mask;
+    return mask;
+}
+
 TbBool point_in_map_is_solid(const struct Coord3d *pos)
 {
     MapSubtlCoord floor_height;
@@ -2014,6 +2123,15 @@ TbBool point_in_map_is_solid(const struct Coord3d *pos)
     check_h = pos->z.stl.num;
     struct Map *mapblk;
     mapblk = get_map_block_at(pos->x.stl.num, pos->y.stl.num);
+    if (!map_block_invalid(mapblk) && map_solidity_caching)
+    {
+        // Floor and ceiling heights never exceed 15, so any higher point is solid
+        if ((check_h >= 16) || ((get_map_open_heights_mask(pos->x.stl.num, pos->y.stl.num, mapblk) & (1u << check_h)) == 0)) {
+            SYNCDBG(17, "Solid at (%d,%d,%d)",(int)pos->x.stl.num,(int)pos->y.stl.num,(int)pos->z.stl.num);
+            return true;
+        }
+        return false;
+    }
     if (get_map_ceiling_filled_subtiles(mapblk) > 0)
     {
         floor_height = 0;
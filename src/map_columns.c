@@ -22,6 +22,7 @@
 
 #include "bflib_memory.h"
 #include "config_terrain.h"
+#include "map_blocks.h"
 #include "slab_data.h"
 #include "game_legacy.h"
 #include "post_inc.h"
@@ -30,6 +31,14 @@
 extern "C" {
 #endif
 /******************************************************************************/
+#define COLUMN_HASH_SIZE     4096
+/******************************************************************************/
+/** Heads of the column content hash chains; chains are sorted by column index, and include free slots. */
+static unsigned short column_hash_head[COLUMN_HASH_SIZE];
+static unsigned short column_hash_next[COLUMNS_COUNT];
+/** Bit set for every free column slot, so that the lowest one can be found quickly. */
+static unsigned long column_free_bits[COLUMNS_COUNT/32];
+/******************************************************************************/
 struct Column *get_column(long idx)
 {
   if ((idx < 1) || (idx >= COLUMNS_COUNT))
@@ -328,15 +337,113 @@ static TbBool column_is_equivalent(struct Column * const src, struct Column *dst
     return 0 == memcmp(src->cubes, dst->cubes, sizeof(src->cubes));
 }
 
+static TbBool column_slot_is_free(const struct Column *col)
+{
+    return (col->use == 0) && ((col->bitfields & CLF_ACTIVE) == 0);
+}
+
+/**
+ * Computes hash of the column content, from the same fields which column_is_equivalent() compares.
+ */
+static unsigned long column_hash(const struct Column *col)
+{
+    unsigned long hash = 2166136261UL;
+    hash = (hash ^ col->baseblock) * 16777619UL;
+    hash = (hash ^ col->solidmask) * 16777619UL;
+    hash = (hash ^ col->orient) * 16777619UL;
+    for (int i = 0; i < COLUMN_STACK_HEIGHT; i++)
+        hash = (hash ^ col->cubes[i]) * 16777619UL;
+    return (hash ^ (hash >> 16)) & (COLUMN_HASH_SIZE-1);
+}
+
+/**
+ * Adds column to the content index, and updates its slot in free slots set.
+ * Needs to be called after the column content was set.
+ */
+void column_index_link(long col_idx)
+{
+    if ((col_idx < 1) || (col_idx >= COLUMNS_COUNT))
+        return;
+    unsigned short *link = &column_hash_head[column_hash(&game.columns_data[col_idx])];
+    while ((*link != 0) && (*link < col_idx))
+        link = &column_hash_next[*link];
+    column_hash_next[col_idx] = *link;
+    *link = col_idx;
+    if (column_slot_is_free(&game.columns_data[col_idx]))
+        column_free_bits[col_idx / 32] |= (1UL << (col_idx % 32));
+    else
+        column_free_bits[col_idx / 32] &= ~(1UL << (col_idx % 32));
+    invalidate_map_solidity_cache();
+}
+
+/**
+ * Removes column from the content index.
+ * Needs to be called before the column content is changed.
+ */
+void column_index_unlink(long col_idx)
+{
+    if ((col_idx < 1) || (col_idx >= COLUMNS_COUNT))
+        return;
+    unsigned short *link = &column_hash_head[column_hash(&game.columns_data[col_idx])];
+    while ((*link != 0) && (*link != col_idx))
+        link = &column_hash_next[*link];
+    if (*link == col_idx)
+        *link = column_hash_next[col_idx];
+    column_hash_next[col_idx] = 0;
+    invalidate_map_solidity_cache();
+}
+
+/**
+ * Rebuilds the column content index and free slots set from columns data.
+ * Needs to be called after columns data was modified without use of create_column() and delete_column().
+ */
+void rebuild_column_index(void)
+{
+    LbMemorySet(column_hash_head, 0, sizeof(column_hash_head));
+    LbMemorySet(column_hash_next, 0, sizeof(column_hash_next));
+    LbMemorySet(column_free_bits, 0, sizeof(column_free_bits));
+    // Adding from the end keeps the insertion at chain heads
+    for (long i = COLUMNS_COUNT-1; i > 0; i--)
+    {
+        column_index_link(i);
+    }
+}
+
+/**
+ * Gives lowest free column slot. A slot may stop being free without the set being updated,
+ * ie. when a free column found by find_column() gets used; such slots are skipped here.
+ */
+static long find_free_column_slot(void)
+{
+    for (long n = 0; n < COLUMNS_COUNT/32; n++)
+    {
+        while (column_free_bits[n] != 0)
+        {
+            long i = 0;
+            while ((column_free_bits[n] & (1UL << i)) == 0)
+                i++;
+            long col_idx = n * 32 + i;
+            if (column_slot_is_free(&game.columns_data[col_idx]))
+                return col_idx;
+            column_free_bits[n] &= ~(1UL << i);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds a column which has the same content as given one; free slots are matched too.
+ * @return Index of the lowest matching column, or 0 if there's none.
+ */
 long find_column(struct Column *srccol)
 {
-    int i;
-    for (i=1; i < COLUMNS_COUNT; i++) {
-        struct Column *col;
-        col = get_column(i);
-        if (column_is_equivalent(srccol, col)) {
-          return i;
+    long i = column_hash_head[column_hash(srccol)];
+    while (i != 0)
+    {
+        if (column_is_equivalent(srccol, &game.columns_data[i])) {
+            return i;
         }
+        i = column_hash_next[i];
     }
     return 0;
 }
@@ -349,18 +456,14 @@ long create_column(struct Column *col)
     unsigned char top_of_floor;
 
     // Find an empty column
-    result = 1;
-    dst = &game.columns_data[1];
-    while (dst->use || dst->bitfields & CLF_ACTIVE )
+    result = find_free_column_slot();
+    if (result <= 0)
     {
-        ++result;
-        ++dst;
-        if ( result >= COLUMNS_COUNT )
-        {
-            ERRORLOG("Could not create column: None free");
-            return 0;
-        }
+        ERRORLOG("Could not create column: None free");
+        return 0;
     }
+    dst = &game.columns_data[result];
+    column_index_unlink(result);
     // Copy data
     memcpy(dst, col, sizeof(struct Column));
     // Create cubemask
@@ -409,6 +512,7 @@ long create_column(struct Column *col)
             }
         }
     }
+    column_index_link(result);
     return result;
 }
 
@@ -428,6 +532,7 @@ void clear_columns(void)
   {
     game.col_static_entries[i] = 0;
   }
+  rebuild_column_index();
 }
 
 void init_columns(void)
@@ -486,6 +591,7 @@ void init_columns(void)
             }
         }
     }
+    rebuild_column_index();
 }
 
 void init_whole_blocks(void)
@@ -70,6 +70,9 @@ void clear_columns(void);
 void init_columns(void);
 long find_column(struct Column *col);
 long create_column(struct Column *col);
+void column_index_link(long col_idx);
+void column_index_unlink(long col_idx);
+void rebuild_column_index(void);
 unsigned short find_column_height(struct Column *col);
 void init_whole_blocks(void);
 void init_top_texture_to_cube_table(void);
@@ -29,6 +29,12 @@
 #include "map_blocks.h"
 #include "map_utils.h"
 #include "room_util.h"
+#include "thing_list.h"
+#include "light_data.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -43,6 +49,10 @@ MapSubtlCoord map_subtiles_z = 8;
 
 unsigned char *IanMap = NULL;
 long nav_map_initialised = 0;
+
+#define MAPWHO_BITS_COUNT (MAX_SUBTILES_X*MAX_SUBTILES_Y)
+/** One bit for each map block, set if there are things on its mapwho list. */
+static uint32_t mapwho_bits[(MAPWHO_BITS_COUNT + 31) / 32];
 /******************************************************************************/
 /**
  * Returns if the subtile coords are in range of subtiles which have slab entry.
@@ -129,6 +139,93 @@ ThingIndex get_mapwho_thing_index(const struct Map *mapblk)
 void set_mapwho_thing_index(struct Map *mapblk, ThingIndex thing_idx)
 {
   mapblk->mapwho = thing_idx;
+  if ((mapblk < &game.map[0]) || (mapblk >= &game.map[MAPWHO_BITS_COUNT]))
+      return;
+  SubtlCodedCoords stl_num = mapblk - &game.map[0];
+  if (thing_idx != 0)
+      mapwho_bits[stl_num / 32] |= (1u << (stl_num % 32));
+  else
+      mapwho_bits[stl_num / 32] &= ~(1u << (stl_num % 32));
+}
+
+static long bitScanForward(uint32_t source)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    uint8_t success = _BitScanForward(&i, source);
+    return success != 0 ? i : -1;
+#elif defined(__GNUC__)
+    return source == 0 ? -1 : __builtin_ctz(source);
+#else
+    for (int32_t i = 0; i < 32; i++)
+    {
+        if ((source & (1u << i)) != 0)
+            return i;
+    }
+    return -1;
+#endif
+}
+
+/**
+ * Returns if the map block at given subtile has any things in mapwho.
+ */
+TbBool subtile_has_mapwho_things(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
+{
+    if ((stl_x < 0) || (stl_x > gameadd.map_subtiles_x))
+        return false;
+    if ((stl_y < 0) || (stl_y > gameadd.map_subtiles_y))
+        return false;
+    SubtlCodedCoords stl_num = get_subtile_number(stl_x, stl_y);
+    return ((mapwho_bits[stl_num / 32] & (1u << (stl_num % 32))) != 0);
+}
+
+/**
+ * Finds first subtile in a row which has things in mapwho.
+ * Allows area sweeps to skip empty map blocks while still visiting them in the same order.
+ * @param stl_x Subtile X to start from.
+ * @param end_x Last subtile X which can be returned.
+ * @param stl_y Subtile Y of the row.
+ * @return Subtile X coord of the first occupied block, or end_x+1 if there's none.
+ */
+MapSubtlCoord find_next_mapwho_subtile_in_row(MapSubtlCoord stl_x, MapSubtlCoord end_x, MapSubtlCoord stl_y)
+{
+    MapSubtlCoord last_x = end_x;
+    if (last_x > gameadd.map_subtiles_x)
+        last_x = gameadd.map_subtiles_x;
+    if (stl_x < 0)
+        stl_x = 0;
+    if ((stl_y < 0) || (stl_y > gameadd.map_subtiles_y) || (stl_x > last_x))
+        return end_x + 1;
+    SubtlCodedCoords row_num = stl_y * (gameadd.map_subtiles_x + 1);
+    SubtlCodedCoords stl_num = row_num + stl_x;
+    SubtlCodedCoords end_num = row_num + last_x;
+    uint32_t bits = mapwho_bits[stl_num / 32] & (0xFFFFFFFFu << (stl_num % 32));
+    SubtlCodedCoords word_idx = stl_num / 32;
+    while (bits == 0)
+    {
+        word_idx++;
+        if (word_idx > end_num / 32)
+            return end_x + 1;
+        bits = mapwho_bits[word_idx];
+    }
+    stl_num = word_idx * 32 + bitScanForward(bits);
+    if (stl_num > end_num)
+        return end_x + 1;
+    return stl_num - row_num;
+}
+
+/**
+ * Re-creates the mapwho occupancy bits from map blocks.
+ * Needs to be called whenever map is restored without using mapwho functions, ie. after loading a game.
+ */
+void rebuild_mapwho_bits(void)
+{
+    LbMemorySet(mapwho_bits, 0, sizeof(mapwho_bits));
+    for (SubtlCodedCoords stl_num = 0; stl_num < MAPWHO_BITS_COUNT; stl_num++)
+    {
+        if (game.map[stl_num].mapwho != 0)
+            mapwho_bits[stl_num / 32] |= (1u << (stl_num % 32));
+    }
 }
 
 long get_mapblk_column_index(const struct Map *mapblk)
@@ -146,6 +243,7 @@ void set_mapblk_column_index(struct Map *mapblk, long column_idx)
   }
   // Clear previous and set new
   mapblk->data ^= (mapblk->data ^ ((unsigned long)column_idx)) & 0x7FF;
+  map_solidity_changed();
 }
 
 /**
@@ -189,6 +287,7 @@ void set_mapblk_filled_subtiles(struct Map *mapblk, long height)
     if (height > 15) height = 15;
     mapblk->data &= ~(0xF000000);
     mapblk->data |= (height << 24) & 0xF000000;
+    map_solidity_changed();
 }
 
 void reveal_map_subtile(MapSubtlCoord stl_x, MapSubtlCoord stl_y, PlayerNumber plyr_idx)
@@ -557,6 +656,8 @@ void clear_mapwho(void)
             mapblk->mapwho = 0;
         }
   }
+  LbMemorySet(mapwho_bits, 0, sizeof(mapwho_bits));
+  clear_creature_grid();
 }
 
 void clear_mapmap(void)
@@ -572,6 +673,8 @@ void clear_mapmap(void)
         }
     }
     clear_subtiles_lightness(&game.lish);
+    light_render_area_invalidate();
+    clear_creature_grid();
 }
 
 /**
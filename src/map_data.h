@@ -88,6 +88,9 @@ TbBool valid_dig_position(PlayerNumber plyr_idx, long stl_x, long stl_y);
 long get_ceiling_height(const struct Coord3d *pos);
 ThingIndex get_mapwho_thing_index(const struct Map *mapblk);
 void set_mapwho_thing_index(struct Map *map, ThingIndex thing_idx);
+TbBool subtile_has_mapwho_things(MapSubtlCoord stl_x, MapSubtlCoord stl_y);
+MapSubtlCoord find_next_mapwho_subtile_in_row(MapSubtlCoord stl_x, MapSubtlCoord end_x, MapSubtlCoord stl_y);
+void rebuild_mapwho_bits(void);
 long get_mapblk_column_index(const struct Map *map);
 void set_mapblk_column_index(struct Map *map, long column_idx);
 long get_mapblk_filled_subtiles(const struct Map *mapblk);
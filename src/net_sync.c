@@ -63,6 +63,18 @@ struct Boing {
 /******************************************************************************/
 /** Structure used for storing 'localised parameters' when resyncing net game. */
 struct Boing boing;
+
+/**
+ * Incrementally maintained sum of simple checksums of all synced things.
+ * Contribution of every thing is cached; things which may have changed are
+ * queued in the dirty list, and only these are recomputed when the sum is needed.
+ */
+static TbBigChecksum things_sync_hash;
+static TbBigChecksum things_sync_contrib[THINGS_COUNT_MAX];
+static ThingIndex things_sync_dirty_list[THINGS_COUNT_MAX];
+static unsigned char things_sync_dirty_flags[THINGS_COUNT_MAX];
+static long things_sync_dirty_count;
+static TbBool things_sync_hash_valid = false;
 /******************************************************************************/
 long get_resync_sender(void)
 {
@@ -75,28 +87,58 @@ long get_resync_sender(void)
   return -1;
 }
 
-TbBool send_resync_game(void)
+/**
+ * Exchanges things pages; these are outside of game structure, so are sent separately.
+ * Amount of pages is already received within game structure.
+ */
+static TbBool resync_things_pages(void)
 {
-  //TODO NET see if it is necessary to dump to file... probably superfluous
-  char* fname = prepare_file_path(FGrp_Save, "resync.dat");
-  TbFileHandle fh = LbFileOpen(fname, Lb_FILE_MODE_NEW);
-  if (fh == -1)
-  {
-    ERRORLOG("Can't open resync file.");
-    return false;
-  }
-
-  LbFileWrite(fh, &game, sizeof(game));
-  LbFileClose(fh);
+    for (long i = 0; i < game.things.pages_count; i++)
+    {
+        struct ThingsPage* page = get_things_page(i);
+        if (!LbNetwork_Resync(page->things, sizeof(page->things)))
+            return false;
+        if (!LbNetwork_Resync(page->adds, sizeof(page->adds)))
+            return false;
+        if (!LbNetwork_Resync(page->generation, sizeof(page->generation)))
+            return false;
+        if (!LbNetwork_Resync(page->next_free, sizeof(page->next_free)))
+            return false;
+    }
+    return true;
+}
 
-  NETLOG("Initiating re-synchronization of network game");
-  return LbNetwork_Resync(&game, sizeof(game));
+TbBool send_resync_game(void)
+{
+    NETLOG("Initiating re-synchronization of network game");
+    if (!LbNetwork_Resync(&game, sizeof(game)))
+        return false;
+    if (!LbNetwork_Resync(&gameadd, sizeof(gameadd)))
+        return false;
+    return resync_things_pages();
 }
 
 TbBool receive_resync_game(void)
 {
     NETLOG("Initiating re-synchronization of network game");
-    return LbNetwork_Resync(&game, sizeof(game));
+    unsigned short pages_count = game.things.pages_count;
+    if (!LbNetwork_Resync(&game, sizeof(game)))
+        return false;
+    if (!LbNetwork_Resync(&gameadd, sizeof(gameadd)))
+        return false;
+    // Make the storage size match the sender, before its pages are received;
+    // the amount stays as it was if the storage can't be resized
+    unsigned short sender_pages_count = game.things.pages_count;
+    game.things.pages_count = pages_count;
+    if (!resize_things_pages(sender_pages_count))
+    {
+        ERRORLOG("Cannot resize things storage to %d pages",(int)sender_pages_count);
+        return false;
+    }
+    if (!resync_things_pages())
+        return false;
+    invalidate_things_sync_hash();
+    return true;
 }
 
 void store_localised_game_structure(void)
@@ -322,6 +364,98 @@ TbBigChecksum get_thing_checksum(const struct Thing* thing)
     }
     return csum * thing->index;
 }
+
+static TbBigChecksum get_thing_sync_contribution(const struct Thing *thing)
+{
+    if ((thing->alloc_flags & TAlF_Exists) == 0)
+        return 0;
+    // It would be nice to completely ignore effects, but since
+    // thing indices are used in packets, lack of effect may cause desync too.
+    if ((thing->class_id == TCls_AmbientSnd) || (thing->class_id == TCls_EffectElem))
+        return 0;
+    return get_thing_simple_checksum(thing);
+}
+
+/**
+ * Recomputes contributions of all thing slots.
+ * @param report If true, logs every thing whose cached contribution was outdated.
+ */
+static void rebuild_things_sync_hash(TbBool report)
+{
+    things_sync_hash = 0;
+    for (long tng_idx = 1; tng_idx < THINGS_COUNT; tng_idx++)
+    {
+        struct Thing* thing = thing_get(tng_idx);
+        TbBigChecksum contrib = get_thing_sync_contribution(thing);
+        if (report && (things_sync_contrib[tng_idx] != contrib)) {
+            ERRORLOG("Sync hash of %s index %d was not updated on change",thing_model_name(thing),(int)tng_idx);
+        }
+        things_sync_contrib[tng_idx] = contrib;
+        things_sync_hash += contrib;
+        things_sync_dirty_flags[tng_idx] = 0;
+    }
+    things_sync_dirty_count = 0;
+    things_sync_hash_valid = true;
+}
+
+/**
+ * Queues the thing for recomputing its part of things sync hash.
+ * Should be called by code which sets synced fields of the thing - position,
+ * move angle or owner. Missed calls are reported when running with -dbgsynchash.
+ */
+void mark_thing_sync_hash_dirty(const struct Thing *thing)
+{
+    long tng_idx = thing->index;
+    if ((tng_idx <= 0) || (tng_idx >= THINGS_COUNT))
+        return;
+    if (things_sync_dirty_flags[tng_idx] != 0)
+        return;
+    things_sync_dirty_flags[tng_idx] = 1;
+    things_sync_dirty_list[things_sync_dirty_count] = tng_idx;
+    things_sync_dirty_count++;
+}
+
+/**
+ * Forces full recomputation of things sync hash on next use.
+ * To be used when the things array is replaced as a whole.
+ */
+void invalidate_things_sync_hash(void)
+{
+    things_sync_hash_valid = false;
+}
+
+/**
+ * Gives sum of simple checksums of all synced things, equal to a full sweep
+ * through things array, but at cost proportional to amount of changed things.
+ */
+TbBigChecksum get_things_sync_hash(void)
+{
+    if (!things_sync_hash_valid)
+    {
+        rebuild_things_sync_hash(false);
+    } else
+    {
+        for (long i = 0; i < things_sync_dirty_count; i++)
+        {
+            long tng_idx = things_sync_dirty_list[i];
+            struct Thing* thing = thing_get(tng_idx);
+            TbBigChecksum contrib = get_thing_sync_contribution(thing);
+            things_sync_hash += contrib - things_sync_contrib[tng_idx];
+            things_sync_contrib[tng_idx] = contrib;
+            things_sync_dirty_flags[tng_idx] = 0;
+        }
+        things_sync_dirty_count = 0;
+    }
+    if ((start_params.debug_flags & DFlg_SyncHash) != 0)
+    {
+        TbBigChecksum sum = things_sync_hash;
+        rebuild_things_sync_hash(true);
+        if (sum != things_sync_hash) {
+            ERRORLOG("Things sync hash %08lx differs from full sweep %08lx, turn %lu",(unsigned long)sum,(unsigned long)things_sync_hash,(unsigned long)game.play_gameturn);
+        }
+    }
+    return things_sync_hash;
+}
 /******************************************************************************/
 #ifdef __cplusplus
 }
@@ -30,12 +30,17 @@ extern "C" {
 /******************************************************************************/
 #pragma pack(1)
 
+struct Thing;
 
 #pragma pack()
 /******************************************************************************/
 void resync_game(void);
 CoroutineLoopState perform_checksum_verification(CoroutineLoop *con);
 
+void mark_thing_sync_hash_dirty(const struct Thing *thing);
+void invalidate_things_sync_hash(void);
+TbBigChecksum get_things_sync_hash(void);
+
 /******************************************************************************/
 #ifdef __cplusplus
 }
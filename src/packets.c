@@ -242,25 +242,6 @@ TbBigChecksum get_thing_simple_checksum(const struct Thing *tng)
          + (ulong)tng->move_angle_xy + (ulong)tng->owner;
 }
 
-  TbBigChecksum get_packet_save_checksum(void)
-  {
-      TbBigChecksum sum = 0;
-      for (long tng_idx = 0; tng_idx < THINGS_COUNT; tng_idx++)
-      {
-          struct Thing* tng = thing_get(tng_idx);
-          if ((tng->alloc_flags & TAlF_Exists) != 0)
-          {
-              // It would be nice to completely ignore effects, but since
-              // thing indices are used in packets, lack of effect may cause desync too.
-              if ((tng->class_id != TCls_AmbientSnd) && (tng->class_id != TCls_EffectElem))
-              {
-                  sum += get_thing_simple_checksum(tng);
-              }
-          }
-      }
-      return sum;
-}
-
 void process_pause_packet(long curr_pause, long new_pause)
 {
   struct PlayerInfo *player;
@@ -1260,6 +1241,7 @@ void process_players_creature_control_packet_control(long idx)
     if (angle > angle_limit)
         angle = angle_limit;
     cctng->move_angle_xy = (cctng->move_angle_xy + angle) & LbFPMath_AngleMask;
+    mark_thing_sync_hash_dirty(cctng);
     cctng->move_angle_z = (227 * k / 127) & LbFPMath_AngleMask;
     ccctrl->field_CC = 170 * angle / angle_limit;
     ccctrl->field_6C = 4 * angle / 8;
@@ -241,6 +241,7 @@ enum ChecksumKind {
 
 struct PlayerInfo;
 struct CatalogueEntry;
+struct Thing;
 
 /**
  * Stores data exchanged between players each turn and used to re-create their input.
@@ -299,6 +300,7 @@ void process_pause_packet(long a1, long a2);
 void process_quit_packet(struct PlayerInfo *player, short complete_quit);
 void process_packets(void);
 void clear_packets(void);
+TbBigChecksum get_thing_simple_checksum(const struct Thing *tng);
 TbBigChecksum compute_players_checksum(void);
 void player_packet_checksum_add(PlayerNumber plyr_idx, TbBigChecksum sum, const char *area_name);
 short checksums_different(void);
@@ -306,6 +308,7 @@ void post_init_packets(void);
 
 TbBool open_new_packet_file_for_save(void);
 void load_packets_for_turn(GameTurn nturn);
+TbBool seek_packet_file_to_turn(GameTurn nturn);
 TbBool open_packet_file_for_load(char *fname, struct CatalogueEntry *centry);
 short save_packets(void);
 void close_packet_file(void);
@@ -25,6 +25,10 @@
 #include "game_legacy.h"
 #include "game_saves.h"
 #include "gui_topmsg.h"
+#include "frontmenu_ingame_map.h"
+#include "keeperfx.hpp"
+#include "light_data.h"
+#include "net_sync.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
@@ -32,7 +36,80 @@ extern "C" {
 #endif
 /******************************************************************************/
 #define PACKET_TURN_SIZE (NET_PLAYERS_COUNT*sizeof(struct PacketEx) + sizeof(TbBigChecksum))
+/** Size of turn record in indexed packet file; packets of all players and things checksum. */
+#define PACKET_RECORD_SIZE (NET_PLAYERS_COUNT*sizeof(struct Packet) + sizeof(TbBigChecksum))
+/** Max size of run-length coded turn record; every token is two bytes followed by literals. */
+#define PACKET_RECORD_CODED_MAX (2*PACKET_RECORD_SIZE + 2)
+/** Amount of turns after which the record is stored whole, allowing seek to it. */
+#define PACKET_INDEX_INTERVAL 256
+/** Amount of turns kept in write buffer before it is written to disk. */
+#define PACKET_FLUSH_TURNS 64
+/** Amount of turns after which game state snapshot is stored; must be multiple of PACKET_INDEX_INTERVAL. */
+#define PACKET_KEYFRAME_INTERVAL 1024
+/** Keyframe in turn data starts with empty run-length token, which never begins a record, then snapshot size. */
+#define PACKET_KEYFRAME_HEADER_SIZE (2 + sizeof(unsigned long))
+#define PACKET_INDEX_MAGIC 0x58444950 //"PIDX"
+
+/** Stored at very end of indexed packet file, after turn offsets and keyframes.
+ * Files in PckDV_Indexed format have no keyframes count in it. */
+struct PacketIndexTail {
+    unsigned long keyframes_count;
+    unsigned long turns_count;
+    unsigned long interval;
+    unsigned long offsets_count;
+    unsigned long magic;
+};
+
+/** Game state snapshot stored in packet file. */
+struct PacketKeyframe {
+    unsigned long turn; // the state is from before packets of this turn were processed
+    unsigned long offset; // data offset of keyframe header
+};
+
+/** State of the currently open packet file. */
+struct PacketFileState {
+    unsigned long format; // enum PacketDataVersions
+    TbBool writing;
+    long data_start; // file position where turn data begins
+    unsigned char record[PACKET_RECORD_SIZE]; // last record written or read
+    unsigned char *buf; // write-behind buffer, or whole turn data when loading
+    unsigned long buf_len;
+    unsigned long buf_pos;
+    unsigned long buf_turns;
+    unsigned long data_written; // amount of turn data bytes already on disk
+    unsigned long turns_count;
+    unsigned long *offsets; // data offset of every PACKET_INDEX_INTERVAL-th turn
+    unsigned long offsets_count;
+    unsigned long offsets_alloc;
+    struct PacketKeyframe *keyframes;
+    unsigned long keyframes_count;
+    unsigned long keyframes_alloc;
+    GameTurn next_turn;
+};
+
+/** Game fields which describe the replay session rather than game state; kept when restoring a keyframe. */
+struct PacketPlaybackParams {
+    unsigned char packet_save_enable;
+    unsigned char packet_load_enable;
+    char packet_fname[150];
+    char packet_fopened;
+    TbFileHandle packet_save_fp;
+    unsigned int packet_file_pos;
+    struct PacketSaveHead packet_save_head;
+    unsigned long turns_stored;
+    unsigned char numfield_149F38;
+    unsigned char packet_checksum_verify;
+    unsigned long log_things_start_turn;
+    unsigned long log_things_end_turn;
+    unsigned long turns_packetoff;
+    PlayerNumber local_plyr_idx;
+    unsigned char numfield_149F47;
+    unsigned char flags_cd;
+    enum GameKinds game_kind;
+};
+
 struct Packet bad_packet;
+static struct PacketFileState pckfile;
 /******************************************************************************/
 #ifdef __cplusplus
 }
@@ -118,9 +195,198 @@ void clear_packets(void)
     }
 }
 
+static void packet_file_reset_state(void)
+{
+    LbMemoryFree(pckfile.buf);
+    LbMemoryFree(pckfile.offsets);
+    LbMemoryFree(pckfile.keyframes);
+    LbMemorySet(&pckfile, 0, sizeof(pckfile));
+}
+
+static TbBool packet_file_add_offset(unsigned long offset)
+{
+    if (pckfile.offsets_count >= pckfile.offsets_alloc)
+    {
+        unsigned long n = pckfile.offsets_alloc + 256;
+        unsigned long *offsets = (unsigned long *)LbMemoryGrow(pckfile.offsets, n * sizeof(unsigned long));
+        if (offsets == NULL)
+            return false;
+        pckfile.offsets = offsets;
+        pckfile.offsets_alloc = n;
+    }
+    pckfile.offsets[pckfile.offsets_count] = offset;
+    pckfile.offsets_count++;
+    return true;
+}
+
+static TbBool packet_file_add_keyframe(unsigned long turn, unsigned long offset)
+{
+    if (pckfile.keyframes_count >= pckfile.keyframes_alloc)
+    {
+        unsigned long n = pckfile.keyframes_alloc + 16;
+        struct PacketKeyframe *keyframes = (struct PacketKeyframe *)LbMemoryGrow(pckfile.keyframes, n * sizeof(struct PacketKeyframe));
+        if (keyframes == NULL)
+            return false;
+        pckfile.keyframes = keyframes;
+        pckfile.keyframes_alloc = n;
+    }
+    pckfile.keyframes[pckfile.keyframes_count].turn = turn;
+    pckfile.keyframes[pckfile.keyframes_count].offset = offset;
+    pckfile.keyframes_count++;
+    return true;
+}
+
+/**
+ * Returns size of keyframe at given offset of loaded turn data, or 0 if there's a record there.
+ */
+static unsigned long packet_file_keyframe_size(unsigned long pos)
+{
+    if ((pckfile.format < PckDV_Keyframes) || (pos + PACKET_KEYFRAME_HEADER_SIZE > pckfile.buf_len))
+        return 0;
+    if ((pckfile.buf[pos] != 0) || (pckfile.buf[pos+1] != 0))
+        return 0;
+    unsigned long packed_len;
+    LbMemoryCopy(&packed_len, &pckfile.buf[pos+2], sizeof(unsigned long));
+    if (packed_len > pckfile.buf_len - pos - PACKET_KEYFRAME_HEADER_SIZE)
+        return 0;
+    return PACKET_KEYFRAME_HEADER_SIZE + packed_len;
+}
+
+/**
+ * Codes turn record as runs of bytes unchanged since base record, each followed by changed bytes.
+ * @return Amount of bytes written to output buffer.
+ */
+static unsigned long packet_record_encode(const unsigned char *rec, const unsigned char *base, unsigned char *out)
+{
+    unsigned long n = 0;
+    unsigned long i = 0;
+    while (i < PACKET_RECORD_SIZE)
+    {
+        unsigned long same = 0;
+        while ((i < PACKET_RECORD_SIZE) && (same < 255) && (rec[i] == base[i])) {
+            i++;
+            same++;
+        }
+        unsigned long lit_start = i;
+        unsigned long lits = 0;
+        while ((i < PACKET_RECORD_SIZE) && (lits < 255) && (rec[i] != base[i])) {
+            i++;
+            lits++;
+        }
+        out[n++] = same;
+        out[n++] = lits;
+        LbMemoryCopy(&out[n], &rec[lit_start], lits);
+        n += lits;
+    }
+    return n;
+}
+
+/**
+ * Decodes turn record over the previous one, which is stored in the same buffer.
+ * @return Amount of bytes consumed from input buffer, or 0 on error.
+ */
+static unsigned long packet_record_decode(const unsigned char *in, unsigned long in_len, unsigned char *rec)
+{
+    unsigned long n = 0;
+    unsigned long i = 0;
+    while (i < PACKET_RECORD_SIZE)
+    {
+        if (n + 2 > in_len)
+            return 0;
+        unsigned long same = in[n++];
+        unsigned long lits = in[n++];
+        if ((i + same + lits > PACKET_RECORD_SIZE) || (n + lits > in_len))
+            return 0;
+        i += same;
+        LbMemoryCopy(&rec[i], &in[n], lits);
+        i += lits;
+        n += lits;
+    }
+    return n;
+}
+
+/**
+ * Reads turn data of indexed packet file into memory, together with its index.
+ * If the file was not closed properly and has no index, the index is rebuilt.
+ */
+static TbBool packet_file_load_indexed_data(void)
+{
+    long data_len = LbFileLengthHandle(game.packet_save_fp) - pckfile.data_start;
+    if (data_len < 0)
+        return false;
+    pckfile.buf = (unsigned char *)LbMemoryAlloc(data_len + 1);
+    if (pckfile.buf == NULL)
+        return false;
+    if ((data_len > 0) && (LbFileRead(game.packet_save_fp, pckfile.buf, data_len) != data_len))
+        return false;
+    pckfile.buf_len = data_len;
+    struct PacketIndexTail tail;
+    unsigned long tail_len = sizeof(tail);
+    if (pckfile.format == PckDV_Indexed)
+        tail_len -= sizeof(tail.keyframes_count);
+    LbMemorySet(&tail, 0, sizeof(tail));
+    if (data_len >= (long)tail_len)
+    {
+        LbMemoryCopy((unsigned char *)&tail + sizeof(tail) - tail_len, &pckfile.buf[data_len - tail_len], tail_len);
+        unsigned long index_len = tail_len + tail.offsets_count * sizeof(unsigned long) + tail.keyframes_count * sizeof(struct PacketKeyframe);
+        if ((tail.magic == PACKET_INDEX_MAGIC) && (tail.interval == PACKET_INDEX_INTERVAL) && (index_len <= (unsigned long)data_len) &&
+            (tail.offsets_count == (tail.turns_count + PACKET_INDEX_INTERVAL - 1) / PACKET_INDEX_INTERVAL))
+        {
+            pckfile.buf_len = data_len - index_len;
+            pckfile.turns_count = tail.turns_count;
+            const unsigned char *src = &pckfile.buf[pckfile.buf_len];
+            for (unsigned long i = 0; i < tail.offsets_count; i++)
+            {
+                unsigned long offset;
+                LbMemoryCopy(&offset, src, sizeof(unsigned long));
+                src += sizeof(unsigned long);
+                if ((offset >= pckfile.buf_len) || !packet_file_add_offset(offset))
+                    return false;
+            }
+            for (unsigned long i = 0; i < tail.keyframes_count; i++)
+            {
+                struct PacketKeyframe kfrm;
+                LbMemoryCopy(&kfrm, src, sizeof(struct PacketKeyframe));
+                src += sizeof(struct PacketKeyframe);
+                if ((packet_file_keyframe_size(kfrm.offset) == 0) || !packet_file_add_keyframe(kfrm.turn, kfrm.offset))
+                    return false;
+            }
+            return true;
+        }
+    }
+    WARNMSG("Packet file index not found, rebuilding it");
+    unsigned char rec[PACKET_RECORD_SIZE];
+    unsigned long pos = 0;
+    while (pos < pckfile.buf_len)
+    {
+        unsigned long kfrm_len = packet_file_keyframe_size(pos);
+        if (kfrm_len > 0)
+        {
+            if (!packet_file_add_keyframe(pckfile.turns_count, pos))
+                return false;
+            pos += kfrm_len;
+            continue;
+        }
+        if ((pckfile.turns_count % PACKET_INDEX_INTERVAL) == 0)
+        {
+            if (!packet_file_add_offset(pos))
+                return false;
+            LbMemorySet(rec, 0, sizeof(rec));
+        }
+        unsigned long n = packet_record_decode(&pckfile.buf[pos], pckfile.buf_len - pos, rec);
+        if (n == 0)
+            break;
+        pos += n;
+        pckfile.turns_count++;
+    }
+    pckfile.buf_len = pos;
+    return true;
+}
+
 TbBool open_packet_file_for_load(char *fname, struct CatalogueEntry *centry)
 {
     LbMemorySet(centry, 0, sizeof(struct CatalogueEntry));
+    packet_file_reset_state();
     strcpy(game.packet_fname, fname);
     game.packet_save_fp = LbFileOpen(game.packet_fname, Lb_FILE_MODE_READ_ONLY);
     if (game.packet_save_fp == -1)
@@ -139,7 +405,40 @@ TbBool open_packet_file_for_load(char *fname, struct CatalogueEntry *centry)
         return false;
     }
     game.packet_file_pos = LbFilePosition(game.packet_save_fp);
-    game.turns_stored = (LbFileLengthHandle(game.packet_save_fp) - game.packet_file_pos) / PACKET_TURN_SIZE;
+    pckfile.data_start = game.packet_file_pos;
+    // Packet data chunk is the last one read, its version tells format of the turns which follow
+    struct FileChunkHeader hdr;
+    LbFileSeek(game.packet_save_fp, pckfile.data_start - sizeof(struct FileChunkHeader), Lb_FILE_SEEK_BEGINNING);
+    if ((LbFileRead(game.packet_save_fp, &hdr, sizeof(struct FileChunkHeader)) != sizeof(struct FileChunkHeader)) || (hdr.id != SGC_PacketData))
+    {
+        hdr.ver = PckDV_Raw;
+    }
+    pckfile.format = hdr.ver;
+    switch (pckfile.format)
+    {
+    case PckDV_Raw:
+        game.turns_stored = (LbFileLengthHandle(game.packet_save_fp) - game.packet_file_pos) / PACKET_TURN_SIZE;
+        break;
+    case PckDV_Indexed:
+    case PckDV_Keyframes:
+        if (!packet_file_load_indexed_data())
+        {
+            LbFileClose(game.packet_save_fp);
+            game.packet_save_fp = -1;
+            game.packet_fopened = 0;
+            packet_file_reset_state();
+            WARNMSG("Couldn't correctly read packet file \"%s\" turns data.",fname);
+            return false;
+        }
+        game.turns_stored = pckfile.turns_count;
+        break;
+    default:
+        LbFileClose(game.packet_save_fp);
+        game.packet_save_fp = -1;
+        game.packet_fopened = 0;
+        WARNMSG("Packet file \"%s\" turns data version %lu not supported.",fname,(unsigned long)hdr.ver);
+        return false;
+    }
     if ((game.packet_checksum_verify) && (!game.packet_save_head.chksum_available))
     {
         WARNMSG("PacketSave checksum not available, checking disabled.");
@@ -166,67 +465,149 @@ void post_init_packets(void)
     clear_packets();
 }
 
-static TbBigChecksum get_thing_simple_checksum(const struct Thing *tng)
+/**
+ * Writes buffered turns to the packet file being saved.
+ * If the write fails, offsets of further data would be unknown, so saving is stopped;
+ * the file stays readable up to the last complete write.
+ */
+static TbBool flush_packet_file_buffer(void)
 {
-    return (ulong)tng->mappos.x.val + (ulong)tng->mappos.y.val + (ulong)tng->mappos.z.val
-         + (ulong)tng->move_angle_xy + (ulong)tng->owner;
+    if (pckfile.buf_pos == 0)
+        return true;
+    LbFileSeek(game.packet_save_fp, 0, Lb_FILE_SEEK_END);
+    if (LbFileWrite(game.packet_save_fp, pckfile.buf, pckfile.buf_pos) != pckfile.buf_pos)
+    {
+        ERRORLOG("Packet file write error, saving packets stopped");
+        pckfile.writing = false;
+        return false;
+    }
+    pckfile.data_written += pckfile.buf_pos;
+    pckfile.buf_pos = 0;
+    pckfile.buf_turns = 0;
+    if ( !LbFileFlush(game.packet_save_fp) )
+    {
+        ERRORLOG("Unable to flush PacketSave File");
+        return false;
+    }
+    return true;
 }
 
-static TbBigChecksum get_packet_save_checksum(void)
+/**
+ * Writes game state snapshot at current position of the packet file being saved.
+ */
+static TbBool save_packet_file_keyframe(void)
 {
-    TbBigChecksum sum = 0;
-    for (long tng_idx = 0; tng_idx < THINGS_COUNT; tng_idx++)
+    if (!flush_packet_file_buffer())
+        return false;
+    unsigned long packed_len;
+    unsigned char* packed = pack_game_state_snapshot(&packed_len);
+    if (packed == NULL)
+        return false;
+    unsigned char kfrm_head[PACKET_KEYFRAME_HEADER_SIZE];
+    kfrm_head[0] = 0;
+    kfrm_head[1] = 0;
+    LbMemoryCopy(&kfrm_head[2], &packed_len, sizeof(unsigned long));
+    LbFileSeek(game.packet_save_fp, 0, Lb_FILE_SEEK_END);
+    if ((LbFileWrite(game.packet_save_fp, kfrm_head, PACKET_KEYFRAME_HEADER_SIZE) != PACKET_KEYFRAME_HEADER_SIZE) ||
+        (LbFileWrite(game.packet_save_fp, packed, packed_len) != packed_len))
     {
-        struct Thing* tng = thing_get(tng_idx);
-        if ((tng->alloc_flags & TAlF_Exists) != 0)
-        {
-            // It would be nice to completely ignore effects, but since
-            // thing indices are used in packets, lack of effect may cause desync too.
-            if ((tng->class_id != TCls_AmbientSnd) && (tng->class_id != TCls_EffectElem))
-            {
-                sum += get_thing_simple_checksum(tng);
-            }
-        }
+        ERRORLOG("Packet file write error, saving packets stopped");
+        pckfile.writing = false;
+        LbMemoryFree(packed);
+        return false;
     }
-    return sum;
+    LbMemoryFree(packed);
+    // The keyframe is in the file even if it can't be indexed, so offsets of further data must include it
+    unsigned long kfrm_pos = pckfile.data_written;
+    pckfile.data_written += PACKET_KEYFRAME_HEADER_SIZE + packed_len;
+    if (!packet_file_add_keyframe(pckfile.turns_count, kfrm_pos))
+        return false;
+    SYNCDBG(7,"Stored keyframe for turn %lu, %lu bytes",(unsigned long)pckfile.turns_count,packed_len);
+    return true;
 }
 
 short save_packets(void)
 {
-    const int turn_data_size = PACKET_TURN_SIZE;
-    unsigned char pckt_buf[PACKET_TURN_SIZE+4];
+    unsigned char rec[PACKET_RECORD_SIZE];
     TbBigChecksum chksum;
     SYNCDBG(6,"Starting");
+    if (!pckfile.writing)
+        return false;
     if (game.packet_checksum_verify)
-        chksum = get_packet_save_checksum();
+        chksum = get_things_sync_hash();
     else
         chksum = 0;
-    LbFileSeek(game.packet_save_fp, 0, Lb_FILE_SEEK_END);
-    // Prepare data in the buffer
+    // Prepare record of the turn
     for (int i = 0; i < NET_PLAYERS_COUNT; i++)
-        LbMemoryCopy(&pckt_buf[i*sizeof(struct Packet)], &game.packets[i], sizeof(struct Packet));
-    LbMemoryCopy(&pckt_buf[NET_PLAYERS_COUNT*sizeof(struct Packet)], &chksum, sizeof(TbBigChecksum));
-    // Write buffer into file
-    if (LbFileWrite(game.packet_save_fp, &pckt_buf, turn_data_size) != turn_data_size)
+        LbMemoryCopy(&rec[i*sizeof(struct Packet)], &game.packets[i], sizeof(struct Packet));
+    LbMemoryCopy(&rec[NET_PLAYERS_COUNT*sizeof(struct Packet)], &chksum, sizeof(TbBigChecksum));
+    // Once in a while, store game state snapshot, to allow restoring it without simulating all the turns
+    if ((pckfile.turns_count % PACKET_KEYFRAME_INTERVAL) == 0)
     {
-        ERRORLOG("Packet file write error");
+        if (!save_packet_file_keyframe())
+        {
+            WARNLOG("Cannot store game state snapshot in packet file");
+            if (!pckfile.writing)
+                return false;
+        }
     }
-    if ( !LbFileFlush(game.packet_save_fp) )
+    // Every few turns, store whole record and remember where it is
+    if ((pckfile.turns_count % PACKET_INDEX_INTERVAL) == 0)
     {
-        ERRORLOG("Unable to flush PacketSave File");
-        return false;
+        if (!packet_file_add_offset(pckfile.data_written + pckfile.buf_pos))
+        {
+            ERRORLOG("Cannot extend packet file index");
+            return false;
+        }
+        LbMemorySet(pckfile.record, 0, sizeof(pckfile.record));
+    }
+    pckfile.buf_pos += packet_record_encode(rec, pckfile.record, &pckfile.buf[pckfile.buf_pos]);
+    LbMemoryCopy(pckfile.record, rec, sizeof(pckfile.record));
+    pckfile.buf_turns++;
+    pckfile.turns_count++;
+    // Write buffered turns to disk only once in a while
+    if (pckfile.buf_turns >= PACKET_FLUSH_TURNS)
+    {
+        return flush_packet_file_buffer();
     }
     return true;
 }
 
+/**
+ * Writes remaining buffered turns, followed by index of turns, to the packet file being saved.
+ */
+static void finish_packet_file_for_save(void)
+{
+    flush_packet_file_buffer();
+    struct PacketIndexTail tail;
+    tail.keyframes_count = pckfile.keyframes_count;
+    tail.turns_count = pckfile.turns_count;
+    tail.interval = PACKET_INDEX_INTERVAL;
+    tail.offsets_count = pckfile.offsets_count;
+    tail.magic = PACKET_INDEX_MAGIC;
+    LbFileSeek(game.packet_save_fp, 0, Lb_FILE_SEEK_END);
+    long len = pckfile.offsets_count * sizeof(unsigned long);
+    long kfrm_len = pckfile.keyframes_count * sizeof(struct PacketKeyframe);
+    if (((len > 0) && (LbFileWrite(game.packet_save_fp, pckfile.offsets, len) != len)) ||
+        ((kfrm_len > 0) && (LbFileWrite(game.packet_save_fp, pckfile.keyframes, kfrm_len) != kfrm_len)) ||
+        (LbFileWrite(game.packet_save_fp, &tail, sizeof(tail)) != sizeof(tail)))
+    {
+        ERRORLOG("Cannot write packet file index");
+    }
+}
+
 void close_packet_file(void)
 {
     if ( game.packet_fopened )
     {
+        if (pckfile.writing) {
+            finish_packet_file_for_save();
+        }
         LbFileClose(game.packet_save_fp);
         game.packet_fopened = 0;
         game.packet_save_fp = -1;
     }
+    packet_file_reset_state();
 }
 
 void dump_memory_to_file(const char * fname, const char * buf, size_t len)
@@ -284,6 +665,7 @@ TbBool open_new_packet_file_for_save(void)
               game.packet_save_head.players_comp |= (1 << i) & 0xff;
         }
     }
+    packet_file_reset_state();
     LbFileDelete(game.packet_fname);
     game.packet_save_fp = LbFileOpen(game.packet_fname, Lb_FILE_MODE_NEW);
     if (game.packet_save_fp == -1)
@@ -302,15 +684,79 @@ TbBool open_new_packet_file_for_save(void)
         game.packet_save_fp = -1;
         return false;
     }
+    pckfile.format = PckDV_Keyframes;
+    pckfile.writing = true;
+    pckfile.data_start = LbFilePosition(game.packet_save_fp);
+    pckfile.buf_len = PACKET_FLUSH_TURNS * PACKET_RECORD_CODED_MAX;
+    pckfile.buf = (unsigned char *)LbMemoryAlloc(pckfile.buf_len);
+    if (pckfile.buf == NULL)
+    {
+        ERRORLOG("Cannot allocate packet file buffer");
+        LbFileClose(game.packet_save_fp);
+        game.packet_fopened = 0;
+        game.packet_save_fp = -1;
+        packet_file_reset_state();
+        return false;
+    }
     game.packet_fopened = 1;
     return true;
 }
 
+/**
+ * Reads turn record from the packet file.
+ * Reading is sequential, unless a different turn than the next one is requested,
+ * in which case the file position is moved to the requested turn.
+ */
+static TbBool read_packet_file_record(GameTurn nturn, unsigned char *rec)
+{
+    if (pckfile.format == PckDV_Raw)
+    {
+        unsigned char pckt_buf[PACKET_TURN_SIZE+4];
+        const int turn_data_size = PACKET_TURN_SIZE;
+        if (nturn != pckfile.next_turn)
+        {
+            game.packet_file_pos = pckfile.data_start + nturn * turn_data_size;
+            LbFileSeek(game.packet_save_fp, game.packet_file_pos, Lb_FILE_SEEK_BEGINNING);
+        }
+        if (LbFileRead(game.packet_save_fp, &pckt_buf, turn_data_size) == -1)
+            return false;
+        game.packet_file_pos += turn_data_size;
+        for (long i = 0; i < NET_PLAYERS_COUNT; i++)
+            LbMemoryCopy(&rec[i * sizeof(struct Packet)], &pckt_buf[i * sizeof(struct Packet)], sizeof(struct Packet));
+        LbMemoryCopy(&rec[NET_PLAYERS_COUNT * sizeof(struct Packet)], &pckt_buf[NET_PLAYERS_COUNT * sizeof(struct Packet)], sizeof(TbBigChecksum));
+    } else
+    {
+        if ((nturn != pckfile.next_turn) || ((nturn % PACKET_INDEX_INTERVAL) == 0))
+        {
+            // Go to the last whole record before the requested turn, and decode up to it
+            unsigned long k = nturn / PACKET_INDEX_INTERVAL;
+            if (k >= pckfile.offsets_count)
+                return false;
+            pckfile.buf_pos = pckfile.offsets[k];
+            LbMemorySet(pckfile.record, 0, sizeof(pckfile.record));
+            for (GameTurn turn = k * PACKET_INDEX_INTERVAL; turn < nturn; turn++)
+            {
+                unsigned long n = packet_record_decode(&pckfile.buf[pckfile.buf_pos], pckfile.buf_len - pckfile.buf_pos, pckfile.record);
+                if (n == 0)
+                    return false;
+                pckfile.buf_pos += n;
+            }
+        }
+        unsigned long n = packet_record_decode(&pckfile.buf[pckfile.buf_pos], pckfile.buf_len - pckfile.buf_pos, pckfile.record);
+        if (n == 0)
+            return false;
+        pckfile.buf_pos += n;
+        game.packet_file_pos = pckfile.data_start + pckfile.buf_pos;
+        LbMemoryCopy(rec, pckfile.record, PACKET_RECORD_SIZE);
+    }
+    pckfile.next_turn = nturn + 1;
+    return true;
+}
+
 void load_packets_for_turn(GameTurn nturn)
 {
     SYNCDBG(19,"Starting");
-    const int turn_data_size = PACKET_TURN_SIZE;
-    unsigned char pckt_buf[PACKET_TURN_SIZE+4];
+    unsigned char rec[PACKET_RECORD_SIZE];
     struct Packet* pckt = get_packet(my_player_number);
     TbChecksum pckt_chksum = pckt->chksum;
     if (nturn >= game.turns_stored)
@@ -320,22 +766,21 @@ void load_packets_for_turn(GameTurn nturn)
         return;
     }
 
-    if (LbFileRead(game.packet_save_fp, &pckt_buf, turn_data_size) == -1)
+    if (!read_packet_file_record(nturn, rec))
     {
         ERRORDBG(18,"Cannot read turn data from Packet File");
         erstat_inc(ESE_CantReadPackets);
         return;
     }
-    game.packet_file_pos += turn_data_size;
     for (long i = 0; i < NET_PLAYERS_COUNT; i++)
-        LbMemoryCopy(&game.packets[i], &pckt_buf[i * sizeof(struct Packet)], sizeof(struct Packet));
-    TbBigChecksum tot_chksum = llong(&pckt_buf[NET_PLAYERS_COUNT * sizeof(struct Packet)]);
+        LbMemoryCopy(&game.packets[i], &rec[i * sizeof(struct Packet)], sizeof(struct Packet));
+    TbBigChecksum tot_chksum = llong(&rec[NET_PLAYERS_COUNT * sizeof(struct Packet)]);
     if (game.turns_fastforward > 0)
         game.turns_fastforward--;
     if (game.packet_checksum_verify)
     {
         pckt = get_packet(my_player_number);
-        if (get_packet_save_checksum() != tot_chksum)
+        if (get_things_sync_hash() != tot_chksum)
         {
             ERRORLOG("PacketSave checksum - Out of sync (GameTurn %d)", game.play_gameturn);
             if (!is_onscreen_msg_visible())
@@ -350,6 +795,115 @@ void load_packets_for_turn(GameTurn nturn)
     }
 }
 
+static void store_packet_playback_params(struct PacketPlaybackParams *pbparams)
+{
+    pbparams->packet_save_enable = game.packet_save_enable;
+    pbparams->packet_load_enable = game.packet_load_enable;
+    LbMemoryCopy(pbparams->packet_fname, game.packet_fname, sizeof(pbparams->packet_fname));
+    pbparams->packet_fopened = game.packet_fopened;
+    pbparams->packet_save_fp = game.packet_save_fp;
+    pbparams->packet_file_pos = game.packet_file_pos;
+    pbparams->packet_save_head = game.packet_save_head;
+    pbparams->turns_stored = game.turns_stored;
+    pbparams->numfield_149F38 = game.numfield_149F38;
+    pbparams->packet_checksum_verify = game.packet_checksum_verify;
+    pbparams->log_things_start_turn = game.log_things_start_turn;
+    pbparams->log_things_end_turn = game.log_things_end_turn;
+    pbparams->turns_packetoff = game.turns_packetoff;
+    pbparams->local_plyr_idx = game.local_plyr_idx;
+    pbparams->numfield_149F47 = game.numfield_149F47;
+    pbparams->flags_cd = game.flags_cd;
+    pbparams->game_kind = game.game_kind;
+}
+
+static void recall_packet_playback_params(const struct PacketPlaybackParams *pbparams)
+{
+    game.packet_save_enable = pbparams->packet_save_enable;
+    game.packet_load_enable = pbparams->packet_load_enable;
+    LbMemoryCopy(game.packet_fname, pbparams->packet_fname, sizeof(game.packet_fname));
+    game.packet_fopened = pbparams->packet_fopened;
+    game.packet_save_fp = pbparams->packet_save_fp;
+    game.packet_file_pos = pbparams->packet_file_pos;
+    game.packet_save_head = pbparams->packet_save_head;
+    game.turns_stored = pbparams->turns_stored;
+    game.numfield_149F38 = pbparams->numfield_149F38;
+    game.packet_checksum_verify = pbparams->packet_checksum_verify;
+    game.log_things_start_turn = pbparams->log_things_start_turn;
+    game.log_things_end_turn = pbparams->log_things_end_turn;
+    game.turns_packetoff = pbparams->turns_packetoff;
+    game.local_plyr_idx = pbparams->local_plyr_idx;
+    game.numfield_149F47 = pbparams->numfield_149F47;
+    game.flags_cd = pbparams->flags_cd;
+    game.game_kind = pbparams->game_kind;
+}
+
+/**
+ * Replaces game state with snapshot stored in the packet file being replayed.
+ */
+static TbBool restore_packet_file_keyframe(const struct PacketKeyframe *kfrm)
+{
+    unsigned long kfrm_len = packet_file_keyframe_size(kfrm->offset);
+    if (kfrm_len == 0)
+        return false;
+    struct PacketPlaybackParams pbparams;
+    store_packet_playback_params(&pbparams);
+    PlayerNumber plyr_idx = my_player_number;
+    if (!unpack_game_state_snapshot(&pckfile.buf[kfrm->offset + PACKET_KEYFRAME_HEADER_SIZE], kfrm_len - PACKET_KEYFRAME_HEADER_SIZE))
+    {
+        ERRORLOG("Cannot restore game state snapshot for turn %lu",kfrm->turn);
+        return false;
+    }
+    my_player_number = plyr_idx;
+    reinit_level_after_load();
+    recall_packet_playback_params(&pbparams);
+    pannel_map_update(0, 0, gameadd.map_subtiles_x+1, gameadd.map_subtiles_y+1);
+    light_import_system_state(&gameadd.lightst);
+    game.pckt_gameturn = kfrm->turn;
+    // Make sure next read of turn data starts at index entry
+    pckfile.next_turn = ULONG_MAX;
+    return true;
+}
+
+/**
+ * Moves the replay to given turn of the packet file. Game state from the last snapshot
+ * before that turn is restored, and remaining turns are fast forwarded.
+ * If the replay is already between that snapshot and requested turn, it is only fast forwarded.
+ * @param nturn Index of the packet file turn which is to be loaded next.
+ * @return True if the replay was moved; false if it cannot reach the turn.
+ */
+TbBool seek_packet_file_to_turn(GameTurn nturn)
+{
+    if ((!game.packet_load_enable) || (!game.packet_fopened))
+        return false;
+    if (nturn >= game.turns_stored)
+    {
+        WARNLOG("Cannot seek to turn %lu, packet file has %lu turns",(unsigned long)nturn,(unsigned long)game.turns_stored);
+        return false;
+    }
+    const struct PacketKeyframe* kfrm = NULL;
+    for (unsigned long i = 0; i < pckfile.keyframes_count; i++)
+    {
+        if (pckfile.keyframes[i].turn > nturn)
+            break;
+        kfrm = &pckfile.keyframes[i];
+    }
+    if ((game.pckt_gameturn <= nturn) && ((kfrm == NULL) || (kfrm->turn <= game.pckt_gameturn)))
+    {
+        game.turns_fastforward = nturn - game.pckt_gameturn;
+        return true;
+    }
+    if (kfrm == NULL)
+    {
+        WARNLOG("No game state snapshot before turn %lu in packet file",(unsigned long)nturn);
+        return false;
+    }
+    if (!restore_packet_file_keyframe(kfrm))
+        return false;
+    game.turns_fastforward = nturn - kfrm->turn;
+    SYNCMSG("Packet file seek to turn %lu, from snapshot at turn %lu",(unsigned long)nturn,kfrm->turn);
+    return true;
+}
+
 void set_packet_pause_toggle()
 {
     struct PlayerInfo* player = get_my_player();
@@ -88,9 +88,39 @@ long smaller_gold_vein_lookup_idx(long higher_gold_slabs, long higher_gem_slabs)
     return gold_idx;
 }
 
-void check_treasure_map(unsigned char *treasure_map, unsigned short *vein_list, long *gold_next_idx, MapSlabCoord veinslb_x, MapSlabCoord veinslb_y)
+/**
+ * Puts a gold vein into free GoldLookup item, or replaces a smaller vein if there are no free items.
+ */
+static void add_gold_vein_to_lookup(long *gold_next_idx, long sum_x, long sum_y, long slabs, long gold_slabs, long gem_slabs)
 {
     long gold_idx;
+    // Now get a GoldLookup struct to put the vein into
+    if (*gold_next_idx < GOLD_LOOKUP_COUNT)
+    {
+        gold_idx = *gold_next_idx;
+        (*gold_next_idx)++;
+    } else
+    {
+        gold_idx = smaller_gold_vein_lookup_idx(gold_slabs, gem_slabs);
+    }
+    // Write the vein to GoldLookup item
+    if (gold_idx != -1)
+    {
+        struct GoldLookup* gldlook = get_gold_lookup(gold_idx);
+        LbMemorySet(gldlook, 0, sizeof(struct GoldLookup));
+        gldlook->flags |= 0x01;
+        gldlook->stl_x = slab_subtile_center(sum_x / slabs);
+        gldlook->stl_y = slab_subtile_center(sum_y / slabs);
+        gldlook->field_A = gold_slabs;
+        gldlook->field_C = 0;
+        gldlook->num_gold_slabs = gold_slabs;
+        gldlook->num_gem_slabs = gem_slabs;
+        SYNCDBG(8,"Added vein %d at (%d,%d)",(int)gold_idx,(int)gldlook->stl_x,(int)gldlook->stl_y);
+    }
+}
+
+void check_treasure_map(unsigned char *treasure_map, unsigned short *vein_list, long *gold_next_idx, MapSlabCoord veinslb_x, MapSlabCoord veinslb_y)
+{
     // First, find a vein
     long vein_total = 0;
     MapSlabCoord slb_x = veinslb_x;
@@ -148,44 +178,18 @@ void check_treasure_map(unsigned char *treasure_map, unsigned short *vein_list,
         slb_x = slb_num_decode_x(vein_list[vein_idx]);
         slb_y = slb_num_decode_y(vein_list[vein_idx]);
     }
-    // Now get a GoldLookup struct to put the vein into
-    if (*gold_next_idx < GOLD_LOOKUP_COUNT)
-    {
-        gold_idx = *gold_next_idx;
-        (*gold_next_idx)++;
-    } else
-    {
-        gold_idx = smaller_gold_vein_lookup_idx(gold_slabs, gem_slabs);
-    }
-    // Write the vein to GoldLookup item
-    if (gold_idx != -1)
-    {
-        struct GoldLookup* gldlook = get_gold_lookup(gold_idx);
-        LbMemorySet(gldlook, 0, sizeof(struct GoldLookup));
-        gldlook->flags |= 0x01;
-        gldlook->stl_x = slab_subtile_center(gld_v1 / gld_v3);
-        gldlook->stl_y = slab_subtile_center(gld_v2 / gld_v3);
-        gldlook->field_A = gold_slabs;
-        gldlook->field_C = 0;
-        gldlook->num_gold_slabs = gold_slabs;
-        gldlook->num_gem_slabs = gem_slabs;
-        SYNCDBG(8,"Added vein %d at (%d,%d)",(int)gold_idx,(int)gldlook->stl_x,(int)gldlook->stl_y);
-    }
+    add_gold_vein_to_lookup(gold_next_idx, gld_v1, gld_v2, gld_v3, gold_slabs, gem_slabs);
 }
 
 /**
- * Scans map for gold veins, and fills up gold_lookup array with veins found.
+ * Scans whole map for gold veins, and fills up gold_lookup array with veins found.
+ * Used only if the gold vein index can't be used for current map.
  */
-void check_map_for_gold(void)
+void scan_map_for_gold(void)
 {
     MapSlabCoord slb_x;
     MapSlabCoord slb_y;
     SlabCodedCoords slb_num;
-    SYNCDBG(8,"Starting");
-    for (long i = 0; i < GOLD_LOOKUP_COUNT; i++)
-    {
-        LbMemorySet(&game.gold_lookup[i], 0, sizeof(struct GoldLookup));
-    }
     // Make a map with treasure areas marked
     unsigned char* treasure_map = (unsigned char*)scratch;
     unsigned short* vein_list = (unsigned short*)&scratch[gameadd.map_tiles_x * gameadd.map_tiles_y];
@@ -218,4 +222,421 @@ void check_map_for_gold(void)
     }
     SYNCDBG(8,"Found %ld possible digging locations",gold_next_idx);
 }
+
+/******************************************************************************/
+/* Gold vein index.
+ * Keeps the same veins which scan_map_for_gold() would find, and updates them
+ * when a slab changes, so that checking for gold doesn't require map rescan.
+ * A vein is either a connected area of gold slabs together with gem slabs
+ * it reached first, or a single gem slab which was not reached by any gold. */
+
+enum GoldVeinSlabClass {
+    GVSlab_None = 0,
+    GVSlab_Gold,
+    GVSlab_Gems,
+};
+
+struct GoldVein {
+    /** First slab of the vein in map order; that's where map scan starts it. */
+    SlabCodedCoords start_slb;
+    long sum_x;
+    long sum_y;
+    long slabs;
+    long gold_slabs;
+    long gem_slabs;
+};
+
+#define GOLD_VEINS_COUNT (MAX_TILES_X*MAX_TILES_Y+1)
+
+static struct GoldVein gold_veins[GOLD_VEINS_COUNT];
+static unsigned short gold_veins_free[GOLD_VEINS_COUNT];
+static long gold_veins_free_num = 0;
+static long gold_veins_high_idx = 0;
+static unsigned char vein_slab_class[MAX_TILES_X*MAX_TILES_Y];
+static unsigned short vein_of_slab[MAX_TILES_X*MAX_TILES_Y];
+static unsigned char vein_slab_mark[MAX_TILES_X*MAX_TILES_Y];
+static unsigned short vein_dirty_slabs[MAX_TILES_X*MAX_TILES_Y];
+static unsigned short vein_dirty_gems[MAX_TILES_X*MAX_TILES_Y];
+static unsigned short vein_flood_slabs[MAX_TILES_X*MAX_TILES_Y];
+static TbBool gold_veins_valid = false;
+/** Set if the index can't be used for current map; stays set until a slab changes its class. */
+static TbBool gold_veins_unusable = false;
+/** Result of map scan, re-used when the index is unusable and slabs didn't change. */
+static struct GoldLookup scanned_gold_lookup[GOLD_LOOKUP_COUNT];
+static TbBool scanned_gold_lookup_valid = false;
+
+static unsigned char get_vein_slab_class(SlabCodedCoords slb_num)
+{
+    struct SlabMap* slb = get_slabmap_direct(slb_num);
+    const struct SlabAttr* slbattr = get_slab_attrs(slb);
+    if ((slbattr->block_flags & (SlbAtFlg_Valuable)) == 0)
+        return GVSlab_None;
+    if (slb->kind == SlbT_GEMS)
+        return GVSlab_Gems;
+    return GVSlab_Gold;
+}
+
+/**
+ * Scanning the map treats neighbours of border slabs oddly; index is not used if there's gold on the far border.
+ */
+static TbBool vein_slab_on_far_border(SlabCodedCoords slb_num)
+{
+    return (slb_num_decode_x(slb_num) >= gameadd.map_tiles_x - 1) || (slb_num_decode_y(slb_num) >= gameadd.map_tiles_y - 1);
+}
+
+static int get_vein_slab_neighbours(SlabCodedCoords slb_num, SlabCodedCoords *around_slb)
+{
+    MapSlabCoord slb_x = slb_num_decode_x(slb_num);
+    MapSlabCoord slb_y = slb_num_decode_y(slb_num);
+    int n = 0;
+    if (slb_x > 0)
+        around_slb[n++] = slb_num - 1;
+    if (slb_x < gameadd.map_tiles_x - 1)
+        around_slb[n++] = slb_num + 1;
+    if (slb_y > 0)
+        around_slb[n++] = slb_num - gameadd.map_tiles_x;
+    if (slb_y < gameadd.map_tiles_y - 1)
+        around_slb[n++] = slb_num + gameadd.map_tiles_x;
+    return n;
+}
+
+static unsigned short gold_vein_create(SlabCodedCoords start_slb)
+{
+    if (gold_veins_free_num <= 0)
+    {
+        ERRORLOG("No free gold vein items");
+        return 0;
+    }
+    unsigned short vein_idx = gold_veins_free[--gold_veins_free_num];
+    if (gold_veins_high_idx < vein_idx)
+        gold_veins_high_idx = vein_idx;
+    struct GoldVein* vein = &gold_veins[vein_idx];
+    LbMemorySet(vein, 0, sizeof(struct GoldVein));
+    vein->start_slb = start_slb;
+    return vein_idx;
+}
+
+static void gold_vein_delete(unsigned short vein_idx)
+{
+    gold_veins[vein_idx].slabs = 0;
+    gold_veins_free[gold_veins_free_num++] = vein_idx;
+}
+
+static void gold_vein_add_slab(unsigned short vein_idx, SlabCodedCoords slb_num)
+{
+    struct GoldVein* vein = &gold_veins[vein_idx];
+    vein->sum_x += slb_num_decode_x(slb_num);
+    vein->sum_y += slb_num_decode_y(slb_num);
+    vein->slabs++;
+    if (vein_slab_class[slb_num] == GVSlab_Gems)
+        vein->gem_slabs++;
+    else
+        vein->gold_slabs++;
+    vein_of_slab[slb_num] = vein_idx;
+}
+
+/**
+ * Removes gem slab from the vein it belongs to. Gem-only veins are deleted.
+ */
+static void gold_vein_remove_gem(SlabCodedCoords slb_num)
+{
+    unsigned short vein_idx = vein_of_slab[slb_num];
+    if (vein_idx == 0)
+        return;
+    struct GoldVein* vein = &gold_veins[vein_idx];
+    vein->sum_x -= slb_num_decode_x(slb_num);
+    vein->sum_y -= slb_num_decode_y(slb_num);
+    vein->slabs--;
+    vein->gem_slabs--;
+    vein_of_slab[slb_num] = 0;
+    if (vein->slabs <= 0)
+        gold_vein_delete(vein_idx);
+}
+
+/**
+ * Deletes the vein containing given slab; all its slabs are added to dirty list.
+ */
+static void gold_vein_dissolve(SlabCodedCoords slb_num, long *dirty_num)
+{
+    unsigned short vein_idx = vein_of_slab[slb_num];
+    if (vein_idx == 0)
+        return;
+    SlabCodedCoords around_slb[4];
+    long i = *dirty_num;
+    vein_of_slab[slb_num] = 0;
+    vein_dirty_slabs[(*dirty_num)++] = slb_num;
+    for (; i < *dirty_num; i++)
+    {
+        int around_num = get_vein_slab_neighbours(vein_dirty_slabs[i], around_slb);
+        for (int n = 0; n < around_num; n++)
+        {
+            if (vein_of_slab[around_slb[n]] == vein_idx)
+            {
+                vein_of_slab[around_slb[n]] = 0;
+                vein_dirty_slabs[(*dirty_num)++] = around_slb[n];
+            }
+        }
+    }
+    gold_vein_delete(vein_idx);
+}
+
+/**
+ * Creates a vein from the connected gold slabs which are not in any vein yet.
+ * Gem slabs touching the vein are added to dirty gems list if gems_num is given.
+ */
+static void gold_vein_flood(SlabCodedCoords start_slb, long *gems_num)
+{
+    SlabCodedCoords around_slb[4];
+    unsigned short vein_idx = gold_vein_create(start_slb);
+    if (vein_idx == 0)
+        return;
+    SlabCodedCoords first_slb = start_slb;
+    long flood_num = 0;
+    gold_vein_add_slab(vein_idx, start_slb);
+    vein_flood_slabs[flood_num++] = start_slb;
+    for (long i = 0; i < flood_num; i++)
+    {
+        int around_num = get_vein_slab_neighbours(vein_flood_slabs[i], around_slb);
+        for (int n = 0; n < around_num; n++)
+        {
+            SlabCodedCoords slb_num = around_slb[n];
+            if (vein_slab_class[slb_num] == GVSlab_Gold)
+            {
+                if (vein_of_slab[slb_num] == 0)
+                {
+                    gold_vein_add_slab(vein_idx, slb_num);
+                    vein_flood_slabs[flood_num++] = slb_num;
+                    if (first_slb > slb_num)
+                        first_slb = slb_num;
+                }
+            } else
+            if ((vein_slab_class[slb_num] == GVSlab_Gems) && (gems_num != NULL))
+            {
+                if (vein_slab_mark[slb_num] == 0)
+                {
+                    vein_slab_mark[slb_num] = 1;
+                    vein_dirty_gems[(*gems_num)++] = slb_num;
+                }
+            }
+        }
+    }
+    gold_veins[vein_idx].start_slb = first_slb;
+}
+
+/**
+ * Adds gem slab to a vein. Map scan gives the gem to the first vein which reached it,
+ * which is the touching gold vein starting first, if it starts before the gem.
+ */
+static void gold_vein_place_gem(SlabCodedCoords slb_num)
+{
+    SlabCodedCoords around_slb[4];
+    unsigned short vein_idx = 0;
+    int around_num = get_vein_slab_neighbours(slb_num, around_slb);
+    for (int n = 0; n < around_num; n++)
+    {
+        if (vein_slab_class[around_slb[n]] != GVSlab_Gold)
+            continue;
+        unsigned short near_idx = vein_of_slab[around_slb[n]];
+        if ((near_idx == 0) || (gold_veins[near_idx].start_slb >= slb_num))
+            continue;
+        if ((vein_idx == 0) || (gold_veins[near_idx].start_slb < gold_veins[vein_idx].start_slb))
+            vein_idx = near_idx;
+    }
+    if (vein_idx == 0)
+    {
+        vein_idx = gold_vein_create(slb_num);
+        if (vein_idx == 0)
+            return;
+    }
+    gold_vein_add_slab(vein_idx, slb_num);
+}
+
+/**
+ * Marks the gold vein index as outdated; it will be rebuilt when it's needed.
+ */
+void clear_gold_veins(void)
+{
+    gold_veins_valid = false;
+    gold_veins_unusable = false;
+    scanned_gold_lookup_valid = false;
+}
+
+/**
+ * Re-creates the gold vein index from slabs on map.
+ * Needs to be called whenever slabs are changed without using slab placing functions, ie. after loading a game.
+ */
+void rebuild_gold_veins(void)
+{
+    SlabCodedCoords slb_num;
+    SYNCDBG(8,"Starting");
+    gold_veins_valid = false;
+    gold_veins_unusable = false;
+    scanned_gold_lookup_valid = false;
+    gold_veins_high_idx = 0;
+    gold_veins_free_num = 0;
+    for (long i = GOLD_VEINS_COUNT-1; i > 0; i--)
+    {
+        gold_veins[i].slabs = 0;
+        gold_veins_free[gold_veins_free_num++] = i;
+    }
+    LbMemorySet(vein_of_slab, 0, sizeof(vein_of_slab));
+    LbMemorySet(vein_slab_mark, 0, sizeof(vein_slab_mark));
+    SlabCodedCoords slabs_count = gameadd.map_tiles_x * gameadd.map_tiles_y;
+    for (slb_num = 0; slb_num < slabs_count; slb_num++)
+    {
+        vein_slab_class[slb_num] = get_vein_slab_class(slb_num);
+        if ((vein_slab_class[slb_num] == GVSlab_Gold) && vein_slab_on_far_border(slb_num))
+            gold_veins_unusable = true;
+    }
+    if (gold_veins_unusable)
+    {
+        SYNCDBG(7,"Gold on map border, index not used");
+        return;
+    }
+    for (slb_num = 0; slb_num < slabs_count; slb_num++)
+    {
+        if ((vein_slab_class[slb_num] == GVSlab_Gold) && (vein_of_slab[slb_num] == 0))
+            gold_vein_flood(slb_num, NULL);
+    }
+    for (slb_num = 0; slb_num < slabs_count; slb_num++)
+    {
+        if (vein_slab_class[slb_num] == GVSlab_Gems)
+            gold_vein_place_gem(slb_num);
+    }
+    gold_veins_valid = true;
+}
+
+/**
+ * Updates gold vein index after a slab was changed.
+ * Only veins which touch the slab are re-created.
+ */
+void update_gold_veins_for_slab(MapSlabCoord slb_x, MapSlabCoord slb_y)
+{
+    SlabCodedCoords around_slb[4];
+    if (gold_veins_unusable)
+    {
+        // Slab classes are kept, so that the map is re-scanned only if one of them changes
+        SlabCodedCoords slb_num = get_slab_number(slb_x, slb_y);
+        unsigned char slb_class = get_vein_slab_class(slb_num);
+        if (vein_slab_class[slb_num] == slb_class)
+            return;
+        scanned_gold_lookup_valid = false;
+        // Removing gold from the border may make the index usable again
+        if ((vein_slab_class[slb_num] == GVSlab_Gold) && vein_slab_on_far_border(slb_num))
+            gold_veins_unusable = false;
+        vein_slab_class[slb_num] = slb_class;
+        return;
+    }
+    if (!gold_veins_valid)
+        return;
+    SlabCodedCoords slb_num = get_slab_number(slb_x, slb_y);
+    unsigned char slb_class = get_vein_slab_class(slb_num);
+    if (vein_slab_class[slb_num] == slb_class)
+        return;
+    if ((slb_class == GVSlab_Gold) && vein_slab_on_far_border(slb_num))
+    {
+        gold_veins_valid = false;
+        return;
+    }
+    // Remove veins which may change
+    long dirty_num = 0;
+    if (vein_slab_class[slb_num] == GVSlab_Gold)
+    {
+        gold_vein_dissolve(slb_num, &dirty_num);
+    } else
+    {
+        gold_vein_remove_gem(slb_num);
+        vein_dirty_slabs[dirty_num++] = slb_num;
+    }
+    vein_slab_class[slb_num] = slb_class;
+    if (slb_class == GVSlab_Gold)
+    {
+        int around_num = get_vein_slab_neighbours(slb_num, around_slb);
+        for (int n = 0; n < around_num; n++)
+        {
+            if (vein_slab_class[around_slb[n]] == GVSlab_Gold)
+                gold_vein_dissolve(around_slb[n], &dirty_num);
+        }
+    }
+    // Re-create gold veins from the removed slabs
+    long gems_num = 0;
+    long i;
+    for (i = 0; i < dirty_num; i++)
+    {
+        SlabCodedCoords dirty_slb = vein_dirty_slabs[i];
+        if ((vein_slab_class[dirty_slb] == GVSlab_Gold) && (vein_of_slab[dirty_slb] == 0))
+            gold_vein_flood(dirty_slb, &gems_num);
+    }
+    // And place again gems which could have been reached by different vein
+    for (i = 0; i < dirty_num; i++)
+    {
+        SlabCodedCoords dirty_slb = vein_dirty_slabs[i];
+        if ((vein_slab_class[dirty_slb] == GVSlab_Gems) && (vein_slab_mark[dirty_slb] == 0))
+        {
+            vein_slab_mark[dirty_slb] = 1;
+            vein_dirty_gems[gems_num++] = dirty_slb;
+        }
+    }
+    for (i = 0; i < gems_num; i++)
+    {
+        SlabCodedCoords gem_slb = vein_dirty_gems[i];
+        vein_slab_mark[gem_slb] = 0;
+        gold_vein_remove_gem(gem_slb);
+        gold_vein_place_gem(gem_slb);
+    }
+    SYNCDBG(19,"Updated %ld slabs and %ld gems around_slb (%d,%d)",dirty_num,gems_num,(int)slb_x,(int)slb_y);
+}
+
+static int gold_vein_compare_start(const void *a, const void *b)
+{
+    const struct GoldVein *vein_a = &gold_veins[*(const unsigned short *)a];
+    const struct GoldVein *vein_b = &gold_veins[*(const unsigned short *)b];
+    if (vein_a->start_slb < vein_b->start_slb)
+        return -1;
+    return (vein_a->start_slb > vein_b->start_slb);
+}
+
+/**
+ * Fills up gold_lookup array with gold veins on map.
+ * Veins are taken from the index in order in which map scan would find them.
+ */
+void check_map_for_gold(void)
+{
+    SYNCDBG(8,"Starting");
+    for (long i = 0; i < GOLD_LOOKUP_COUNT; i++)
+    {
+        LbMemorySet(&game.gold_lookup[i], 0, sizeof(struct GoldLookup));
+    }
+    if (!gold_veins_valid && !gold_veins_unusable)
+    {
+        rebuild_gold_veins();
+    }
+    if (!gold_veins_valid)
+    {
+        if (!scanned_gold_lookup_valid)
+        {
+            scan_map_for_gold();
+            LbMemoryCopy(scanned_gold_lookup, game.gold_lookup, sizeof(scanned_gold_lookup));
+            scanned_gold_lookup_valid = true;
+        } else
+        {
+            LbMemoryCopy(game.gold_lookup, scanned_gold_lookup, sizeof(scanned_gold_lookup));
+        }
+        return;
+    }
+    long veins_num = 0;
+    for (long vein_idx = 1; vein_idx <= gold_veins_high_idx; vein_idx++)
+    {
+        if (gold_veins[vein_idx].slabs > 0)
+            vein_flood_slabs[veins_num++] = vein_idx;
+    }
+    qsort(vein_flood_slabs, veins_num, sizeof(vein_flood_slabs[0]), gold_vein_compare_start);
+    long gold_next_idx = 0;
+    for (long i = 0; i < veins_num; i++)
+    {
+        const struct GoldVein* vein = &gold_veins[vein_flood_slabs[i]];
+        add_gold_vein_to_lookup(&gold_next_idx, vein->sum_x, vein->sum_y, vein->slabs, vein->gold_slabs, vein->gem_slabs);
+    }
+    SYNCDBG(8,"Found %ld possible digging locations in %ld veins",gold_next_idx,veins_num);
+}
 /******************************************************************************/
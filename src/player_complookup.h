@@ -49,6 +49,10 @@ unsigned short field_1A;
 #pragma pack()
 /******************************************************************************/
 void check_map_for_gold(void);
+void scan_map_for_gold(void);
+void clear_gold_veins(void);
+void rebuild_gold_veins(void);
+void update_gold_veins_for_slab(MapSlabCoord slb_x, MapSlabCoord slb_y);
 struct GoldLookup *get_gold_lookup(long idx);
 long gold_lookup_index(const struct GoldLookup *gldlook);
 /******************************************************************************/
@@ -2767,7 +2767,7 @@ long task_move_creature_to_pos(struct Computer2 *comp, struct ComputerTask *ctas
         // Being here means we have a thing for different task picked up, so wait until it's dropped
         return CTaskRet_Unk0;
     }
-    thing = thing_get(ctask->move_to_pos.target_thing_idx);
+    thing = thing_get_if_generation(ctask->move_to_pos.target_thing_idx, ctask->move_to_pos.target_thing_gen);
     if (can_thing_be_picked_up_by_player(thing, dungeon->owner))
     {
         if (computer_place_thing_in_power_hand(comp, thing, &ctask->move_to_pos.pos_86)) {
@@ -3072,7 +3072,7 @@ long task_magic_speed_up(struct Computer2 *comp, struct ComputerTask *ctask)
     int k = 0;
     SYNCDBG(9,"Starting");
     dungeon = comp->dungeon;
-    creatng = thing_get(ctask->attack_magic.target_thing_idx);
+    creatng = thing_get_if_generation(ctask->attack_magic.target_thing_idx, ctask->attack_magic.target_thing_gen);
     if (thing_is_invalid(creatng))
     {
         remove_task(comp, ctask);
@@ -3161,7 +3161,7 @@ long task_attack_magic(struct Computer2 *comp, struct ComputerTask *ctask)
     long i;
     SYNCDBG(9,"Starting");
     dungeon = comp->dungeon;
-    thing = thing_get(ctask->attack_magic.target_thing_idx);
+    thing = thing_get_if_generation(ctask->attack_magic.target_thing_idx, ctask->attack_magic.target_thing_gen);
     if (thing_is_invalid(thing)) {
         return CTaskRet_Unk1;
     }
@@ -3457,6 +3457,7 @@ TbBool create_task_move_creature_to_pos(struct Computer2 *comp, const struct Thi
     ctask->move_to_pos.pos_86.y.val = pos.y.val;
     ctask->move_to_pos.pos_86.z.val = pos.z.val;
     ctask->move_to_pos.target_thing_idx = thing->index;
+    ctask->move_to_pos.target_thing_gen = get_thing_generation(thing);
     ctask->move_to_pos.word_80 = 0;
     ctask->created_turn = game.play_gameturn;
     return true;
@@ -3787,6 +3788,7 @@ TbBool create_task_magic_speed_up(struct Computer2 *comp, const struct Thing *cr
     }
     ctask->ttype = CTT_MagicSpeedUp;
     ctask->attack_magic.target_thing_idx = creatng->index;
+    ctask->attack_magic.target_thing_gen = get_thing_generation(creatng);
     ctask->attack_magic.splevel = splevel;
     ctask->created_turn = game.play_gameturn;
     return true;
@@ -3808,6 +3810,7 @@ TbBool create_task_attack_magic(struct Computer2 *comp, const struct Thing *crea
     }
     ctask->ttype = CTT_AttackMagic;
     ctask->attack_magic.target_thing_idx = creatng->index;
+    ctask->attack_magic.target_thing_gen = get_thing_generation(creatng);
     ctask->attack_magic.splevel = splevel;
     ctask->attack_magic.repeat_num = repeat_num;
     ctask->attack_magic.gaction = gaction;
@@ -28,6 +28,7 @@
 #include "bflib_dernc.h"
 #include "bflib_memory.h"
 #include "bflib_math.h"
+#include "bflib_datetm.h"
 
 #include "config.h"
 #include "config_compp.h"
@@ -1511,9 +1512,15 @@ void process_computer_player2(PlayerNumber plyr_idx)
     if (comp->tasks_did <= 0) {
         return;
     }
+    profiler_zone_start(Zone_ComputerEvents);
     computer_check_events(comp);
+    profiler_zone_end(Zone_ComputerEvents);
+    profiler_zone_start(Zone_ComputerChecks);
     process_checks(comp);
+    profiler_zone_end(Zone_ComputerChecks);
+    profiler_zone_start(Zone_ComputerProcesses);
     process_processes_and_task(comp);
+    profiler_zone_end(Zone_ComputerProcesses);
     if (comp->tasks_did > 1) {
         ERRORLOG("Computer player %d performed %d tasks instead of up to one",(int)plyr_idx,(int)comp->tasks_did);
     }
@@ -1608,6 +1615,7 @@ void setup_computer_players2(void)
 {
   int i;
   gameadd.turn_last_checked_for_gold = game.play_gameturn;
+  rebuild_gold_veins();
   check_map_for_gold();
   for (i=0; i < COMPUTER_TASKS_COUNT; i++)
   {
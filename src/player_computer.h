@@ -402,7 +402,7 @@ struct ComputerTask { // sizeof = 148
         long splevel;
         short field_74;
         short target_thing_idx;
-        short word_78;
+        ThingGeneration target_thing_gen;
         short field_7A;
         long repeat_num;
         long gaction;
@@ -437,7 +437,7 @@ struct ComputerTask { // sizeof = 148
         long field_70;
         short field_74;
         short target_thing_idx;
-        short word_78;
+        ThingGeneration target_thing_gen;
         short field_7Ac;
         long repeat_num;
         short word_80;
@@ -48,6 +48,7 @@
 #include "room_util.h"
 #include "game_legacy.h"
 #include "frontmenu_ingame_map.h"
+#include "net_sync.h"
 #include "keeperfx.hpp"
 #include "post_inc.h"
 
@@ -4673,6 +4674,8 @@ static void change_ownership_or_delete_object_thing_in_room(struct Room *room, s
     if (thing_is_dragged_or_pulled(thing)) {
         return;
     }
+    // Owner may be changed in many places below
+    mark_thing_sync_hash_dirty(thing);
     // Handle specific things in rooms for which we have a special re-creation code
     PlayerNumber oldowner;
 
@@ -38,6 +38,7 @@
 #include "config_creature.h"
 #include "gui_soundmsgs.h"
 #include "game_legacy.h"
+#include "net_sync.h"
 #include "keeperfx.hpp"
 #include "frontend.h"
 #include "math.h"
@@ -406,6 +407,8 @@ void change_slab_owner_from_script(MapSlabCoord slb_x, MapSlabCoord slb_y, Playe
 short check_and_asimilate_thing_by_room(struct Thing *thing)
 {
     struct Room *room;
+    // Owner may be changed in many places below
+    mark_thing_sync_hash_dirty(thing);
     if (thing_is_dragged_or_pulled(thing))
     {
         ERRORLOG("It shouldn't be possible to drag %s during initial asimilation",thing_model_name(thing));
@@ -574,6 +574,7 @@ void update_map_collide(SlabKind slbkind, MapSubtlCoord stl_x, MapSubtlCoord stl
     }
     mapblk->flags &= (SlbAtFlg_TaggedValuable|SlbAtFlg_Unexplored);
     mapblk->flags |= nflags;
+    map_solidity_changed();
 }
 
 void do_slab_efficiency_alteration(MapSlabCoord slb_x, MapSlabCoord slb_y)
@@ -70,6 +70,7 @@
 #include "room_library.h"
 #include "map_utils.h"
 #include "map_blocks.h"
+#include "net_sync.h"
 #include "gui_topmsg.h"
 #include "front_simple.h"
 #include "frontend.h"
@@ -96,9 +97,18 @@
 extern "C" {
 #endif
 
+/** Amount of creature list counter slots; creatures and diggers lists for each dungeon, and the no-dungeon list. */
+#define CREATURE_LIST_SLOTS_COUNT (2*DUNGEONS_COUNT+1)
 /******************************************************************************/
 int creature_swap_idx[CREATURE_TYPES_COUNT];
 
+/** Amounts of creatures of each model on each of the players creature lists. */
+static unsigned short creature_list_model_count[CREATURE_LIST_SLOTS_COUNT][CREATURE_TYPES_MAX];
+/** Amounts of all creatures on each of the players creature lists. */
+static unsigned short creature_list_total_count[CREATURE_LIST_SLOTS_COUNT];
+/** Creature list counter slot used for each creature, plus one; zero if creature isn't counted. */
+static unsigned char creature_list_slot[THINGS_COUNT_MAX];
+
 struct Creatures creatures[] = {
   { 0,  0, 0, 0, 0, 0, 0, 0, 0, 0x0000, 1},
   {17, 34, 1, 0, 1, 0, 1, 0, 0, 0x0180, 1},
@@ -459,12 +469,45 @@ void draw_swipe_graphic(void)
     myplyr->field_1 ^= (myplyr->field_1 ^ 4 * UNSYNC_RANDOM(4)) & 4;
 }
 
+/**
+ * Returns if an event required the creature to re-evaluate its decisions at once.
+ * @see creature_force_decisions_check()
+ */
+TbBool creature_decisions_forced(const struct Thing *creatng)
+{
+    struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
+    return (game.play_gameturn < cctrl->decisions_forced_until);
+}
+
+/**
+ * Makes the creature re-evaluate its decisions on its next update, without waiting for its check turn.
+ * Used when creature situation changes suddenly - when it's hit, slapped or dropped.
+ */
+void creature_force_decisions_check(struct Thing *creatng)
+{
+    struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
+    if (creature_control_invalid(cctrl))
+        return;
+    // Forced on the event turn and the next one, as the creature may have been updated already
+    cctrl->decisions_forced_until = game.play_gameturn + 2;
+}
+
+/**
+ * Returns if the creature should re-check a decision which is re-checked once per given amount of turns.
+ * Creatures are spread over these turns by their index, so they don't all check at the same turn.
+ */
+TbBool creature_decision_check_due(const struct Thing *creatng, unsigned long interval)
+{
+    if ((interval <= 1) || (((game.play_gameturn + creatng->index) % interval) == 0))
+        return true;
+    return creature_decisions_forced(creatng);
+}
+
 long creature_available_for_combat_this_turn(struct Thing *creatng)
 {
     TRACE_THING(creatng);
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
-    // Check once per 8 turns
-    if (((game.play_gameturn + creatng->index) & 7) != 0)
+    if (!creature_decision_check_due(creatng, gameadd.combat_check_interval))
     {
         // On first turn in a state, check anyway
         if (game.play_gameturn - cctrl->tasks_check_turn > 1) {
@@ -545,7 +588,7 @@ void set_creature_combat_object_state(struct Thing *creatng, struct Thing *obthi
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     cctrl->combat.battle_enemy_idx = obthing->index;
-    cctrl->combat.battle_enemy_crtn = obthing->creation_turn;
+    cctrl->combat.battle_enemy_gen = get_thing_generation(obthing);
     cctrl->field_AA = 0;
     cctrl->combat_flags |= CmbtF_ObjctFight;
     const struct CreatureStats* crstat = creature_stats_get_from_thing(creatng);
@@ -599,7 +642,7 @@ void set_creature_combat_door_state(struct Thing *creatng, struct Thing *obthing
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(creatng);
     cctrl->combat.battle_enemy_idx = obthing->index;
-    cctrl->combat.battle_enemy_crtn = obthing->creation_turn;
+    cctrl->combat.battle_enemy_gen = get_thing_generation(obthing);
     cctrl->field_AA = 0;
     cctrl->combat_flags |= CmbtF_DoorFight;
     const struct CreatureStats* crstat = creature_stats_get_from_thing(creatng);
@@ -1358,9 +1401,9 @@ void process_thing_spell_teleport_effects(struct Thing *thing, struct CastedSpel
                             struct CreatureBattle* battle = creature_battle_get(i);
                             if ( (battle->fighters_num != 0) && (battle_with_creature_of_player(thing->owner, i)) )
                             {
-                                struct Thing* tng = thing_get(battle->first_creatr);
+                                struct Thing* tng = thing_get_if_generation(battle->first_creatr, battle->first_creatr_gen);
                                 TRACE_THING(tng);
-                                if (creature_can_navigate_to(thing, &tng->mappos, NavRtF_NoOwner))
+                                if (!thing_is_invalid(tng) && creature_can_navigate_to(thing, &tng->mappos, NavRtF_NoOwner))
                                 {
                                     pos.x.val = tng->mappos.x.val;
                                     pos.y.val = tng->mappos.y.val;
@@ -3497,6 +3540,114 @@ struct Thing *get_creature_near_for_controlling(PlayerNumber plyr_idx, MapCoord
     return nearest_thing;
 }
 
+/**
+ * Returns index of counters slot for given players creature list.
+ * @param plyr_idx Owner of the list.
+ * @param list_kind Kind of the list, from CreatureListKinds enumeration.
+ */
+static long creature_list_counter_slot(PlayerNumber plyr_idx, unsigned char list_kind)
+{
+    if ((list_kind == CrLst_NoDungeon) || (plyr_idx < 0) || (plyr_idx >= DUNGEONS_COUNT))
+        return 2*DUNGEONS_COUNT;
+    if (list_kind == CrLst_Diggers)
+        return DUNGEONS_COUNT + plyr_idx;
+    return plyr_idx;
+}
+
+static void add_creature_to_list_counters(const struct Thing *creatng)
+{
+    long slot;
+    if (is_neutral_thing(creatng))
+        slot = creature_list_counter_slot(creatng->owner, CrLst_NoDungeon);
+    else
+    if (creature_is_for_dungeon_diggers_list(creatng))
+        slot = creature_list_counter_slot(creatng->owner, CrLst_Diggers);
+    else
+        slot = creature_list_counter_slot(creatng->owner, CrLst_Creatures);
+    creature_list_slot[creatng->index] = slot + 1;
+    creature_list_total_count[slot]++;
+    if (creatng->model < CREATURE_TYPES_MAX)
+        creature_list_model_count[slot][creatng->model]++;
+}
+
+static void remove_creature_from_list_counters(const struct Thing *creatng)
+{
+    long slot = creature_list_slot[creatng->index];
+    if (slot == 0)
+        return;
+    slot--;
+    creature_list_slot[creatng->index] = 0;
+    if (creature_list_total_count[slot] > 0)
+        creature_list_total_count[slot]--;
+    if ((creatng->model < CREATURE_TYPES_MAX) && (creature_list_model_count[slot][creatng->model] > 0))
+        creature_list_model_count[slot][creatng->model]--;
+}
+
+/**
+ * Returns amount of creatures of given model on given players creature list, without sweeping the list.
+ * @param plyr_idx Owner of the list; ignored for the no-dungeon list.
+ * @param list_kind Kind of the list, from CreatureListKinds enumeration.
+ * @param crmodel Creature model, or CREATURE_ANY.
+ */
+long get_creature_list_model_count(PlayerNumber plyr_idx, unsigned char list_kind, ThingModel crmodel)
+{
+    long slot = creature_list_counter_slot(plyr_idx, list_kind);
+    if (crmodel == CREATURE_ANY)
+        return creature_list_total_count[slot];
+    if ((crmodel <= 0) || (crmodel >= CREATURE_TYPES_MAX))
+        return 0;
+    return creature_list_model_count[slot][crmodel];
+}
+
+/**
+ * Recomputes the creature list counters by sweeping all players creature lists.
+ * Needs to be called whenever the lists are restored or reset without set_first_creature()
+ * and remove_first_creature(), ie. after loading a game or at level start.
+ */
+void rebuild_creature_list_counters(void)
+{
+    SYNCDBG(8,"Starting");
+    LbMemorySet(creature_list_model_count, 0, sizeof(creature_list_model_count));
+    LbMemorySet(creature_list_total_count, 0, sizeof(creature_list_total_count));
+    LbMemorySet(creature_list_slot, 0, sizeof(creature_list_slot));
+    for (long slot = 0; slot < CREATURE_LIST_SLOTS_COUNT; slot++)
+    {
+        long i;
+        if (slot >= 2*DUNGEONS_COUNT) {
+            i = game.nodungeon_creatr_list_start;
+        } else
+        if (slot >= DUNGEONS_COUNT) {
+            i = get_dungeon(slot - DUNGEONS_COUNT)->digger_list_start;
+        } else {
+            i = get_dungeon(slot)->creatr_list_start;
+        }
+        unsigned long k = 0;
+        while (i != 0)
+        {
+            struct Thing* thing = thing_get(i);
+            if (thing_is_invalid(thing))
+            {
+                ERRORLOG("Jump to invalid thing detected");
+                break;
+            }
+            struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
+            i = cctrl->players_next_creature_idx;
+            // Per creature code
+            creature_list_slot[thing->index] = slot + 1;
+            creature_list_total_count[slot]++;
+            if (thing->model < CREATURE_TYPES_MAX)
+                creature_list_model_count[slot][thing->model]++;
+            // Per creature code ends
+            k++;
+            if (k > THINGS_COUNT)
+            {
+                ERRORLOG("Infinite loop detected when sweeping things list");
+                break;
+            }
+        }
+    }
+}
+
 /**
  * Puts a creature as first in a list of owning player creatures.
  *
@@ -3579,6 +3730,7 @@ void set_first_creature(struct Thing *creatng)
         dungeon->owned_creatures_of_model[creatng->model]++;
         creatng->alloc_flags |= TAlF_InDungeonList;
     }
+    add_creature_to_list_counters(creatng);
 }
 
 void remove_first_creature(struct Thing *creatng)
@@ -3651,6 +3803,7 @@ void remove_first_creature(struct Thing *creatng)
     cctrl->players_prev_creature_idx = 0;
     cctrl->players_next_creature_idx = 0;
     creatng->alloc_flags &= ~TAlF_InDungeonList;
+    remove_creature_from_list_counters(creatng);
 }
 
 TbBool thing_is_creature(const struct Thing *thing)
@@ -3755,6 +3908,7 @@ void change_creature_owner(struct Thing *creatng, PlayerNumber nowner)
     }
     // Add the creature to new owner
     creatng->owner = nowner;
+    mark_thing_sync_hash_dirty(creatng);
     set_first_creature(creatng);
     set_start_state(creatng);
     if (!is_neutral_thing(creatng))
@@ -56,6 +56,12 @@ enum ThingPickFlags {
     TPF_ReverseOrder     = 0x04,
 };
 
+enum CreatureListKinds {
+    CrLst_Creatures      = 0, /**< Dungeon list of creatures other than special diggers. */
+    CrLst_Diggers,            /**< Dungeon list of special diggers. */
+    CrLst_NoDungeon,          /**< List of creatures which have no dungeon. */
+};
+
 enum CreatureDeathFlags {
     CrDed_Default        = 0x00, /**< Default value if no flags are needed. */
     CrDed_NoEffects      = 0x01, /**< Set if no special effects should accompany the creature death. */
@@ -107,6 +113,9 @@ void free_swipe_graphic(void);
 void draw_swipe_graphic(void);
 
 long creature_available_for_combat_this_turn(struct Thing *thing);
+TbBool creature_decisions_forced(const struct Thing *creatng);
+void creature_force_decisions_check(struct Thing *creatng);
+TbBool creature_decision_check_due(const struct Thing *creatng, unsigned long interval);
 TbBool set_creature_object_combat(struct Thing *crthing, struct Thing *obthing);
 TbBool set_creature_object_snipe(struct Thing* crthing, struct Thing* obthing);
 TbBool set_creature_door_combat(struct Thing *crthing, struct Thing *obthing);
@@ -132,6 +141,8 @@ TbBool creature_is_for_dungeon_diggers_list(const struct Thing *creatng);
 TbBool creature_kind_is_for_dungeon_diggers_list(PlayerNumber plyr_idx, ThingModel crmodel);
 void set_first_creature(struct Thing *thing);
 void remove_first_creature(struct Thing *thing);
+long get_creature_list_model_count(PlayerNumber plyr_idx, unsigned char list_kind, ThingModel crmodel);
+void rebuild_creature_list_counters(void);
 long player_list_creature_filter_needs_to_be_placed_in_room_for_job(const struct Thing *thing, MaxTngFilterParam param, long maximizer);
 
 TbBool creature_has_lair_room(const struct Thing *creatng);
@@ -35,19 +35,165 @@
 #include "engine_arrays.h"
 #include "kjm_input.h"
 #include "gui_topmsg.h" 
+#include "net_sync.h"
 #include "post_inc.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 /******************************************************************************/
+/** First page of things storage; it always exists, and its first slot is the invalid thing. */
+struct ThingsPage things_page_first;
+/** Pages of things storage; pages other than first are allocated when needed. */
+static struct ThingsPage *things_pages[THINGS_PAGES_MAX] = {&things_page_first};
+/******************************************************************************/
+struct ThingsPage *get_things_page(unsigned short page_idx)
+{
+    if (page_idx >= game.things.pages_count)
+        return NULL;
+    return things_pages[page_idx];
+}
+
+/**
+ * Returns position of given thing in things storage, or 0 if it is not within any page.
+ * The page is taken from thing index; only slots cleared on deletion require searching pages.
+ */
+static long thing_storage_index(const struct Thing *thing)
+{
+    if (thing == NULL)
+        return 0;
+    long page_idx = thing->index / THINGS_PAGE_SIZE;
+    if ((page_idx < game.things.pages_count) && (things_pages[page_idx] != NULL))
+    {
+        const struct Thing* first = &things_pages[page_idx]->things[0];
+        if ((thing >= first) && (thing < first + THINGS_PAGE_SIZE))
+            return page_idx * THINGS_PAGE_SIZE + (thing - first);
+    }
+    for (long i = 0; i < game.things.pages_count; i++)
+    {
+        if (things_pages[i] == NULL)
+            break;
+        const struct Thing* first = &things_pages[i]->things[0];
+        if ((thing >= first) && (thing < first + THINGS_PAGE_SIZE))
+            return i * THINGS_PAGE_SIZE + (thing - first);
+    }
+    return 0;
+}
+
+/**
+ * Puts all slots of given page into free things list; lower indices will be allocated first.
+ */
+static void add_things_page_to_free_list(unsigned short page_idx)
+{
+    struct ThingsPage* page = things_pages[page_idx];
+    // First slot of first page is the invalid thing
+    long first_slot = (page_idx == 0) ? 1 : 0;
+    for (long i = first_slot; i < THINGS_PAGE_SIZE-1; i++)
+    {
+        page->next_free[i] = page_idx * THINGS_PAGE_SIZE + i + 1;
+    }
+    page->next_free[THINGS_PAGE_SIZE-1] = game.things.free_head;
+    game.things.free_head = page_idx * THINGS_PAGE_SIZE + first_slot;
+}
+
+/**
+ * Sets amount of pages in things storage, allocating or freeing pages other than first.
+ * Contents and free things list are not updated.
+ * @return True on success; on failure, the storage size is unchanged.
+ */
+TbBool resize_things_pages(unsigned short pages_count)
+{
+    if ((pages_count < 1) || (pages_count > THINGS_PAGES_MAX))
+        return false;
+    for (long i = 1; i < pages_count; i++)
+    {
+        if (things_pages[i] == NULL)
+        {
+            things_pages[i] = (struct ThingsPage *)LbMemoryAlloc(sizeof(struct ThingsPage));
+            if (things_pages[i] == NULL)
+            {
+                ERRORLOG("Cannot allocate things page %d",(int)i);
+                return false;
+            }
+        }
+    }
+    for (long i = pages_count; i < THINGS_PAGES_MAX; i++)
+    {
+        if (things_pages[i] != NULL)
+        {
+            LbMemoryFree(things_pages[i]);
+            things_pages[i] = NULL;
+        }
+    }
+    game.things.pages_count = pages_count;
+    return true;
+}
+
+/**
+ * Shrinks things storage to one page, and puts all its slots into free things list.
+ * Things are not deleted; this should be done before, if there are any.
+ */
+void reset_things_pages(void)
+{
+    resize_things_pages(1);
+    LbMemorySet(things_page_first.generation, 0, sizeof(things_page_first.generation));
+    LbMemorySet(things_page_first.next_free, 0, sizeof(things_page_first.next_free));
+    game.things.free_head = 0;
+    game.things.used_count = 0;
+    add_things_page_to_free_list(0);
+    invalidate_things_sync_hash();
+}
+
+/**
+ * Replaces things storage with pages stored in given buffer.
+ * Amount of pages is taken from the data length.
+ */
+TbBool restore_things_pages(const unsigned char *data, unsigned long data_len)
+{
+    if ((data_len % sizeof(struct ThingsPage)) != 0)
+        return false;
+    unsigned long pages_count = data_len / sizeof(struct ThingsPage);
+    if ((pages_count < 1) || (pages_count > THINGS_PAGES_MAX))
+        return false;
+    if (!resize_things_pages(pages_count))
+        return false;
+    for (long i = 0; i < pages_count; i++)
+    {
+        LbMemoryCopy(things_pages[i], data + i * sizeof(struct ThingsPage), sizeof(struct ThingsPage));
+    }
+    return true;
+}
+
+/**
+ * Extends things storage by one page, and puts the new slots into free things list.
+ */
+static TbBool add_things_page(void)
+{
+    unsigned short page_idx = game.things.pages_count;
+    if (page_idx >= THINGS_PAGES_MAX)
+        return false;
+    if (!resize_things_pages(page_idx + 1))
+        return false;
+    add_things_page_to_free_list(page_idx);
+    // Sync hash of the new slots may be left from previous level
+    invalidate_things_sync_hash();
+    SYNCLOG("Things storage extended to %d slots",(int)THINGS_COUNT);
+    return true;
+}
+
 struct Thing *allocate_free_thing_structure_f(unsigned char allocflags, const char *func_name)
 {
     struct Thing *thing;
     // Get a thing from "free things list"
-    long i = game.free_things_start_index;
-    // If there is no free thing, try to free an effect
-    if (i >= THINGS_COUNT-1)
+    long i = game.things.free_head;
+    // If there is no free thing, extend the storage
+    if (i == 0)
+    {
+        add_things_page();
+        i = game.things.free_head;
+    }
+    // If the storage is at its max size, try to free an effect
+    if (i == 0)
     {
         if ((allocflags & FTAF_FreeEffectIfNoSlots) != 0)
         {
@@ -62,10 +208,10 @@ struct Thing *allocate_free_thing_structure_f(unsigned char allocflags, const ch
 #endif
             }
         }
-        i = game.free_things_start_index;
+        i = game.things.free_head;
     }
     // Now, if there is still no free thing (we couldn't free any)
-    if (i >= THINGS_COUNT-1)
+    if (i == 0)
     {
 #if (BFDEBUG_LEVEL > 0)
         ERRORMSG("%s: Cannot allocate new thing, no free slots!",func_name);
@@ -73,21 +219,25 @@ struct Thing *allocate_free_thing_structure_f(unsigned char allocflags, const ch
         return INVALID_THING;
     }
     // And if there is free one, allocate it
-    thing = thing_get(game.free_things[i]);
+    thing = thing_get(i);
 #if (BFDEBUG_LEVEL > 0)
     if (thing_exists(thing)) {
-        ERRORMSG("%s: Found existing thing %d in free things list at pos %d!",func_name,(int)game.free_things[i],(int)i);
+        ERRORMSG("%s: Found existing thing %d in free things list!",func_name,(int)i);
     }
 #endif
-    LbMemorySet(thing, 0, sizeof(struct Thing));
     if (thing_is_invalid(thing)) {
         ERRORMSG("%s: Got invalid thing slot instead of free one!",func_name);
         return INVALID_THING;
     }
+    LbMemorySet(thing, 0, sizeof(struct Thing));
     thing->alloc_flags |= TAlF_Exists;
-    thing->index = game.free_things[i];
-    game.free_things[game.free_things_start_index] = 0;
-    game.free_things_start_index++;
+    thing->index = i;
+    mark_thing_sync_hash_dirty(thing);
+    struct ThingsPage* page = things_pages[i / THINGS_PAGE_SIZE];
+    game.things.free_head = page->next_free[i % THINGS_PAGE_SIZE];
+    page->next_free[i % THINGS_PAGE_SIZE] = 0;
+    page->generation[i % THINGS_PAGE_SIZE]++;
+    game.things.used_count++;
     TRACE_THING(thing);
 
     struct ThingAdd* thingadd = get_thingadd(thing->index);
@@ -98,8 +248,8 @@ struct Thing *allocate_free_thing_structure_f(unsigned char allocflags, const ch
 
 TbBool i_can_allocate_free_thing_structure(unsigned char allocflags)
 {
-    // Check if there are free slots
-    if (game.free_things_start_index < THINGS_COUNT-1)
+    // Check if there are free slots, or the storage can be extended
+    if ((game.things.free_head != 0) || (game.things.pages_count < THINGS_PAGES_MAX))
         return true;
     // Check if there are effect slots that could be freed
     if ((allocflags & FTAF_FreeEffectIfNoSlots) != 0)
@@ -115,9 +265,9 @@ TbBool i_can_allocate_free_thing_structure(unsigned char allocflags)
         ERRORLOG("Cannot allocate thing structure.");
         things_stats_debug_dump();
     }
-    if ((game.free_things_start_index > THINGS_COUNT - 2) && ((allocflags & FTAF_FreeEffectIfNoSlots) != 0))
+    if ((allocflags & FTAF_FreeEffectIfNoSlots) != 0)
     {
-        show_onscreen_msg(2 * game.num_fps, "Warning: Cannot create thing, %d/%d thing slots used.", game.free_things_start_index + 1, THINGS_COUNT);
+        show_onscreen_msg(2 * game.num_fps, "Warning: Cannot create thing, %d/%d thing slots used.", (int)game.things.used_count + 1, (int)THINGS_COUNT);
     }
     return false;
 }
@@ -129,10 +279,22 @@ TbBool i_can_allocate_free_thing_structure(unsigned char allocflags)
  */
 TbBool is_in_free_things_list(long tng_idx)
 {
-    for (int i = game.free_things_start_index; i < THINGS_COUNT - 1; i++)
+    long i = game.things.free_head;
+    long k = 0;
+    while (i != 0)
     {
-        if (game.free_things[i] == tng_idx)
+        if (i == tng_idx)
             return true;
+        struct ThingsPage* page = get_things_page(i / THINGS_PAGE_SIZE);
+        if (page == NULL)
+            break;
+        i = page->next_free[i % THINGS_PAGE_SIZE];
+        k++;
+        if (k > THINGS_COUNT)
+        {
+            ERRORLOG("Infinite loop detected when sweeping free things list");
+            break;
+        }
     }
     return false;
 }
@@ -168,9 +330,12 @@ void delete_thing_structure_f(struct Thing *thing, long a2, const char *func_nam
     }
     remove_thing_from_its_class_list(thing);
     remove_thing_from_mapwho(thing);
-    if (thing->index > 0) {
-        game.free_things_start_index--;
-        game.free_things[game.free_things_start_index] = thing->index;
+    mark_thing_sync_hash_dirty(thing);
+    struct ThingsPage* page = get_things_page(thing->index / THINGS_PAGE_SIZE);
+    if ((thing->index > 0) && (page != NULL)) {
+        page->next_free[thing->index % THINGS_PAGE_SIZE] = game.things.free_head;
+        game.things.free_head = thing->index;
+        game.things.used_count--;
     } else {
 #if (BFDEBUG_LEVEL > 0)
         ERRORMSG("%s: Performed deleting of thing with bad index %d!",func_name,(int)thing->index);
@@ -187,7 +352,7 @@ void delete_thing_structure_f(struct Thing *thing, long a2, const char *func_nam
 struct Thing *thing_get_f(long tng_idx, const char *func_name)
 {
     if ((tng_idx > 0) && (tng_idx < THINGS_COUNT)) {
-        return game.things.lookup[tng_idx];
+        return &things_pages[tng_idx / THINGS_PAGE_SIZE]->things[tng_idx % THINGS_PAGE_SIZE];
     }
     if ((tng_idx < -1) || (tng_idx >= THINGS_COUNT)) {
         ERRORMSG("%s: Request of invalid thing (no %d) intercepted",func_name,(int)tng_idx);
@@ -197,15 +362,38 @@ struct Thing *thing_get_f(long tng_idx, const char *func_name)
 
 long thing_get_index(const struct Thing *thing)
 {
-    long tng_idx = (thing - game.things.lookup[0]);
-    if ((tng_idx > 0) && (tng_idx < THINGS_COUNT))
-        return tng_idx;
-    return 0;
+    return thing_storage_index(thing);
 }
 
 short thing_is_invalid(const struct Thing *thing)
 {
-    return (thing <= game.things.lookup[0]) || (thing > game.things.lookup[THINGS_COUNT-1]) || (thing == NULL);
+    return (thing_storage_index(thing) == 0);
+}
+
+ThingGeneration get_thing_generation(const struct Thing *thing)
+{
+    long tng_idx = thing_storage_index(thing);
+    if (tng_idx == 0)
+        return 0;
+    return things_pages[tng_idx / THINGS_PAGE_SIZE]->generation[tng_idx % THINGS_PAGE_SIZE];
+}
+
+/**
+ * Returns thing of given index, if its slot wasn't re-allocated since the generation was taken.
+ * Allows to detect stale indices, kept by things which may outlive their targets.
+ * @return Returns thing, or invalid thing pointer if it doesn't exist anymore.
+ */
+struct Thing *thing_get_if_generation(long tng_idx, ThingGeneration generation)
+{
+    if ((tng_idx <= 0) || (tng_idx >= THINGS_COUNT))
+        return INVALID_THING;
+    struct ThingsPage* page = things_pages[tng_idx / THINGS_PAGE_SIZE];
+    if (page->generation[tng_idx % THINGS_PAGE_SIZE] != generation)
+        return INVALID_THING;
+    struct Thing* thing = &page->things[tng_idx % THINGS_PAGE_SIZE];
+    if (!thing_exists(thing))
+        return INVALID_THING;
+    return thing;
 }
 
 TbBool thing_exists_idx(long tng_idx)
@@ -220,8 +408,8 @@ TbBool thing_exists(const struct Thing *thing)
     if ((thing->alloc_flags & TAlF_Exists) == 0)
         return false;
 #if (BFDEBUG_LEVEL > 0)
-    if (thing->index != (thing-thing_get(0)))
-        WARNLOG("Incorrectly indexed thing (%d) at pos %d",(int)thing->index,(int)(thing-thing_get(0)));
+    if (thing->index != thing_storage_index(thing))
+        WARNLOG("Incorrectly indexed thing (%d) at pos %d",(int)thing->index,(int)thing_storage_index(thing));
     if ((thing->class_id < 1) || (thing->class_id >= THING_CLASSES_COUNT))
         WARNLOG("Thing %d is of invalid class %d",(int)thing->index,(int)thing->class_id);
 #endif
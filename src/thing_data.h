@@ -29,6 +29,12 @@ extern "C" {
 typedef unsigned short Thingid;
 
 /******************************************************************************/
+/** Amount of things in one page of things storage. */
+#define THINGS_PAGE_SIZE      1024
+/** Max amount of things pages; indices have to fit in signed links, like next_of_class. */
+#define THINGS_PAGES_MAX        32
+#define THINGS_COUNT_MAX     (THINGS_PAGE_SIZE*THINGS_PAGES_MAX)
+
 /** Enums for thing->field_0 bit fields. */
 enum ThingAllocFlags {
     TAlF_Exists            = 0x01,
@@ -273,7 +279,7 @@ unsigned short floor_height;
     short prev_of_class;
 };
 
-#define INVALID_THING (game.things.lookup[0])
+#define INVALID_THING (&things_page_first.things[0])
 
 /** Macro used for debugging problems related to things.
  * Should be executed in every function which changes a thing.
@@ -306,14 +312,30 @@ struct ThingAdd // Additional thing data
     PlayerNumber holding_player;
 };
 
+/** Part of things storage; pages are allocated when all things in the existing ones are in use. */
+struct ThingsPage {
+    struct Thing things[THINGS_PAGE_SIZE];
+    struct ThingAdd adds[THINGS_PAGE_SIZE];
+    /** Counter increased every time the slot is allocated, so that stale indices can be detected. */
+    ThingGeneration generation[THINGS_PAGE_SIZE];
+    /** Index of the next free thing, for slots which are in free things list. */
+    ThingIndex next_free[THINGS_PAGE_SIZE];
+};
+
 #pragma pack()
 /******************************************************************************/
+extern struct ThingsPage things_page_first;
+/******************************************************************************/
 #define allocate_free_thing_structure(a1) allocate_free_thing_structure_f(a1, __func__)
 struct Thing *allocate_free_thing_structure_f(unsigned char a1, const char *func_name);
 TbBool i_can_allocate_free_thing_structure(unsigned char allocflags);
 #define delete_thing_structure(thing, a2) delete_thing_structure_f(thing, a2, __func__)
 void delete_thing_structure_f(struct Thing *thing, long a2, const char *func_name);
 TbBool is_in_free_things_list(long tng_idx);
+void reset_things_pages(void);
+TbBool resize_things_pages(unsigned short pages_count);
+struct ThingsPage *get_things_page(unsigned short page_idx);
+TbBool restore_things_pages(const unsigned char *data, unsigned long data_len);
 
 #define thing_get(tng_idx) thing_get_f(tng_idx, __func__)
 struct Thing *thing_get_f(long tng_idx, const char *func_name);
@@ -321,6 +343,8 @@ TbBool thing_exists_idx(long tng_idx);
 TbBool thing_exists(const struct Thing *thing);
 short thing_is_invalid(const struct Thing *thing);
 long thing_get_index(const struct Thing *thing);
+ThingGeneration get_thing_generation(const struct Thing *thing);
+struct Thing *thing_get_if_generation(long tng_idx, ThingGeneration generation);
 
 TbBool thing_is_in_limbo(const struct Thing* thing);
 TbBool thing_is_dragged_or_pulled(const struct Thing *thing);
@@ -31,6 +31,7 @@
 #include "thing_physics.h"
 #include "thing_factory.h"
 #include "thing_navigate.h"
+#include "thing_particles.h"
 #include "creature_senses.h"
 #include "config_creature.h"
 #include "front_simple.h"
@@ -40,6 +41,7 @@
 #include "gui_topmsg.h"
 #include "game_legacy.h"
 #include "engine_redraw.h"
+#include "net_sync.h"
 #include "keeperfx.hpp"
 #include "gui_soundmsgs.h"
 #include "post_inc.h"
@@ -603,6 +605,19 @@ struct Thing *create_effect_element(const struct Coord3d *pos, unsigned short ee
     return thing;
 }
 
+/**
+ * Creates an effect element which nothing refers to after it's created.
+ * Static decorative models become particles and don't use a thing slot.
+ * @return True if the element was created.
+ */
+TbBool create_cosmetic_effect_element(const struct Coord3d *pos, unsigned short eelmodel, PlayerNumber owner)
+{
+    if (effect_element_model_is_particle(eelmodel)) {
+        return create_effect_particle(pos, eelmodel, owner);
+    }
+    return !thing_is_invalid(create_effect_element(pos, eelmodel, owner));
+}
+
 void process_spells_affected_by_effect_elements(struct Thing *thing)
 {
     struct CreatureControl* cctrl = creature_control_get_from_thing(thing);
@@ -663,13 +678,13 @@ void process_spells_affected_by_effect_elements(struct Thing *thing)
             shift_y = -(radius * LbCosL(angle) >> 8) >> 8;
             pos.x.val = thing->mappos.x.val + shift_x;
             pos.y.val = thing->mappos.y.val + shift_y;
-            effeltng = create_thing(&pos, TCls_EffectElem, TngEffElm_RedFlash, thing->owner, -1);
+            create_cosmetic_effect_element(&pos, TngEffElm_RedFlash, thing->owner);
         }
     }
 
     if ((cctrl->spell_flags & CSAfF_Flying) != 0)
     {
-        effeltng = create_thing(&thing->mappos, TCls_EffectElem, TngEffElm_CloudDisperse, thing->owner, -1);
+        create_cosmetic_effect_element(&thing->mappos, TngEffElm_CloudDisperse, thing->owner);
     }
 
     if ((cctrl->spell_flags & CSAfF_Speed) != 0)
@@ -706,7 +721,7 @@ void process_spells_affected_by_effect_elements(struct Thing *thing)
         {
             struct CreatureStats* crstat = creature_stats_get_from_thing(thing);
             if ((dturn % 2) == 0) {
-                effeltng = create_effect_element(&thing->mappos, birth_effect_element[thing->owner], thing->owner);
+                create_cosmetic_effect_element(&thing->mappos, birth_effect_element[thing->owner], thing->owner);
             }
             creature_turn_to_face_angle(thing, thing->move_angle_xy + crstat->max_angle_change);
         }
@@ -716,7 +731,7 @@ void process_spells_affected_by_effect_elements(struct Thing *thing)
     {
         dturn = game.play_gameturn - thing->creation_turn;
         if ((dturn & 1) == 0) {
-            effeltng = create_effect_element(&thing->mappos, birth_effect_element[thing->owner], thing->owner);
+            create_cosmetic_effect_element(&thing->mappos, birth_effect_element[thing->owner], thing->owner);
         }
         struct CreatureStats* crstat = creature_stats_get_from_thing(thing);
         creature_turn_to_face_angle(thing, thing->move_angle_xy + crstat->max_angle_change);
@@ -874,7 +889,7 @@ TngUpdateRet update_effect_element(struct Thing *elemtng)
     if (i > 0)
     {
       if (((elemtng->creation_turn - game.play_gameturn) % i) == 0) {
-          create_effect_element(&elemtng->mappos, eestats->subeffect_model, elemtng->owner);
+          create_cosmetic_effect_element(&elemtng->mappos, eestats->subeffect_model, elemtng->owner);
       }
     }
     switch (eestats->field_1)
@@ -1033,6 +1048,7 @@ long move_effect(struct Thing *efftng)
             efftng->mappos.x.val = pos.x.val;
             efftng->mappos.y.val = pos.y.val;
             efftng->mappos.z.val = pos.z.val;
+            mark_thing_sync_hash_dirty(efftng);
         }
         else
         {
@@ -1127,9 +1143,8 @@ void effect_generate_effect_elements(const struct Thing *thing)
             long mag = effnfo->start_health - thing->health;
             arg = (mag << 7) + k/effnfo->field_B;
             set_coords_to_cylindric_shift(&pos, &thing->mappos, mag, arg, 0);
-            elemtng = create_effect_element(&pos, n, thing->owner);
-            TRACE_THING(elemtng);
-            SYNCDBG(18,"Created %s",thing_model_name(elemtng));
+            create_cosmetic_effect_element(&pos, n, thing->owner);
+            SYNCDBG(18,"Created effect element model %d",(int)n);
             k += 2048;
         }
         break;
@@ -1144,8 +1159,7 @@ void effect_generate_effect_elements(const struct Thing *thing)
             long mag = thing->health;
             arg = (mag << 7) + k/effnfo->field_B;
             set_coords_to_cylindric_shift(&pos, &thing->mappos, 16*mag, arg, 0);
-            elemtng = create_effect_element(&pos, n, thing->owner);
-            TRACE_THING(elemtng);
+            create_cosmetic_effect_element(&pos, n, thing->owner);
             k += 2048;
         }
         break;
@@ -1705,7 +1719,9 @@ long explosion_affecting_area(struct Thing *tngsrc, const struct Coord3d *pos, M
     long num_affected = 0;
     for (MapSubtlCoord stl_y = start_y; stl_y <= end_y; stl_y++)
     {
-        for (MapSubtlCoord stl_x = start_x; stl_x <= end_x; stl_x++)
+        // Blocks with empty mapwho are skipped; bits are checked as we go, so things moved by the blast are still found
+        for (MapSubtlCoord stl_x = find_next_mapwho_subtile_in_row(start_x, end_x, stl_y); stl_x <= end_x;
+            stl_x = find_next_mapwho_subtile_in_row(stl_x + 1, end_x, stl_y))
         {
             const struct Map* mapblk = get_map_block_at(stl_x, stl_y);
             num_affected += explosion_affecting_map_block(tngsrc, mapblk, pos, max_dist, max_damage, blow_strength, hit_targets, damage_type);
@@ -1862,7 +1878,8 @@ long poison_cloud_affecting_area(struct Thing *tngsrc, struct Coord3d *pos, long
     long num_affected = 0;
     for (MapSubtlCoord stl_y = start_y; stl_y <= end_y; stl_y++)
     {
-        for (MapSubtlCoord stl_x = start_x; stl_x <= end_x; stl_x++)
+        for (MapSubtlCoord stl_x = find_next_mapwho_subtile_in_row(start_x, end_x, stl_y); stl_x <= end_x;
+            stl_x = find_next_mapwho_subtile_in_row(stl_x + 1, end_x, stl_y))
         {
             HitTargetFlags hit_targets = hit_type_to_hit_targets(tngsrc->shot_effect.hit_type);
             struct Map* mapblk = get_map_block_at(stl_x, stl_y);
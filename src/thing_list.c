@@ -21,12 +21,15 @@
 
 #include "bflib_basics.h"
 #include "bflib_math.h"
+#include "bflib_memory.h"
 #include "globals.h"
 #include "bflib_sound.h"
 #include "packets.h"
+#include "net_sync.h"
 #include "light_data.h"
 #include "thing_objects.h"
 #include "thing_effects.h"
+#include "thing_particles.h"
 #include "thing_traps.h"
 #include "thing_shots.h"
 #include "thing_corpses.h"
@@ -75,6 +78,21 @@ Thing_Class_Func class_functions[] = {
 };
 
 unsigned long thing_create_errors = 0;
+
+/** Heads of per-cell creature chains in the creature grid. */
+static ThingIndex crgrid_head[CREATURE_GRID_CELLS_Y*CREATURE_GRID_CELLS_X];
+static ThingIndex crgrid_next[THINGS_COUNT_MAX];
+static ThingIndex crgrid_prev[THINGS_COUNT_MAX];
+/** Grid cell in which the thing is stored, plus one; zero if thing isn't in the grid. */
+static unsigned short crgrid_cell[THINGS_COUNT_MAX];
+/** Biggest clipbox of a creature stored in the grid; needed to extend query ranges. */
+static unsigned short crgrid_max_clipbox;
+/** Sequence numbers telling the order of things on their class lists; higher ones are nearer to the list head. */
+static unsigned long thing_list_seq[THINGS_COUNT_MAX];
+static unsigned long thing_list_seq_last;
+/** Buffers for candidates gathered from the grid during a query. */
+static ThingIndex crgrid_cand_index[THINGS_COUNT_MAX];
+static long crgrid_cand_value[THINGS_COUNT_MAX];
 /******************************************************************************/
 
 void set_previous_thing_position(struct Thing *thing) {
@@ -100,6 +118,7 @@ void add_thing_to_list(struct Thing *thing, struct StructureList *list)
         prevtng = thing_get(list->index);
     }
     list->count++;
+    thing_list_seq[thing->index] = ++thing_list_seq_last;
     thing->alloc_flags |= TAlF_IsInStrucList;
     thing->prev_of_class = 0;
     thing->next_of_class = list->index;
@@ -1110,6 +1129,7 @@ void update_things(void)
     sum += update_things_in_list(&game.thing_lists[TngList_Objects]);
     sum += update_things_in_list(&game.thing_lists[TngList_Effects]);
     sum += update_things_in_list(&game.thing_lists[TngList_EffectElems]);
+    update_effect_particles();
     sum += update_things_in_list(&game.thing_lists[TngList_DeadCreatrs]);
     sum += update_things_in_list(&game.thing_lists[TngList_EffectGens]);
     sum += update_things_in_list(&game.thing_lists[TngList_Doors]);
@@ -1341,6 +1361,7 @@ void remove_thing_from_mapwho(struct Thing *thing)
     thing->next_on_mapblk = 0;
     thing->prev_on_mapblk = 0;
     thing->alloc_flags &= ~TAlF_IsInMapWho;
+    remove_thing_from_creature_grid(thing);
 }
 
 void place_thing_in_mapwho(struct Thing *thing)
@@ -1363,6 +1384,332 @@ void place_thing_in_mapwho(struct Thing *thing)
     set_mapwho_thing_index(mapblk, thing->index);
     thing->prev_on_mapblk = 0;
     thing->alloc_flags |= TAlF_IsInMapWho;
+    mark_thing_sync_hash_dirty(thing);
+    if (thing->class_id == TCls_Creature) {
+        place_thing_in_creature_grid(thing);
+    }
+}
+
+static long creature_grid_cell_index(MapSubtlCoord stl_x, MapSubtlCoord stl_y)
+{
+    long cell_x = stl_x / CREATURE_GRID_CELL_STL;
+    long cell_y = stl_y / CREATURE_GRID_CELL_STL;
+    if (cell_x < 0) cell_x = 0;
+    if (cell_x >= CREATURE_GRID_CELLS_X) cell_x = CREATURE_GRID_CELLS_X-1;
+    if (cell_y < 0) cell_y = 0;
+    if (cell_y >= CREATURE_GRID_CELLS_Y) cell_y = CREATURE_GRID_CELLS_Y-1;
+    return cell_y * CREATURE_GRID_CELLS_X + cell_x;
+}
+
+/**
+ * Adds creature to the grid cell matching its current map position.
+ * The grid mirrors mapwho for creatures, so it's called when a creature is placed in mapwho.
+ * @param thing The creature thing.
+ */
+void place_thing_in_creature_grid(struct Thing *thing)
+{
+    if (crgrid_cell[thing->index] != 0) {
+        remove_thing_from_creature_grid(thing);
+    }
+    long cell = creature_grid_cell_index(thing->mappos.x.stl.num, thing->mappos.y.stl.num);
+    ThingIndex nxt_idx = crgrid_head[cell];
+    crgrid_prev[thing->index] = 0;
+    crgrid_next[thing->index] = nxt_idx;
+    if (nxt_idx > 0) {
+        crgrid_prev[nxt_idx] = thing->index;
+    }
+    crgrid_head[cell] = thing->index;
+    crgrid_cell[thing->index] = cell + 1;
+    if (thing->clipbox_size_xy > crgrid_max_clipbox) {
+        crgrid_max_clipbox = thing->clipbox_size_xy;
+    }
+}
+
+void remove_thing_from_creature_grid(struct Thing *thing)
+{
+    long cell = crgrid_cell[thing->index];
+    if (cell == 0) {
+        return;
+    }
+    cell--;
+    ThingIndex prv_idx = crgrid_prev[thing->index];
+    ThingIndex nxt_idx = crgrid_next[thing->index];
+    if (prv_idx > 0) {
+        crgrid_next[prv_idx] = nxt_idx;
+    } else {
+        crgrid_head[cell] = nxt_idx;
+    }
+    if (nxt_idx > 0) {
+        crgrid_prev[nxt_idx] = prv_idx;
+    }
+    crgrid_next[thing->index] = 0;
+    crgrid_prev[thing->index] = 0;
+    crgrid_cell[thing->index] = 0;
+}
+
+void clear_creature_grid(void)
+{
+    LbMemorySet(crgrid_head, 0, sizeof(crgrid_head));
+    LbMemorySet(crgrid_next, 0, sizeof(crgrid_next));
+    LbMemorySet(crgrid_prev, 0, sizeof(crgrid_prev));
+    LbMemorySet(crgrid_cell, 0, sizeof(crgrid_cell));
+    crgrid_max_clipbox = 0;
+}
+
+/**
+ * Re-creates the creature grid and list order sequence from things data.
+ * Needs to be called whenever things are restored without using mapwho functions, ie. after loading a game.
+ */
+void rebuild_creature_grid(void)
+{
+    SYNCDBG(8,"Starting");
+    clear_creature_grid();
+    const struct StructureList* slist = get_list_for_thing_class(TCls_Creature);
+    unsigned long seq = slist->count;
+    thing_list_seq_last = seq;
+    unsigned long k = 0;
+    long i = slist->index;
+    while (i != 0)
+    {
+        struct Thing* thing = thing_get(i);
+        if (thing_is_invalid(thing))
+        {
+            ERRORLOG("Jump to invalid thing detected");
+            break;
+        }
+        i = thing->next_of_class;
+        // Per-thing code
+        thing_list_seq[thing->index] = seq;
+        if (seq > 0) seq--;
+        if ((thing->alloc_flags & TAlF_IsInMapWho) != 0) {
+            place_thing_in_creature_grid(thing);
+        }
+        // Per-thing code ends
+        k++;
+        if (k > THINGS_COUNT)
+        {
+            ERRORLOG("Infinite loop detected when sweeping things list");
+            break;
+        }
+    }
+}
+
+/**
+ * Adds creatures from grid cells within given rectangle to the candidates buffer.
+ * @return Amount of candidates in the buffer after adding.
+ */
+static long creature_grid_gather_cells(long cell_beg_x, long cell_beg_y, long cell_end_x, long cell_end_y, long cand_count)
+{
+    for (long cell_y = cell_beg_y; cell_y <= cell_end_y; cell_y++)
+    {
+        for (long cell_x = cell_beg_x; cell_x <= cell_end_x; cell_x++)
+        {
+            unsigned long k = 0;
+            long i = crgrid_head[cell_y * CREATURE_GRID_CELLS_X + cell_x];
+            while (i != 0)
+            {
+                if (cand_count >= THINGS_COUNT)
+                {
+                    ERRORLOG("Infinite loop detected when sweeping creature grid");
+                    return cand_count;
+                }
+                crgrid_cand_index[cand_count] = i;
+                cand_count++;
+                i = crgrid_next[i];
+                k++;
+                if (k > THINGS_COUNT)
+                {
+                    ERRORLOG("Infinite loop detected when sweeping creature grid");
+                    break;
+                }
+            }
+        }
+    }
+    return cand_count;
+}
+
+/**
+ * Selects a thing from gathered candidates, in exactly the same way get_nth_thing_of_class_with_filter() does.
+ * Candidates are sorted into class list order first, so that ties are resolved the same way.
+ * Filter values are expected to be already computed.
+ */
+static struct Thing *creature_grid_select_nth_candidate(long cand_count, long tngindex)
+{
+    // Insertion sort by list order; the amount of candidates is usually small
+    for (long n = 1; n < cand_count; n++)
+    {
+        ThingIndex tng_idx = crgrid_cand_index[n];
+        long value = crgrid_cand_value[n];
+        long k = n - 1;
+        while ((k >= 0) && (thing_list_seq[crgrid_cand_index[k]] < thing_list_seq[tng_idx]))
+        {
+            crgrid_cand_index[k+1] = crgrid_cand_index[k];
+            crgrid_cand_value[k+1] = crgrid_cand_value[k];
+            k--;
+        }
+        crgrid_cand_index[k+1] = tng_idx;
+        crgrid_cand_value[k+1] = value;
+    }
+    long maximizer = 0;
+    long curindex = 0;
+    struct Thing* retng = INVALID_THING;
+    for (long n = 0; n < cand_count; n++)
+    {
+        struct Thing* thing = thing_get(crgrid_cand_index[n]);
+        long value = crgrid_cand_value[n];
+        if (value > maximizer)
+        {
+            retng = thing;
+            maximizer = value;
+            curindex = 0;
+        } else
+        if (value == maximizer)
+        {
+            if (curindex <= tngindex) {
+                retng = thing;
+            }
+            if ((maximizer == LONG_MAX) && (curindex >= tngindex)) {
+                break;
+            }
+            curindex++;
+        }
+    }
+    return retng;
+}
+
+/**
+ * Returns creature selected by filter function, searching only creatures within given range.
+ * Gives the same result as get_nth_thing_of_class_with_filter(), as long as the filter
+ * returns negative value for every creature further than range from given position.
+ * The filter cannot rely on maximizer parameter, as it will receive zero.
+ *
+ * @param pos Position around which creatures are searched.
+ * @param range Max distance in each axis from given position.
+ * @param filter The filter function.
+ * @param param Parameters for the filter function, class_id is ignored.
+ * @param tngindex Index of the thing to select if more of them have the same filter value.
+ */
+struct Thing *get_nth_creature_in_range_with_filter(const struct Coord3d *pos, MapCoordDelta range, Thing_Maximizer_Filter filter, MaxTngFilterParam param, long tngindex)
+{
+    SYNCDBG(19,"Starting");
+    MapSubtlCoord beg_stl_x = coord_subtile(max((long)pos->x.val - range, 0L));
+    MapSubtlCoord beg_stl_y = coord_subtile(max((long)pos->y.val - range, 0L));
+    MapSubtlCoord end_stl_x = coord_subtile(min((long)pos->x.val + range, (long)subtile_coord(gameadd.map_subtiles_x,COORD_PER_STL-1)));
+    MapSubtlCoord end_stl_y = coord_subtile(min((long)pos->y.val + range, (long)subtile_coord(gameadd.map_subtiles_y,COORD_PER_STL-1)));
+    long cell_beg_x = beg_stl_x / CREATURE_GRID_CELL_STL;
+    long cell_beg_y = beg_stl_y / CREATURE_GRID_CELL_STL;
+    long cell_end_x = min(end_stl_x / CREATURE_GRID_CELL_STL, CREATURE_GRID_CELLS_X-1);
+    long cell_end_y = min(end_stl_y / CREATURE_GRID_CELL_STL, CREATURE_GRID_CELLS_Y-1);
+    // If the area covers most of the map, sweeping the list is cheaper
+    long map_cells = (gameadd.map_subtiles_x / CREATURE_GRID_CELL_STL + 1) * (gameadd.map_subtiles_y / CREATURE_GRID_CELL_STL + 1);
+    if ((range < 0) || (2 * (cell_end_x - cell_beg_x + 1) * (cell_end_y - cell_beg_y + 1) > map_cells))
+    {
+        param->class_id = TCls_Creature;
+        return get_nth_thing_of_class_with_filter(filter, param, tngindex);
+    }
+    long cand_count = creature_grid_gather_cells(cell_beg_x, cell_beg_y, cell_end_x, cell_end_y, 0);
+    long n = 0;
+    for (long i = 0; i < cand_count; i++)
+    {
+        long value = filter(thing_get(crgrid_cand_index[i]), param, 0);
+        // Negative values never affect the selection, so don't store them
+        if (value >= 0)
+        {
+            crgrid_cand_index[n] = crgrid_cand_index[i];
+            crgrid_cand_value[n] = value;
+            n++;
+        }
+    }
+    return creature_grid_select_nth_candidate(n, tngindex);
+}
+
+/**
+ * Returns creature selected by filter function which prefers things near to given position.
+ * Gives the same result as get_nth_thing_of_class_with_filter(), as long as the filter
+ * returns either negative value or LONG_MAX decreased by 2D distance of the thing from given position.
+ * The search visits grid cells in growing squares, and stops when no further creature can be nearer.
+ *
+ * @param pos Position from which distance is computed by the filter.
+ * @param filter The filter function.
+ * @param param Parameters for the filter function, class_id is ignored.
+ * @param tngindex Index of the thing to select if more of them have the same filter value.
+ */
+struct Thing *get_nth_creature_nearest_with_filter(const struct Coord3d *pos, Thing_Maximizer_Filter filter, MaxTngFilterParam param, long tngindex)
+{
+    SYNCDBG(19,"Starting");
+    const struct StructureList* slist = get_list_for_thing_class(TCls_Creature);
+    long last_cell_x = min(gameadd.map_subtiles_x / CREATURE_GRID_CELL_STL, CREATURE_GRID_CELLS_X-1);
+    long last_cell_y = min(gameadd.map_subtiles_y / CREATURE_GRID_CELL_STL, CREATURE_GRID_CELLS_Y-1);
+    long cell_x = min(pos->x.stl.num / CREATURE_GRID_CELL_STL, last_cell_x);
+    long cell_y = min(pos->y.stl.num / CREATURE_GRID_CELL_STL, last_cell_y);
+    long cand_count = 0;
+    long n = 0;
+    long cells_visited = 0;
+    long best_value = -1;
+    for (long ring = 0; ; ring++)
+    {
+        long cell_beg_x = cell_x - ring;
+        long cell_beg_y = cell_y - ring;
+        long cell_end_x = cell_x + ring;
+        long cell_end_y = cell_y + ring;
+        if ((cell_beg_x < 0) && (cell_beg_y < 0) && (cell_end_x > last_cell_x) && (cell_end_y > last_cell_y)) {
+            break;
+        }
+        // Visiting many empty cells is more expensive than sweeping the list
+        if (cells_visited > (long)slist->count)
+        {
+            param->class_id = TCls_Creature;
+            return get_nth_thing_of_class_with_filter(filter, param, tngindex);
+        }
+        // Gather the border of the square; each row and column only if it is within map
+        if (cell_beg_y >= 0) {
+            cand_count = creature_grid_gather_cells(max(cell_beg_x,0L), cell_beg_y, min(cell_end_x,last_cell_x), cell_beg_y, cand_count);
+        }
+        if ((cell_end_y <= last_cell_y) && (ring > 0)) {
+            cand_count = creature_grid_gather_cells(max(cell_beg_x,0L), cell_end_y, min(cell_end_x,last_cell_x), cell_end_y, cand_count);
+        }
+        if ((cell_beg_x >= 0) && (ring > 0)) {
+            cand_count = creature_grid_gather_cells(cell_beg_x, max(cell_beg_y+1,0L), cell_beg_x, min(cell_end_y-1,last_cell_y), cand_count);
+        }
+        if ((cell_end_x <= last_cell_x) && (ring > 0)) {
+            cand_count = creature_grid_gather_cells(cell_end_x, max(cell_beg_y+1,0L), cell_end_x, min(cell_end_y-1,last_cell_y), cand_count);
+        }
+        cells_visited += 8 * ring + 1;
+        for (; n < cand_count; n++)
+        {
+            crgrid_cand_value[n] = filter(thing_get(crgrid_cand_index[n]), param, 0);
+            if (crgrid_cand_value[n] > best_value)
+                best_value = crgrid_cand_value[n];
+        }
+        if (best_value < 0) {
+            continue;
+        }
+        // Compute the distance from pos to nearest unvisited cell; creatures there can't be nearer
+        MapCoordDelta bound = LONG_MAX;
+        if (cell_beg_x > 0)
+            bound = min(bound, (long)pos->x.val - subtile_coord(cell_beg_x * CREATURE_GRID_CELL_STL,0) + 1);
+        if (cell_beg_y > 0)
+            bound = min(bound, (long)pos->y.val - subtile_coord(cell_beg_y * CREATURE_GRID_CELL_STL,0) + 1);
+        if (cell_end_x < last_cell_x)
+            bound = min(bound, (long)subtile_coord((cell_end_x + 1) * CREATURE_GRID_CELL_STL,0) - pos->x.val);
+        if (cell_end_y < last_cell_y)
+            bound = min(bound, (long)subtile_coord((cell_end_y + 1) * CREATURE_GRID_CELL_STL,0) - pos->y.val);
+        if (LONG_MAX - best_value < bound) {
+            break;
+        }
+    }
+    // Drop the candidates which can't be selected
+    n = 0;
+    for (long i = 0; i < cand_count; i++)
+    {
+        if (crgrid_cand_value[i] >= 0)
+        {
+            crgrid_cand_index[n] = crgrid_cand_index[i];
+            crgrid_cand_value[n] = crgrid_cand_value[i];
+            n++;
+        }
+    }
+    return creature_grid_select_nth_candidate(n, tngindex);
 }
 
 struct Thing *find_base_thing_on_mapwho(ThingClass oclass, ThingModel model, MapSubtlCoord stl_x, MapSubtlCoord stl_y)
@@ -1776,7 +2123,7 @@ struct Thing *get_nearest_enemy_creature_possible_to_attack_by(struct Thing *cre
     param.num1 = creatng->index;
     param.num2 = -1;
     param.num3 = -1;
-    return get_nth_thing_of_class_with_filter(filter, &param, 0);
+    return get_nth_creature_nearest_with_filter(&creatng->mappos, filter, &param, 0);
 }
 
 struct Thing* get_nearest_enemy_object_possible_to_attack_by(struct Thing* creatng)
@@ -1804,7 +2151,12 @@ struct Thing *get_highest_score_enemy_creature_within_distance_possible_to_attac
     param.num1 = creatng->index;
     param.num2 = dist;
     param.num3 = move_on_ground;
-    return get_nth_thing_of_class_with_filter(filter, &param, 0);
+    // Combat distance is reduced by clipbox sizes, so extend the range to include any creature which could pass
+    MapCoordDelta range = -1;
+    if (dist < LONG_MAX/2) {
+        range = dist + (creatng->clipbox_size_xy + crgrid_max_clipbox) / 2;
+    }
+    return get_nth_creature_in_range_with_filter(&creatng->mappos, range, filter, &param, 0);
 }
 
 struct Thing *get_random_trap_of_model_owned_by_and_armed(ThingModel tngmodel, PlayerNumber plyr_idx, TbBool armed)
@@ -2153,7 +2505,7 @@ long do_to_players_all_creatures_of_model(PlayerNumber plyr_idx, int crmodel, Th
  *
  * @return Count of players creatures.
  */
-long count_player_creatures_of_model(PlayerNumber plyr_idx, int crmodel)
+static long count_player_creatures_of_model_sweep(PlayerNumber plyr_idx, int crmodel)
 {
     SYNCDBG(19,"Starting");
     struct Dungeon* dungeon = get_players_num_dungeon(plyr_idx);
@@ -2184,6 +2536,46 @@ long count_player_creatures_of_model(PlayerNumber plyr_idx, int crmodel)
     return count;
 }
 
+/**
+ * Counts creatures of given model owned by given player, using the creature list counters.
+ * @param plyr_idx Player whose creatures are counted.
+ * @param crmodel Creature model, or CREATURE_ANY for all, or CREATURE_NOT_A_DIGGER for all except special diggers, CREATURE_DIGGER for special diggers only.
+ */
+long count_player_creatures_of_model(PlayerNumber plyr_idx, int crmodel)
+{
+    SYNCDBG(19,"Starting");
+    struct Dungeon* dungeon = get_players_num_dungeon(plyr_idx);
+    long count = 0;
+    if (dungeon_invalid(dungeon))
+    {
+        // Invalid dungeon - list of creatures not associated to any dungeon only has neutral creatures
+        if (plyr_idx != game.neutral_player_num) {
+            return count_player_creatures_of_model_sweep(plyr_idx, crmodel);
+        }
+        count = get_creature_list_model_count(plyr_idx, CrLst_NoDungeon, (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel);
+    } else
+    {
+        TbBool is_spec_digger = (crmodel > 0) && creature_kind_is_for_dungeon_diggers_list(plyr_idx, crmodel);
+        if (((crmodel > 0) && (!is_creature_model_wildcard(crmodel)) && !is_spec_digger) ||
+            (crmodel == CREATURE_ANY) || (crmodel == CREATURE_NOT_A_DIGGER))
+        {
+            count += get_creature_list_model_count(plyr_idx, CrLst_Creatures, (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel);
+        }
+        if (((crmodel > 0) && (!is_creature_model_wildcard(crmodel)) && is_spec_digger) ||
+            (crmodel == CREATURE_ANY) || (crmodel == CREATURE_DIGGER))
+        {
+            count += get_creature_list_model_count(plyr_idx, CrLst_Diggers, (is_creature_model_wildcard(crmodel)) ? CREATURE_ANY : crmodel);
+        }
+    }
+#if (BFDEBUG_LEVEL > 7)
+    long sweep_count = count_player_creatures_of_model_sweep(plyr_idx, crmodel);
+    if (count != sweep_count) {
+        ERRORLOG("Creature list counters for player %d model %d give %ld, but there are %ld creatures",(int)plyr_idx,(int)crmodel,count,sweep_count);
+    }
+#endif
+    return count;
+}
+
 long count_player_creatures_of_model_in_action_point(PlayerNumber plyr_idx, int crmodel, long apt_index)
 {
     struct ActionPoint* apt = action_point_get(apt_index);
@@ -2227,7 +2619,7 @@ long count_player_creatures_of_model_in_action_point(PlayerNumber plyr_idx, int
     return count;
 }
 
-long count_player_list_creatures_of_model(long thing_idx, ThingModel crmodel)
+static long count_player_list_creatures_of_model_sweep(long thing_idx, ThingModel crmodel)
 {
     int count = 0;
     long i = thing_idx;
@@ -2258,6 +2650,47 @@ long count_player_list_creatures_of_model(long thing_idx, ThingModel crmodel)
     return count;
 }
 
+/**
+ * Counts creatures of given model on a players creature list.
+ * If the list is one of the dungeon lists, the creature list counters are used instead of sweeping it.
+ * @param thing_idx Index of the first thing on the list.
+ * @param crmodel Creature model, or CREATURE_ANY.
+ */
+long count_player_list_creatures_of_model(long thing_idx, ThingModel crmodel)
+{
+    if (thing_idx == 0) {
+        return 0;
+    }
+    struct Thing* thing = thing_get(thing_idx);
+    if (thing_is_invalid(thing)) {
+        return count_player_list_creatures_of_model_sweep(thing_idx, crmodel);
+    }
+    long count;
+    struct Dungeon* dungeon = INVALID_DUNGEON;
+    if (thing->owner < DUNGEONS_COUNT) {
+        dungeon = get_dungeon(thing->owner);
+    }
+    if (thing_idx == game.nodungeon_creatr_list_start) {
+        count = get_creature_list_model_count(thing->owner, CrLst_NoDungeon, crmodel);
+    } else
+    if (!dungeon_invalid(dungeon) && (thing_idx == dungeon->creatr_list_start)) {
+        count = get_creature_list_model_count(thing->owner, CrLst_Creatures, crmodel);
+    } else
+    if (!dungeon_invalid(dungeon) && (thing_idx == dungeon->digger_list_start)) {
+        count = get_creature_list_model_count(thing->owner, CrLst_Diggers, crmodel);
+    } else {
+        // Not a head of any known list - just sweep it
+        return count_player_list_creatures_of_model_sweep(thing_idx, crmodel);
+    }
+#if (BFDEBUG_LEVEL > 7)
+    long sweep_count = count_player_list_creatures_of_model_sweep(thing_idx, crmodel);
+    if (count != sweep_count) {
+        ERRORLOG("Creature list counters for list at %d model %d give %ld, but there are %ld creatures",(int)thing_idx,(int)crmodel,count,sweep_count);
+    }
+#endif
+    return count;
+}
+
 long count_player_list_creatures_of_model_on_territory(long thing_idx, ThingModel crmodel, int friendly)
 {
     int count = 0;
@@ -3024,6 +3457,8 @@ long do_to_things_with_param_spiral_near_map_block(const struct Coord3d *center_
         struct MapOffset* sstep = &spiral_step[around_val];
         MapSubtlCoord sx = coord_subtile(center_pos->x.val) + sstep->h;
         MapSubtlCoord sy = coord_subtile(center_pos->y.val) + sstep->v;
+        if (!subtile_has_mapwho_things(sx, sy))
+            continue;
         SYNCDBG(18,"Doing on (%d,%d)",(int)sx,(int)sy);
         struct Map* mapblk = get_map_block_at(sx, sy);
         if (!map_block_invalid(mapblk))
@@ -3130,6 +3565,7 @@ TbBool update_thing(struct Thing *thing)
             if (thing->veloc_base.y.val != 0)
               thing->veloc_base.y.val = thing->veloc_base.y.val * (256 - (int)thing->inertia_floor) / 256;
             thing->mappos.z.val = thing->floor_height;
+            mark_thing_sync_hash_dirty(thing);
             if ((thing->movement_flags & TMvF_Unknown08) != 0)
             {
               thing->veloc_base.z.val = 0;
@@ -30,7 +30,12 @@ extern "C" {
 
 /******************************************************************************/
 #define THING_CLASSES_COUNT    14
-#define THINGS_COUNT         8192
+/** Amount of thing slots currently available; grows by pages, up to THINGS_COUNT_MAX. */
+#define THINGS_COUNT         (game.things.pages_count*THINGS_PAGE_SIZE)
+/** Size of creature grid cell, in subtiles. */
+#define CREATURE_GRID_CELL_STL    8
+#define CREATURE_GRID_CELLS_X  ((MAX_SUBTILES_X+CREATURE_GRID_CELL_STL)/CREATURE_GRID_CELL_STL)
+#define CREATURE_GRID_CELLS_Y  ((MAX_SUBTILES_Y+CREATURE_GRID_CELL_STL)/CREATURE_GRID_CELL_STL)
 
 enum ThingClassIndex {
     TCls_Empty        =  0,
@@ -177,8 +182,12 @@ struct StructureList {
 };
 
 struct Things {
-    struct Thing *lookup[THINGS_COUNT];
-    struct Thing *end;
+    /** Amount of pages allocated in things storage. */
+    unsigned short pages_count;
+    /** First thing in free things list; 0 if all slots in allocated pages are in use. */
+    ThingIndex free_head;
+    /** Amount of things which are currently allocated. */
+    ThingIndex used_count;
 };
 
 
@@ -306,6 +315,13 @@ struct Thing *find_base_thing_on_mapwho(ThingClass oclass, ThingModel okind, Map
 void remove_thing_from_mapwho(struct Thing *thing);
 void place_thing_in_mapwho(struct Thing *thing);
 
+void place_thing_in_creature_grid(struct Thing *thing);
+void remove_thing_from_creature_grid(struct Thing *thing);
+void clear_creature_grid(void);
+void rebuild_creature_grid(void);
+struct Thing *get_nth_creature_in_range_with_filter(const struct Coord3d *pos, MapCoordDelta range, Thing_Maximizer_Filter filter, MaxTngFilterParam param, long tngindex);
+struct Thing *get_nth_creature_nearest_with_filter(const struct Coord3d *pos, Thing_Maximizer_Filter filter, MaxTngFilterParam param, long tngindex);
+
 struct Thing *find_hero_gate_of_number(long num);
 long get_free_hero_gate_number(void);
 
@@ -31,6 +31,7 @@
 #include "config_creature.h"
 #include "config_crtrstates.h"
 #include "map_blocks.h"
+#include "net_sync.h"
 #include "thing_list.h"
 #include "thing_objects.h"
 #include "thing_stats.h"
@@ -313,6 +314,7 @@ void move_thing_in_map_f(struct Thing *thing, const struct Coord3d *pos, const c
         place_thing_in_mapwho(thing);
     }
     thing->floor_height = get_thing_height_at(thing, &thing->mappos);
+    mark_thing_sync_hash_dirty(thing);
 }
 
 TbBool move_creature_to_nearest_valid_position(struct Thing *thing)
@@ -432,6 +434,7 @@ long creature_turn_to_face_angle(struct Thing *thing, long angle)
     }
 
     thing->move_angle_xy = (thing->move_angle_xy + angle_delta) & LbFPMath_AngleMask;
+    mark_thing_sync_hash_dirty(thing);
 
     return get_angle_difference(thing->move_angle_xy, angle);
 }
@@ -40,6 +40,7 @@
 #include "player_instances.h"
 #include "map_data.h"
 #include "map_columns.h"
+#include "net_sync.h"
 #include "map_utils.h"
 #include "magic.h"
 #include "room_entrance.h"
@@ -479,6 +480,7 @@ void change_object_owner(struct Thing *objtng, PlayerNumber nowner)
     //TODO make this function more advanced - switch object types and update dungeon and rooms for spellbook/workshop box/lair
     SYNCDBG(6,"Starting for %s, owner %d to %d",thing_model_name(objtng),(int)objtng->owner,(int)nowner);
     objtng->owner = nowner;
+    mark_thing_sync_hash_dirty(objtng);
 }
 
 struct Objects *get_objects_data_for_thing(struct Thing *thing)
@@ -965,6 +967,7 @@ static long food_moves(struct Thing *objtng)
         if (dangle > 62)
             dangle = 62;
         objtng->move_angle_xy = (objtng->move_angle_xy + dangle * sangle) & LbFPMath_AngleMask;
+        mark_thing_sync_hash_dirty(objtng);
         if (get_angle_difference(objtng->move_angle_xy, objtng->food.angle) < 284)
         {
             struct ComponentVector cvec;
@@ -1592,6 +1595,7 @@ static TngUpdateRet object_update_armour(struct Thing *objtng)
     {
         pos.z.val += (thing->clipbox_size_yz >> 1);
         objtng->move_angle_xy = get_angle_xy_to(&objtng->mappos, &pos);
+        mark_thing_sync_hash_dirty(objtng);
         objtng->move_angle_z = get_angle_yz_to(&objtng->mappos, &pos);
         angles_to_vector(objtng->move_angle_xy, objtng->move_angle_z, 32, &cvect);
         long cvect_len = LbSqrL(cvect.x * cvect.x + cvect.z * cvect.z + cvect.y * cvect.y);
@@ -1722,7 +1726,7 @@ static TngUpdateRet object_update_power_sight(struct Thing *objtng)
                 pos.x.val = objtng->mappos.x.val + ((radius * LbSinL(angle)) / 8192);
                 pos.y.val = objtng->mappos.y.val + ((radius * LbCosL(angle)) / 8192);
                 pos.z.val = 1408;
-                create_effect_element(&pos, twinkle_eff_elements[objtng->owner], objtng->owner);
+                create_cosmetic_effect_element(&pos, twinkle_eff_elements[objtng->owner], objtng->owner);
             }
             return 1;
         }
@@ -1744,7 +1748,7 @@ static TngUpdateRet object_update_power_sight(struct Thing *objtng)
             pos.x.val = pos_x;
             pos.y.val = pos_y;
             pos.z.val = 1408;
-            create_effect_element(&pos, twinkle_eff_elements[objtng->owner], objtng->owner);
+            create_cosmetic_effect_element(&pos, twinkle_eff_elements[objtng->owner], objtng->owner);
             if ( pos_x >= 0 && pos_x < gameadd.map_subtiles_x * COORD_PER_STL && pos_y >= 0 && pos_y < gameadd.map_subtiles_y * COORD_PER_STL ) {
                 const int shift_x = pos.x.stl.num - objtng->mappos.x.stl.num + 13;
                 const int shift_y = pos.y.stl.num - objtng->mappos.y.stl.num + 13;
@@ -1772,7 +1776,7 @@ static TngUpdateRet object_update_power_lightning(struct Thing *objtng)
             if ((mapblk->flags & SlbAtFlg_Blocking) == 0)
             {
                 pos.z.val = get_floor_height_at(&pos) + 128;
-                create_effect_element(&pos, lightning_spangles[objtng->owner], objtng->owner);
+                create_cosmetic_effect_element(&pos, lightning_spangles[objtng->owner], objtng->owner);
             }
         }
         variation++;
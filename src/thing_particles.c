@@ -0,0 +1,388 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file thing_particles.c
+ *     Cosmetic effect element particles support functions.
+ * @par Purpose:
+ *     Keeps decorative effect elements outside of the things array, in
+ *     a buffer of their own which is updated in flat passes.
+ * @par Comment:
+ *     Particles never affect the game state. They aren't saved, aren't part
+ *     of sync checksums, and consume the synced RNG exactly like effect
+ *     element things do when created.
+ * @author   KeeperFX Team
+ * @date     18 Oct 2026 - 18 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#include "pre_inc.h"
+#include "thing_particles.h"
+
+#include "globals.h"
+#include "bflib_basics.h"
+#include "bflib_memory.h"
+#include "bflib_math.h"
+
+#include "thing_data.h"
+#include "thing_effects.h"
+#include "thing_physics.h"
+#include "creature_graphics.h"
+#include "engine_arrays.h"
+#include "map_data.h"
+#include "game_legacy.h"
+#include "keeperfx.hpp"
+#include "post_inc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/******************************************************************************/
+/** Amount of particles in use; they occupy indices 1..particles_count. */
+static long particles_count;
+
+// Values updated every turn, kept in separate arrays so update passes stay linear
+static long particle_health[EFFECT_PARTICLES_COUNT];
+static long particle_anim_time[EFFECT_PARTICLES_COUNT];
+static short particle_anim_speed[EFFECT_PARTICLES_COUNT];
+static unsigned char particle_max_frames[EFFECT_PARTICLES_COUNT];
+static unsigned char particle_current_frame[EFFECT_PARTICLES_COUNT];
+static unsigned short particle_sprite_size[EFFECT_PARTICLES_COUNT];
+static char particle_transformation_speed[EFFECT_PARTICLES_COUNT];
+static unsigned short particle_sprite_size_min[EFFECT_PARTICLES_COUNT];
+static unsigned short particle_sprite_size_max[EFFECT_PARTICLES_COUNT];
+static unsigned char particle_rendering_flags[EFFECT_PARTICLES_COUNT];
+static unsigned char particle_field_50[EFFECT_PARTICLES_COUNT];
+static GameTurn particle_creation_turn[EFFECT_PARTICLES_COUNT];
+
+// Values which only drawing needs
+static struct Coord3d particle_mappos[EFFECT_PARTICLES_COUNT];
+static unsigned short particle_anim_sprite[EFFECT_PARTICLES_COUNT];
+static ThingModel particle_model[EFFECT_PARTICLES_COUNT];
+static PlayerNumber particle_owner[EFFECT_PARTICLES_COUNT];
+
+// Per subtile lists, the particles equivalent of mapwho
+static SubtlCodedCoords particle_stl_num[EFFECT_PARTICLES_COUNT];
+static ParticleIndex particle_next_on_mapblk[EFFECT_PARTICLES_COUNT];
+static ParticleIndex particle_prev_on_mapblk[EFFECT_PARTICLES_COUNT];
+static ParticleIndex particle_mapwho[MAX_SUBTILES_X*MAX_SUBTILES_Y];
+
+/** Things filled when particles are drawn; the drawlist keeps pointers to them until the frame is rendered. */
+static struct Thing particle_draw_things[EFFECT_PARTICLES_COUNT];
+/******************************************************************************/
+/**
+ * Returns if effect elements of given model can live in the particles buffer.
+ * These are elements which never move, emit no light, spawn nothing and aren't
+ * looked for by the game logic; their whole life is a fixed animation.
+ * Model 46 is searched for in mapwho by gameplay code, so it must stay a thing.
+ */
+TbBool effect_element_model_is_particle(ThingModel eelmodel)
+{
+    if ((eelmodel == 0) || (eelmodel == 46))
+        return false;
+    struct EffectElementStats* eestat = get_effect_element_model_stats(eelmodel);
+    if ((eestat->sprite_idx <= 0) || (eestat->draw_class != 2))
+        return false;
+    if ((eestat->field_1 != 5) || (eestat->field_2 == 1) || (eestat->field_15 != 0))
+        return false;
+    return ((eestat->subeffect_delay == 0) && (eestat->transform_model == 0) && (eestat->field_3A == 0));
+}
+
+static SubtlCodedCoords get_particle_stl_num_at_mapblk(const struct Map *mapblk)
+{
+    if ((mapblk < &game.map[0]) || (mapblk >= &game.map[MAX_SUBTILES_X*MAX_SUBTILES_Y]))
+        return -1;
+    return mapblk - &game.map[0];
+}
+
+static void place_particle_in_mapwho(ParticleIndex part_idx, SubtlCodedCoords stl_num)
+{
+    particle_stl_num[part_idx] = stl_num;
+    particle_prev_on_mapblk[part_idx] = 0;
+    particle_next_on_mapblk[part_idx] = particle_mapwho[stl_num];
+    if (particle_mapwho[stl_num] != 0)
+        particle_prev_on_mapblk[particle_mapwho[stl_num]] = part_idx;
+    particle_mapwho[stl_num] = part_idx;
+}
+
+static void remove_particle_from_mapwho(ParticleIndex part_idx)
+{
+    ParticleIndex prev_idx = particle_prev_on_mapblk[part_idx];
+    ParticleIndex next_idx = particle_next_on_mapblk[part_idx];
+    if (prev_idx != 0)
+        particle_next_on_mapblk[prev_idx] = next_idx;
+    else
+        particle_mapwho[particle_stl_num[part_idx]] = next_idx;
+    if (next_idx != 0)
+        particle_prev_on_mapblk[next_idx] = prev_idx;
+}
+
+/**
+ * Deletes a particle by moving the last one into its slot.
+ * Any index above the deleted one, but the last, stays valid.
+ */
+static void delete_particle(ParticleIndex part_idx)
+{
+    remove_particle_from_mapwho(part_idx);
+    ParticleIndex last_idx = particles_count;
+    particles_count--;
+    if (part_idx == last_idx)
+        return;
+    particle_health[part_idx] = particle_health[last_idx];
+    particle_anim_time[part_idx] = particle_anim_time[last_idx];
+    particle_anim_speed[part_idx] = particle_anim_speed[last_idx];
+    particle_max_frames[part_idx] = particle_max_frames[last_idx];
+    particle_current_frame[part_idx] = particle_current_frame[last_idx];
+    particle_sprite_size[part_idx] = particle_sprite_size[last_idx];
+    particle_transformation_speed[part_idx] = particle_transformation_speed[last_idx];
+    particle_sprite_size_min[part_idx] = particle_sprite_size_min[last_idx];
+    particle_sprite_size_max[part_idx] = particle_sprite_size_max[last_idx];
+    particle_rendering_flags[part_idx] = particle_rendering_flags[last_idx];
+    particle_field_50[part_idx] = particle_field_50[last_idx];
+    particle_creation_turn[part_idx] = particle_creation_turn[last_idx];
+    particle_mappos[part_idx] = particle_mappos[last_idx];
+    particle_anim_sprite[part_idx] = particle_anim_sprite[last_idx];
+    particle_model[part_idx] = particle_model[last_idx];
+    particle_owner[part_idx] = particle_owner[last_idx];
+    // Re-link the moved particle in its subtile list
+    ParticleIndex prev_idx = particle_prev_on_mapblk[last_idx];
+    ParticleIndex next_idx = particle_next_on_mapblk[last_idx];
+    particle_stl_num[part_idx] = particle_stl_num[last_idx];
+    particle_prev_on_mapblk[part_idx] = prev_idx;
+    particle_next_on_mapblk[part_idx] = next_idx;
+    if (prev_idx != 0)
+        particle_next_on_mapblk[prev_idx] = part_idx;
+    else
+        particle_mapwho[particle_stl_num[part_idx]] = part_idx;
+    if (next_idx != 0)
+        particle_prev_on_mapblk[next_idx] = part_idx;
+}
+
+/**
+ * Creates a particle of given effect element model.
+ * Mirrors create_effect_element(), including the random values it draws, so
+ * the synced RNG doesn't depend on whether the particles buffer has space.
+ * @return True if the particle was added, false if it's not visible or there's no space.
+ */
+TbBool create_effect_particle(const struct Coord3d *pos, ThingModel eelmodel, PlayerNumber owner)
+{
+    if (!any_player_close_enough_to_see(pos)) {
+        return false;
+    }
+    struct EffectElementStats* eestat = get_effect_element_model_stats(eelmodel);
+    long size_rand = EFFECT_RANDOM(NULL, eestat->sprite_size_max  - (int)eestat->sprite_size_min  + 1);
+    long speed_rand = EFFECT_RANDOM(NULL, eestat->sprite_speed_max - (int)eestat->sprite_speed_min + 1);
+    unsigned short anim_sprite = convert_td_iso(eestat->sprite_idx);
+    short anim_speed = eestat->sprite_speed_min + speed_rand;
+    long health;
+    if (eestat->numfield_3 > 0)
+    {
+        health = eestat->numfield_3 + EFFECT_RANDOM(NULL, eestat->numfield_5 - (long)eestat->numfield_3 + 1);
+    } else
+    {
+        health = get_lifespan_of_animation(anim_sprite, anim_speed);
+    }
+    if (particles_count+1 >= EFFECT_PARTICLES_COUNT) {
+        SYNCDBG(8,"No free particle slot for effect element %d",(int)eelmodel);
+        return false;
+    }
+    SubtlCodedCoords stl_num = get_subtile_number(coord_subtile(pos->x.val), coord_subtile(pos->y.val));
+    ParticleIndex part_idx = particles_count+1;
+    particles_count++;
+    particle_mappos[part_idx].x.val = pos->x.val;
+    particle_mappos[part_idx].y.val = pos->y.val;
+    particle_mappos[part_idx].z.val = pos->z.val;
+    particle_model[part_idx] = eelmodel;
+    particle_owner[part_idx] = owner;
+    particle_creation_turn[part_idx] = game.play_gameturn;
+    particle_health[part_idx] = health;
+    particle_anim_sprite[part_idx] = anim_sprite;
+    particle_max_frames[part_idx] = keepersprite_frames(anim_sprite);
+    particle_current_frame[part_idx] = 0;
+    particle_anim_time[part_idx] = 0;
+    particle_anim_speed[part_idx] = anim_speed;
+    // Elements which stop animating on floor do that on their first update, and particles never leave their place
+    if (!eestat->field_12 && (pos->z.val == 0))
+        particle_anim_speed[part_idx] = 0;
+    particle_sprite_size[part_idx] = eestat->sprite_size_min + size_rand;
+    particle_rendering_flags[part_idx] = 0;
+    set_flag_byte(&particle_rendering_flags[part_idx], TRF_Unshaded, eestat->unshaded);
+    particle_rendering_flags[part_idx] |= (TRF_Transpar_8 * eestat->transparant) & TRF_Transpar_Flags;
+    set_flag_byte(&particle_rendering_flags[part_idx], TRF_AnimateOnce, eestat->field_D);
+    particle_field_50[part_idx] = (eestat->draw_class << 2);
+    particle_sprite_size_min[part_idx] = 0;
+    particle_sprite_size_max[part_idx] = 0;
+    particle_transformation_speed[part_idx] = 0;
+    if (eestat->field_17 != 0)
+    {
+        particle_sprite_size_min[part_idx] = eestat->sprite_size_min;
+        particle_sprite_size_max[part_idx] = eestat->sprite_size_max;
+        if (eestat->field_17 == 2)
+        {
+            particle_transformation_speed[part_idx] = 2 * (eestat->sprite_size_max - (long)eestat->sprite_size_min) / health;
+            particle_field_50[part_idx] |= 0x02;
+        }
+        else
+        {
+            particle_transformation_speed[part_idx] = (eestat->sprite_size_max - (long)eestat->sprite_size_min) / health;
+        }
+        particle_sprite_size[part_idx] = eestat->sprite_size_min;
+    }
+    place_particle_in_mapwho(part_idx, stl_num);
+    return true;
+}
+
+/**
+ * Updates all particles; equivalent of update_effect_element() and
+ * update_thing_animation() for static effect elements.
+ * Particles created in this turn are skipped, like new things added
+ * to a list which is already being updated.
+ */
+void update_effect_particles(void)
+{
+    SYNCDBG(18,"Starting");
+    const GameTurn turn = game.play_gameturn;
+    const long count = particles_count;
+    long i;
+    // Lifespan; health below zero means the particle is to be deleted
+    for (i = 1; i <= count; i++)
+    {
+        particle_health[i] -= (particle_creation_turn[i] != turn);
+    }
+    // Sprite animation
+    for (i = 1; i <= count; i++)
+    {
+        long period = particle_max_frames[i] << 8;
+        if ((particle_anim_speed[i] == 0) || (period == 0) || (particle_creation_turn[i] == turn))
+            continue;
+        long anim_time = particle_anim_time[i] + particle_anim_speed[i];
+        while (anim_time < 0)
+            anim_time += period;
+        if (anim_time > period-1)
+        {
+            if ((particle_rendering_flags[i] & TRF_AnimateOnce) != 0)
+            {
+                particle_anim_speed[i] = 0;
+                anim_time = period-1;
+            } else
+            {
+                anim_time %= period;
+            }
+        }
+        particle_anim_time[i] = anim_time;
+        particle_current_frame[i] = (anim_time >> 8) & 0xFF;
+    }
+    // Growing and shrinking
+    for (i = 1; i <= count; i++)
+    {
+        if ((particle_transformation_speed[i] == 0) || (particle_creation_turn[i] == turn))
+            continue;
+        particle_sprite_size[i] += particle_transformation_speed[i];
+        if (particle_sprite_size[i] > particle_sprite_size_min[i])
+        {
+            if (particle_sprite_size[i] < particle_sprite_size_max[i])
+                continue;
+            particle_sprite_size[i] = particle_sprite_size_max[i];
+        } else
+        {
+            particle_sprite_size[i] = particle_sprite_size_min[i];
+        }
+        if ((particle_field_50[i] & 0x02) != 0)
+            particle_transformation_speed[i] = -particle_transformation_speed[i];
+        else
+            particle_transformation_speed[i] = 0;
+    }
+    // Deleting from the end, so that moved particles were already checked
+    for (i = count; i > 0; i--)
+    {
+        if (particle_health[i] < 0)
+            delete_particle(i);
+    }
+    SYNCDBG(19,"Finished");
+}
+
+void clear_effect_particles(void)
+{
+    particles_count = 0;
+    LbMemorySet(particle_mapwho, 0, sizeof(particle_mapwho));
+}
+
+long count_effect_particles(void)
+{
+    return particles_count;
+}
+
+/**
+ * Removes particles which ended up inside a wall placed on given subtile.
+ * @return Amount of particles removed.
+ */
+unsigned long remove_effect_particles_in_wall(const struct Map *mapblk)
+{
+    SubtlCodedCoords stl_num = get_particle_stl_num_at_mapblk(mapblk);
+    if (stl_num < 0)
+        return 0;
+    MapSubtlCoord stl_x = stl_num_decode_x(stl_num);
+    MapSubtlCoord stl_y = stl_num_decode_y(stl_num);
+    unsigned long removed_num = 0;
+    ParticleIndex i = particle_mapwho[stl_num];
+    while (i != 0)
+    {
+        ParticleIndex next_idx = particle_next_on_mapblk[i];
+        MapCoord pos_z = particle_mappos[i].z.val;
+        if (map_is_solid_at_height(stl_x, stl_y, pos_z, pos_z + 1))
+        {
+            // The last particle is moved into deleted slot; follow it if it was next
+            if (next_idx == particles_count)
+                next_idx = i;
+            delete_particle(i);
+            removed_num++;
+        }
+        i = next_idx;
+    }
+    return removed_num;
+}
+
+ParticleIndex get_mapwho_particle_index(const struct Map *mapblk)
+{
+    SubtlCodedCoords stl_num = get_particle_stl_num_at_mapblk(mapblk);
+    if (stl_num < 0)
+        return 0;
+    return particle_mapwho[stl_num];
+}
+
+ParticleIndex get_next_particle_on_mapblk(ParticleIndex part_idx)
+{
+    return particle_next_on_mapblk[part_idx];
+}
+
+/**
+ * Fills a thing with drawing properties of given particle.
+ * The thing is outside of things array, so thing_is_invalid() is true for it
+ * and the renderer won't treat it as something the player can interact with.
+ */
+struct Thing *get_particle_draw_thing(ParticleIndex part_idx)
+{
+    struct Thing* thing = &particle_draw_things[part_idx];
+    thing->class_id = TCls_EffectElem;
+    thing->model = particle_model[part_idx];
+    thing->owner = particle_owner[part_idx];
+    thing->index = 0;
+    thing->creation_turn = particle_creation_turn[part_idx];
+    thing->mappos = particle_mappos[part_idx];
+    thing->anim_sprite = particle_anim_sprite[part_idx];
+    thing->anim_speed = particle_anim_speed[part_idx];
+    thing->anim_time = particle_anim_time[part_idx];
+    thing->current_frame = particle_current_frame[part_idx];
+    thing->max_frames = particle_max_frames[part_idx];
+    thing->sprite_size = particle_sprite_size[part_idx];
+    thing->rendering_flags = particle_rendering_flags[part_idx];
+    thing->field_50 = particle_field_50[part_idx];
+    return thing;
+}
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+/******************************************************************************/
+// Free implementation of Bullfrog's Dungeon Keeper strategy game.
+/******************************************************************************/
+/** @file thing_particles.h
+ *     Header file for thing_particles.c.
+ * @par Purpose:
+ *     Cosmetic effect element particles support functions.
+ * @par Comment:
+ *     Just a header file - #defines, typedefs, function prototypes etc.
+ * @author   KeeperFX Team
+ * @date     18 Oct 2026 - 18 Oct 2026
+ * @par  Copying and copyrights:
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU General Public License as published by
+ *     the Free Software Foundation; either version 2 of the License, or
+ *     (at your option) any later version.
+ */
+/******************************************************************************/
+#ifndef DK_TNGPARTICLES_H
+#define DK_TNGPARTICLES_H
+
+#include "globals.h"
+#include "bflib_basics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************/
+/** Amount of particle slots; index 0 is never used, like in things array. */
+#define EFFECT_PARTICLES_COUNT 4096
+
+typedef unsigned short ParticleIndex;
+
+struct Thing;
+struct Map;
+
+/******************************************************************************/
+TbBool effect_element_model_is_particle(ThingModel eelmodel);
+TbBool create_effect_particle(const struct Coord3d *pos, ThingModel eelmodel, PlayerNumber owner);
+void update_effect_particles(void);
+void clear_effect_particles(void);
+long count_effect_particles(void);
+unsigned long remove_effect_particles_in_wall(const struct Map *mapblk);
+
+ParticleIndex get_mapwho_particle_index(const struct Map *mapblk);
+ParticleIndex get_next_particle_on_mapblk(ParticleIndex part_idx);
+struct Thing *get_particle_draw_thing(ParticleIndex part_idx);
+/******************************************************************************/
+#ifdef __cplusplus
+}
+#endif
+#endif
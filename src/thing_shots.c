@@ -46,6 +46,7 @@
 #include "game_legacy.h"
 #include "engine_lenses.h"
 
+#include "net_sync.h"
 #include "keeperfx.hpp"
 #include "post_inc.h"
 
@@ -765,7 +766,7 @@ static TbBool shot_hit_trap_at(struct Thing* shotng, struct Thing* target, struc
     create_relevant_effect_for_shot_hitting_thing(shotng, target);
     if (target->health < 0) 
     {
-        create_effect_element(&target->mappos, TngEffElm_Blast2, target->owner);
+        create_cosmetic_effect_element(&target->mappos, TngEffElm_Blast2, target->owner);
         struct TrapConfigStats* trapst = get_trap_model_stats(target->model);
         if (((trapst->unstable == 1) && !(shotst->model_flags & ShMF_Disarming)) || trapst->unstable == 2)
         {
@@ -1062,6 +1063,7 @@ void set_thing_acceleration_angles(struct Thing *thing, long angle_xy, long angl
 {
     thing->move_angle_xy = angle_xy;
     thing->move_angle_z = angle_yz;
+    mark_thing_sync_hash_dirty(thing);
     struct ComponentVector cvect;
     angles_to_vector(thing->move_angle_xy, thing->move_angle_z, 256, &cvect);
     thing->veloc_base.x.val = cvect.x;
@@ -1498,6 +1500,7 @@ TngUpdateRet update_shot(struct Thing *thing)
                 pos2.z.val = target->mappos.z.val;
                 pos2.z.val += (target->clipbox_size_yz >> 1);
                 thing->move_angle_xy = get_angle_xy_to(&thing->mappos, &pos2);
+                mark_thing_sync_hash_dirty(thing);
                 thing->move_angle_z = get_angle_yz_to(&thing->mappos, &pos2);
                 angles_to_vector(thing->move_angle_xy, thing->move_angle_z, shotst->speed, &cvect);
                 dtpos.x.val = cvect.x - thing->veloc_base.x.val;
@@ -1548,7 +1551,7 @@ TngUpdateRet update_shot(struct Thing *thing)
                     }
                     if (shotst->visual.effect_model < 0)
                     {
-                        create_effect_element(&pos1, ~(shotst->visual.effect_model) + 1, thing->owner);
+                        create_cosmetic_effect_element(&pos1, ~(shotst->visual.effect_model) + 1, thing->owner);
                     }
                 }
             }
@@ -1577,6 +1580,7 @@ TngUpdateRet update_shot(struct Thing *thing)
             break;
         case ShM_Grenade:
             thing->move_angle_xy = (thing->move_angle_xy + LbFPMath_PI/9) & LbFPMath_AngleMask;
+            mark_thing_sync_hash_dirty(thing);
             break;
         case ShM_GodLightning:
             draw_god_lightning(thing);
@@ -1589,6 +1593,7 @@ TngUpdateRet update_shot(struct Thing *thing)
             **/
         case ShM_Lizard:
             thing->move_angle_xy = (thing->move_angle_xy + LbFPMath_PI/9) & LbFPMath_AngleMask;
+            mark_thing_sync_hash_dirty(thing);
             int skill = thing->shot_lizard2.range;
             target = thing_get(thing->shot_lizard.target_idx);
             if (thing_is_invalid(target)) break;
@@ -1613,6 +1618,7 @@ TngUpdateRet update_shot(struct Thing *thing)
             break;
         case ShM_TrapTNT:
             thing->mappos.z.val = 0;
+            mark_thing_sync_hash_dirty(thing);
             break;
         case ShM_TrapLightning:
             if (((game.play_gameturn - thing->creation_turn) % 16) == 0)
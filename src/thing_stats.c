@@ -25,6 +25,7 @@
 #include "bflib_memory.h"
 #include "game_merge.h"
 #include "thing_list.h"
+#include "thing_creature.h"
 #include "creature_control.h"
 #include "config_creature.h"
 #include "config_terrain.h"
@@ -819,6 +820,7 @@ HitPoints apply_damage_to_thing(struct Thing *thing, HitPoints dmg, DamageType d
     {
     case TCls_Creature:
         cdamage = apply_damage_to_creature(thing, dmg);
+        creature_force_decisions_check(thing);
         break;
     case TCls_Object:
     case TCls_Trap:
@@ -26,6 +26,7 @@
 #include "bflib_keybrd.h"
 #include "bflib_datetm.h"
 #include "bflib_video.h"
+#include "bflib_dernc.h"
 
 #include "vidmode.h"
 #include "kjm_input.h"
@@ -57,6 +58,209 @@ void fade_out(void)
     LbScreenClear(0);
 }
 
+/******************************************************************************/
+/** Stored after data in files with palette-dependent tables, to identify the palette. */
+struct PaletteTablesTrailer {
+    unsigned long magic;
+    unsigned long palette_hash;
+    unsigned long data_len;
+};
+#define PALETTE_TABLES_MAGIC 0x43425450 // "PTBC"
+
+/**
+ * Palette prepared for nearest colour search.
+ * Colours are sorted by red component, so that the search can skip colours
+ * which are too far in red to be the closest.
+ */
+struct PaletteSearch {
+    const unsigned char *pal;
+    /** Palette indices, in order of red component; equal ones are in index order. */
+    unsigned char order[256];
+    /** Red component of the colours, in the same order. */
+    unsigned char red[256];
+};
+/******************************************************************************/
+static void palette_search_init(struct PaletteSearch *psrch, const unsigned char *pal)
+{
+    int count[257];
+    LbMemorySet(count, 0, sizeof(count));
+    psrch->pal = pal;
+    for (int i = 0; i < 256; i++)
+        count[pal[3*i+0] + 1]++;
+    for (int i = 0; i < 256; i++)
+        count[i + 1] += count[i];
+    for (int i = 0; i < 256; i++)
+    {
+        int k = count[pal[3*i+0]]++;
+        psrch->order[k] = i;
+        psrch->red[k] = pal[3*i+0];
+    }
+}
+
+/**
+ * Finds palette colour closest to given one.
+ * Gives the same result as LbPaletteFindColour(), including the way ties are resolved.
+ */
+static TbPixel palette_search_find(const struct PaletteSearch *psrch, unsigned char r, unsigned char g, unsigned char b)
+{
+    const unsigned char* pal = psrch->pal;
+    int lo = 0;
+    int hi = 256;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (psrch->red[mid] < r)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    // Gather all the colors with minimal square difference; stop when red difference alone exceeds it
+    int min_delta = 999999;
+    int n = 0;
+    unsigned char tmcol[256];
+    for (int k = lo; k < 256; k++)
+    {
+        int dr = (r - psrch->red[k]) * (r - psrch->red[k]);
+        if (dr > min_delta)
+            break;
+        const unsigned char* c = &pal[3 * psrch->order[k]];
+        int delta = dr + (g - c[1]) * (g - c[1]) + (b - c[2]) * (b - c[2]);
+        if (min_delta > delta) {
+            min_delta = delta;
+            n = 0;
+        }
+        if (min_delta == delta)
+            tmcol[n++] = psrch->order[k];
+    }
+    for (int k = lo-1; k >= 0; k--)
+    {
+        int dr = (r - psrch->red[k]) * (r - psrch->red[k]);
+        if (dr > min_delta)
+            break;
+        const unsigned char* c = &pal[3 * psrch->order[k]];
+        int delta = dr + (g - c[1]) * (g - c[1]) + (b - c[2]) * (b - c[2]);
+        if (min_delta > delta) {
+            min_delta = delta;
+            n = 0;
+        }
+        if (min_delta == delta)
+            tmcol[n++] = psrch->order[k];
+    }
+    // If there's only one left on list - return it
+    if (n == 1) {
+        return tmcol[0];
+    }
+    // Further selection depends on order of colors, so restore it
+    for (int i = 1; i < n; i++)
+    {
+        unsigned char idx = tmcol[i];
+        int k;
+        for (k = i; (k > 0) && (tmcol[k-1] > idx); k--)
+            tmcol[k] = tmcol[k-1];
+        tmcol[k] = idx;
+    }
+    // Get minimal linear difference out of remaining colors
+    min_delta = 999999;
+    for (int i = 0; i < n; i++)
+    {
+        const unsigned char* c = &pal[3 * tmcol[i]];
+        int delta = abs(r - c[0]) + abs(g - c[1]) + abs(b - c[2]);
+        if (min_delta > delta) {
+            min_delta = delta;
+        }
+    }
+    // Gather all the colors with minimal linear difference
+    int m = 0;
+    for (int i = 0; i < n; i++)
+    {
+        const unsigned char* c = &pal[3 * tmcol[i]];
+        int delta = abs(r - c[0]) + abs(g - c[1]) + abs(b - c[2]);
+        if (min_delta == delta) {
+            tmcol[m++] = tmcol[i];
+        }
+    }
+    // If there's only one left on list - return it
+    if (m == 1) {
+        return tmcol[0];
+    }
+    // It's hard to select best color out of the left ones - use darker one with wages
+    min_delta = 999999;
+    unsigned char* o = &tmcol[0];
+    for (int i = 0; i < m; i++)
+    {
+        const unsigned char* c = &pal[3 * tmcol[i]];
+        int delta = c[2] * c[2] + 2 * (c[1] * c[1] + c[0] * c[0]);
+        if (min_delta > delta)
+        {
+            min_delta = delta;
+            o = &tmcol[i];
+        }
+    }
+    return *o;
+}
+
+static unsigned long palette_hash(const unsigned char *pal)
+{
+    unsigned long hash = 2166136261UL;
+    for (int i = 0; i < 768; i++)
+    {
+        hash ^= pal[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * Loads palette-dependent tables from file.
+ * Files with the palette hash which doesn't match given palette are rejected; files
+ * without the hash are accepted, as they were before the hash was introduced.
+ * @return True if the table was loaded.
+ */
+TbBool load_palette_tables(const char *fname, const unsigned char *pal, void *data, long len)
+{
+    long flen = LbFileLengthRnc(fname);
+    if (flen == len)
+        return (LbFileLoadAt(fname, data) == len);
+    if (flen != len + (long)sizeof(struct PaletteTablesTrailer))
+        return false;
+    unsigned char* buf = LbMemoryAlloc(flen);
+    if (buf == NULL)
+        return false;
+    TbBool result = false;
+    if (LbFileLoadAt(fname, buf) == flen)
+    {
+        struct PaletteTablesTrailer trail;
+        LbMemoryCopy(&trail, buf + len, sizeof(struct PaletteTablesTrailer));
+        if ((trail.magic == PALETTE_TABLES_MAGIC) && (trail.data_len == (unsigned long)len)
+          && (trail.palette_hash == palette_hash(pal)))
+        {
+            LbMemoryCopy(data, buf, len);
+            result = true;
+        }
+    }
+    LbMemoryFree(buf);
+    return result;
+}
+
+/**
+ * Saves palette-dependent tables to file, together with hash of the palette they were made for.
+ */
+TbBool save_palette_tables(const char *fname, const unsigned char *pal, const void *data, long len)
+{
+    unsigned char* buf = LbMemoryAlloc(len + sizeof(struct PaletteTablesTrailer));
+    if (buf == NULL)
+        return false;
+    struct PaletteTablesTrailer trail;
+    trail.magic = PALETTE_TABLES_MAGIC;
+    trail.palette_hash = palette_hash(pal);
+    trail.data_len = len;
+    LbMemoryCopy(buf, data, len);
+    LbMemoryCopy(buf + len, &trail, sizeof(struct PaletteTablesTrailer));
+    TbBool result = (LbFileSaveAt(fname, buf, len + sizeof(struct PaletteTablesTrailer)) == len + (long)sizeof(struct PaletteTablesTrailer));
+    LbMemoryFree(buf);
+    return result;
+}
+
 void compute_fade_tables(struct TbColorTables *coltbl,unsigned char *spal,unsigned char *dpal)
 {
     unsigned long i;
@@ -65,6 +269,8 @@ void compute_fade_tables(struct TbColorTables *coltbl,unsigned char *spal,unsign
     unsigned long g;
     unsigned long b;
     SYNCMSG("Recomputing fade tables");
+    struct PaletteSearch psrch;
+    palette_search_init(&psrch, dpal);
     // Intense fade to/from black - slower fade near black
     unsigned char* dst = coltbl->fade_tables;
     for (i=0; i < 32; i++)
@@ -74,7 +280,7 @@ void compute_fade_tables(struct TbColorTables *coltbl,unsigned char *spal,unsign
         r = spal[3*k+0];
         g = spal[3*k+1];
         b = spal[3*k+2];
-        *dst = LbPaletteFindColour(dpal, i * r >> 5, i * g >> 5, i * b >> 5);
+        *dst = palette_search_find(&psrch, i * r >> 5, i * g >> 5, i * b >> 5);
         dst++;
       }
     }
@@ -86,7 +292,7 @@ void compute_fade_tables(struct TbColorTables *coltbl,unsigned char *spal,unsign
         r = spal[3*k+0];
         g = spal[3*k+1];
         b = spal[3*k+2];
-        *dst = LbPaletteFindColour(dpal, i * r >> 5, i * g >> 5, i * b >> 5);
+        *dst = palette_search_find(&psrch, i * r >> 5, i * g >> 5, i * b >> 5);
         dst++;
       }
     }
@@ -104,13 +310,13 @@ void compute_fade_tables(struct TbColorTables *coltbl,unsigned char *spal,unsign
         r = dpal[3*k+0];
         g = dpal[3*k+1];
         b = dpal[3*k+2];
-        *dst = LbPaletteFindColour(dpal, (rr+2*r) / 3, (rg+2*g) / 3, (rb+2*b) / 3);
+        *dst = palette_search_find(&psrch, (rr+2*r) / 3, (rg+2*g) / 3, (rb+2*b) / 3);
         dst++;
       }
     }
 }
 
-void compute_alpha_table(unsigned char *alphtbl, unsigned char *spal, unsigned char *dpal, char dred, char dgreen, char dblue)
+static void compute_alpha_table(unsigned char *alphtbl, unsigned char *spal, const struct PaletteSearch *psrch, char dred, char dgreen, char dblue)
 {
     int blendR = 0;
     int blendG = 0;
@@ -130,7 +336,7 @@ void compute_alpha_table(unsigned char *alphtbl, unsigned char *spal, unsigned c
             int valB = blendB + baseCol[2];
             if (valB >= 63)
               valB = 63;
-            TbPixel c = LbPaletteFindColour(dpal, valR, valG, valB);
+            TbPixel c = palette_search_find(psrch, valR, valG, valB);
             alphtbl[nrow*256 + n] = c;
         }
         blendR += dred;
@@ -142,6 +348,8 @@ void compute_alpha_table(unsigned char *alphtbl, unsigned char *spal, unsigned c
 void compute_alpha_tables(struct TbAlphaTables *alphtbls,unsigned char *spal,unsigned char *dpal)
 {
     SYNCMSG("Recomputing alpha tables");
+    struct PaletteSearch psrch;
+    palette_search_init(&psrch, dpal);
     {
         for (int n = 0; n < 256; n++)
         {
@@ -149,20 +357,22 @@ void compute_alpha_tables(struct TbAlphaTables *alphtbls,unsigned char *spal,uns
         }
     }
     // Every color alpha-blended with shade of grey
-    compute_alpha_table(alphtbls->grey, spal, dpal, 4, 4, 4);
+    compute_alpha_table(alphtbls->grey, spal, &psrch, 4, 4, 4);
     // Every color alpha-blended with brown/orange
-    compute_alpha_table(alphtbls->orange, spal, dpal, 7, 4, 0);
+    compute_alpha_table(alphtbls->orange, spal, &psrch, 7, 4, 0);
     // Every color alpha-blended with intense red
-    compute_alpha_table(alphtbls->red, spal, dpal, 6, 1, 1);
+    compute_alpha_table(alphtbls->red, spal, &psrch, 6, 1, 1);
     // Every color alpha-blended with blue
-    compute_alpha_table(alphtbls->blue, spal, dpal, 2, 2, 6);
+    compute_alpha_table(alphtbls->blue, spal, &psrch, 2, 2, 6);
     // Every color alpha-blended with green
-    compute_alpha_table(alphtbls->green, spal, dpal, 2, 6, 2);
+    compute_alpha_table(alphtbls->green, spal, &psrch, 2, 6, 2);
 }
 
 void compute_rgb2idx_table(TbRGBColorTable ctab,unsigned char *spal)
 {
     SYNCMSG("Recomputing rgb-to-index tables");
+    struct PaletteSearch psrch;
+    palette_search_init(&psrch, spal);
     int scaler = (1 << 6) / COLOUR_TABLE_DIMENSION;
     for (int valR = 0; valR < COLOUR_TABLE_DIMENSION; valR++)
     {
@@ -170,7 +380,7 @@ void compute_rgb2idx_table(TbRGBColorTable ctab,unsigned char *spal)
         {
             for (int valB = 0; valB < COLOUR_TABLE_DIMENSION; valB++)
             {
-                TbPixel c = LbPaletteFindColour(spal, scaler * valR + (scaler-1),
+                TbPixel c = palette_search_find(&psrch, scaler * valR + (scaler-1),
                     scaler * valG + (scaler-1), scaler * valB + (scaler-1));
                 ctab[valR][valG][valB] = c;
             }
@@ -190,6 +400,8 @@ void compute_rgb2idx_table(TbRGBColorTable ctab,unsigned char *spal)
 void compute_shifted_palette_table(TbPixel *ocol, const unsigned char *spal, const unsigned char *dpal, int shiftR, int shiftG, int shiftB)
 {
     SYNCMSG("Recomputing palette table");
+    struct PaletteSearch psrch;
+    palette_search_init(&psrch, dpal);
     for (int i = 0; i < 256; i++)
     {
         int valR = (int)spal[3 * i + 0] + shiftR;
@@ -201,7 +413,7 @@ void compute_shifted_palette_table(TbPixel *ocol, const unsigned char *spal, con
         int valB = (int)spal[3 * i + 2] + shiftB;
         if (valB >= 63) valB = 63;
         if (valB <   0) valB = 0;
-        ocol[i] = LbPaletteFindColour(dpal, valR, valG, valB);
+        ocol[i] = palette_search_find(&psrch, valR, valG, valB);
     }
 }
 
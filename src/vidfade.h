@@ -56,6 +56,8 @@ void compute_alpha_tables(struct TbAlphaTables *alphtbls,unsigned char *spal,uns
 void compute_rgb2idx_table(TbRGBColorTable ctab,unsigned char *spal);
 void compute_shifted_palette_table(TbPixel *ocol, const unsigned char *spal,
     const unsigned char *dpal, int shiftR, int shiftG, int shiftB);
+TbBool load_palette_tables(const char *fname, const unsigned char *pal, void *data, long len);
+TbBool save_palette_tables(const char *fname, const unsigned char *pal, const void *data, long len);
 
 
 long PaletteFadePlayer(struct PlayerInfo *player);
@@ -566,10 +566,10 @@ TbBool init_fades_table(void)
 {
     char* fname = prepare_file_path(FGrp_StdData, "tables.dat");
     SYNCDBG(0,"Reading fade table file \"%s\".",fname);
-    if (LbFileLoadAt(fname, &pixmap) != sizeof(struct TbColorTables))
+    if (!load_palette_tables(fname, engine_palette, &pixmap, sizeof(struct TbColorTables)))
     {
         compute_fade_tables(&pixmap,engine_palette,engine_palette);
-        LbFileSaveAt(fname, &pixmap, sizeof(struct TbColorTables));
+        save_palette_tables(fname, engine_palette, &pixmap, sizeof(struct TbColorTables));
     }
     lbDisplay.FadeTable = pixmap.fade_tables;
     TbPixel cblack = 144;
@@ -588,10 +588,10 @@ TbBool init_alpha_table(void)
     char* fname = prepare_file_path(FGrp_StdData, "alpha.col");
     SYNCDBG(0,"Reading alpha color table file \"%s\".",fname);
     // Loading file data
-    if (LbFileLoadAt(fname, &alpha_sprite_table) != sizeof(struct TbAlphaTables))
+    if (!load_palette_tables(fname, engine_palette, &alpha_sprite_table, sizeof(struct TbAlphaTables)))
     {
         compute_alpha_tables(&alpha_sprite_table,engine_palette,engine_palette);
-        LbFileSaveAt(fname, &alpha_sprite_table, sizeof(struct TbAlphaTables));
+        save_palette_tables(fname, engine_palette, &alpha_sprite_table, sizeof(struct TbAlphaTables));
     }
     return true;
 }
@@ -601,10 +601,10 @@ TbBool init_rgb2idx_table(void)
     char* fname = prepare_file_path(FGrp_StdData, "colours.col");
     SYNCDBG(0,"Reading rgb-to-index color table file \"%s\".",fname);
     // Loading file data
-    if (LbFileLoadAt(fname, &colours) != sizeof(TbRGBColorTable))
+    if (!load_palette_tables(fname, engine_palette, &colours, sizeof(TbRGBColorTable)))
     {
         compute_rgb2idx_table(colours,engine_palette);
-        LbFileSaveAt(fname, &colours, sizeof(TbRGBColorTable));
+        save_palette_tables(fname, engine_palette, &colours, sizeof(TbRGBColorTable));
     }
     return true;
 }
@@ -614,10 +614,10 @@ TbBool init_redpal_table(void)
     char* fname = prepare_file_path(FGrp_StdData, "redpal.col");
     SYNCDBG(0,"Reading red-blended color table file \"%s\".",fname);
     // Loading file data
-    if (LbFileLoadAt(fname, &red_pal) != 256)
+    if (!load_palette_tables(fname, engine_palette, &red_pal, 256))
     {
         compute_shifted_palette_table(red_pal, engine_palette, engine_palette, 20, -10, -10);
-        LbFileSaveAt(fname, &red_pal, 256);
+        save_palette_tables(fname, engine_palette, &red_pal, 256);
     }
     return true;
 }
@@ -627,10 +627,10 @@ TbBool init_whitepal_table(void)
     char* fname = prepare_file_path(FGrp_StdData, "whitepal.col");
     SYNCDBG(0,"Reading white-blended color table file \"%s\".",fname);
     // Loading file data
-    if (LbFileLoadAt(fname, &white_pal) != 256)
+    if (!load_palette_tables(fname, engine_palette, &white_pal, 256))
     {
         compute_shifted_palette_table(white_pal, engine_palette, engine_palette, 48, 48, 48);
-        LbFileSaveAt(fname, &white_pal, 256);
+        save_palette_tables(fname, engine_palette, &white_pal, 256);
     }
     return true;
 }
@@ -0,0 +1,92 @@
+//
+// Tests for the index which find_column() uses to look up columns by content.
+//
+#include "tst_main.h"
+#include <string.h>
+
+#include <map_columns.h>
+#include <map_blocks.h>
+#include <game_legacy.h>
+
+#define CHURN_VARIANTS   3000
+#define CHURN_LIVE_MAX   1500
+#define CHURN_OPERATIONS 200000
+
+static void churn_make_column(struct Column *col, unsigned long variant)
+{
+    memset(col, 0, sizeof(struct Column));
+    col->baseblock = 1 + (variant % 7);
+    col->orient = (variant / 7) % 4;
+    for (int i = 0; i < 4; i++)
+        col->cubes[i] = 1 + ((variant >> (2*i)) % 50);
+    make_solidmask(col);
+}
+
+// Same as find_column() before indexing; free slots with matching content are found too
+static long linear_find_column(const struct Column *srccol)
+{
+    for (long i = 1; i < COLUMNS_COUNT; i++)
+    {
+        const struct Column *col = &game.columns_data[i];
+        if ((col->baseblock == srccol->baseblock) && (col->solidmask == srccol->solidmask)
+          && (col->orient == srccol->orient) && (memcmp(col->cubes, srccol->cubes, sizeof(col->cubes)) == 0))
+            return i;
+    }
+    return 0;
+}
+
+static long linear_free_column(void)
+{
+    for (long i = 1; i < COLUMNS_COUNT; i++)
+    {
+        const struct Column *col = &game.columns_data[i];
+        if ((col->use == 0) && ((col->bitfields & CLF_ACTIVE) == 0))
+            return i;
+    }
+    return 0;
+}
+
+ADD_TEST(test_column_churn)
+{
+    static long live[CHURN_LIVE_MAX];
+    long live_count = 0;
+    for (long i = 0; i < COLUMNS_COUNT; i++)
+        game.columns.lookup[i] = &game.columns_data[i];
+    game.columns.end = &game.columns_data[COLUMNS_COUNT];
+    clear_columns();
+    TestRandom rnd(1);
+    // Unused columns with content, like the ones loaded from CLM file, should be reused
+    for (long i = 1; i < COLUMNS_COUNT; i += 3)
+        churn_make_column(&game.columns_data[i], rnd.next(CHURN_VARIANTS));
+    rebuild_column_index();
+    for (long n = 0; n < CHURN_OPERATIONS; n++)
+    {
+        if ((live_count < CHURN_LIVE_MAX) && ((live_count == 0) || (rnd.next(2) == 0)))
+        {
+            struct Column ncol;
+            churn_make_column(&ncol, rnd.next(CHURN_VARIANTS));
+            long expect_idx = linear_find_column(&ncol);
+            long col_idx = find_column(&ncol);
+            CU_ASSERT_EQUAL(col_idx, expect_idx);
+            if (col_idx == 0)
+            {
+                expect_idx = linear_free_column();
+                col_idx = create_column(&ncol);
+                CU_ASSERT_EQUAL(col_idx, expect_idx);
+            }
+            CU_ASSERT_FATAL(col_idx > 0);
+            game.columns_data[col_idx].use++;
+            live[live_count++] = col_idx;
+        } else
+        {
+            long k = rnd.next(live_count);
+            long col_idx = live[k];
+            live[k] = live[--live_count];
+            struct Column *col = &game.columns_data[col_idx];
+            col->use--;
+            if (col->use <= 0)
+                delete_column(col_idx);
+        }
+    }
+    clear_columns();
+}
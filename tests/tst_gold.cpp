@@ -0,0 +1,118 @@
+//
+// Tests for the gold vein index; veins it gives to computer players should be the same as from scanning the map.
+//
+#include "tst_main.h"
+#include <string.h>
+
+#include <player_complookup.h>
+#include <config_terrain.h>
+#include <slab_data.h>
+#include <front_simple.h>
+#include <bflib_memory.h>
+#include <game_legacy.h>
+#include <game_merge.h>
+
+#define GOLD_TEST_MAPS          2200
+#define GOLD_TEST_EDITS         100
+#define GOLD_TEST_MAP_MIN       3
+#define GOLD_TEST_MAP_MAX       40
+#define GOLD_TEST_SCRATCH_SIZE  (MAX_TILES_X * MAX_TILES_Y * 4)
+
+static SlabKind gold_random_kind(TestRandom &rnd)
+{
+    switch (rnd.next(8))
+    {
+    case 0:
+    case 1:
+    case 2:
+        return SlbT_GOLD;
+    case 3:
+        return SlbT_GEMS;
+    case 4:
+        return SlbT_ROCK;
+    case 5:
+        return SlbT_PATH;
+    default:
+        return SlbT_EARTH;
+    }
+}
+
+static void gold_set_random_slab(TestRandom &rnd, MapSlabCoord slb_x, MapSlabCoord slb_y, TbBool border_gold)
+{
+    struct SlabMap *slb = get_slabmap_block(slb_x, slb_y);
+    slb->kind = gold_random_kind(rnd);
+    // Gold on far border makes the index unusable, so allow it only on some maps
+    if ((slb->kind == SlbT_GOLD) && !border_gold)
+    {
+        if ((slb_x >= gameadd.map_tiles_x - 1) || (slb_y >= gameadd.map_tiles_y - 1))
+            slb->kind = SlbT_ROCK;
+    }
+}
+
+static TbBool gold_lookup_matches_scan(void)
+{
+    struct GoldLookup scanned[GOLD_LOOKUP_COUNT];
+    LbMemorySet(game.gold_lookup, 0, sizeof(game.gold_lookup));
+    // With gold on far border, the scan reads beyond treasure map; make what's there the same on each scan
+    LbMemorySet(scratch, 0, GOLD_TEST_SCRATCH_SIZE);
+    scan_map_for_gold();
+    memcpy(scanned, game.gold_lookup, sizeof(scanned));
+    LbMemorySet(scratch, 0, GOLD_TEST_SCRATCH_SIZE);
+    check_map_for_gold();
+    return (memcmp(scanned, game.gold_lookup, sizeof(scanned)) == 0);
+}
+
+ADD_TEST(test_gold_veins_index)
+{
+    unsigned char *scratch_mem = (unsigned char *)LbMemoryAlloc(GOLD_TEST_SCRATCH_SIZE);
+    unsigned char *scratch_prev = scratch;
+    scratch = scratch_mem;
+    unsigned short valuable_prev[3];
+    const SlabKind valuable_kinds[3] = {SlbT_GOLD, SlbT_GEMS, SlbT_EARTH};
+    for (int i = 0; i < 3; i++)
+    {
+        struct SlabAttr *slbattr = get_slab_kind_attrs(valuable_kinds[i]);
+        valuable_prev[i] = slbattr->block_flags;
+        if (valuable_kinds[i] == SlbT_EARTH)
+            slbattr->block_flags &= ~SlbAtFlg_Valuable;
+        else
+            slbattr->block_flags |= SlbAtFlg_Valuable;
+    }
+    TestRandom rnd(1);
+    for (long n = 0; n < GOLD_TEST_MAPS; n++)
+    {
+        gameadd.map_tiles_x = GOLD_TEST_MAP_MIN + rnd.next(GOLD_TEST_MAP_MAX - GOLD_TEST_MAP_MIN + 1);
+        gameadd.map_tiles_y = GOLD_TEST_MAP_MIN + rnd.next(GOLD_TEST_MAP_MAX - GOLD_TEST_MAP_MIN + 1);
+        TbBool border_gold = (rnd.next(4) == 0);
+        LbMemorySet(game.slabmap, 0, sizeof(game.slabmap));
+        for (MapSlabCoord slb_y = 0; slb_y < gameadd.map_tiles_y; slb_y++)
+            for (MapSlabCoord slb_x = 0; slb_x < gameadd.map_tiles_x; slb_x++)
+                gold_set_random_slab(rnd, slb_x, slb_y, border_gold);
+        rebuild_gold_veins();
+        CU_ASSERT(gold_lookup_matches_scan());
+        for (long k = 0; k < GOLD_TEST_EDITS; k++)
+        {
+            // Mostly edit single slabs, like digging or placing gems would
+            MapSlabCoord slb_x = rnd.next(gameadd.map_tiles_x);
+            MapSlabCoord slb_y = rnd.next(gameadd.map_tiles_y);
+            if (rnd.next(10) == 0)
+            {
+                // Switch border gold on or off within the same map
+                border_gold = !border_gold;
+                slb_x = gameadd.map_tiles_x - 1;
+            }
+            gold_set_random_slab(rnd, slb_x, slb_y, border_gold);
+            update_gold_veins_for_slab(slb_x, slb_y);
+            // Checking is not done after every change in game, so don't do it here either
+            if (rnd.next(3) == 0)
+                continue;
+            CU_ASSERT(gold_lookup_matches_scan());
+        }
+    }
+    for (int i = 0; i < 3; i++)
+        get_slab_kind_attrs(valuable_kinds[i])->block_flags = valuable_prev[i];
+    clear_gold_veins();
+    LbMemorySet(game.slabmap, 0, sizeof(game.slabmap));
+    scratch = scratch_prev;
+    LbMemoryFree(scratch_mem);
+}
@@ -0,0 +1,155 @@
+//
+// Tests for caches used by line of sight; results should be the same as with map solidity caching switched off.
+//
+#include "tst_main.h"
+#include <string.h>
+
+#include <creature_senses.h>
+#include <map_columns.h>
+#include <map_blocks.h>
+#include <map_data.h>
+#include <bflib_memory.h>
+#include <game_legacy.h>
+#include <game_merge.h>
+
+#define LOS_MAP_SUBTILES   255
+#define LOS_COLUMN_KINDS   60
+#define LOS_QUERIES        200000
+#define LOS_MAX_RANGE      40
+
+static long los_columns[LOS_COLUMN_KINDS];
+
+static long los_make_column(TestRandom &rnd)
+{
+    struct Column col;
+    memset(&col, 0, sizeof(struct Column));
+    col.baseblock = 1 + rnd.next(5);
+    // Floor, then a gap, then optionally a ceiling hanging from the top
+    int floor_h = rnd.next(COLUMN_STACK_HEIGHT + 1);
+    int ceil_h = rnd.next(3) ? 0 : rnd.next(COLUMN_STACK_HEIGHT - floor_h + 1);
+    for (int i = 0; i < floor_h; i++)
+        col.cubes[i] = 1 + rnd.next(50);
+    for (int i = COLUMN_STACK_HEIGHT - ceil_h; i < COLUMN_STACK_HEIGHT; i++)
+        col.cubes[i] = 1 + rnd.next(50);
+    make_solidmask(&col);
+    long col_idx = find_column(&col);
+    if (col_idx == 0)
+        col_idx = create_column(&col);
+    return col_idx;
+}
+
+static void los_randomize_block(TestRandom &rnd, MapSubtlCoord stl_x, MapSubtlCoord stl_y)
+{
+    struct Map *mapblk = get_map_block_at(stl_x, stl_y);
+    set_mapblk_column_index(mapblk, los_columns[rnd.next(LOS_COLUMN_KINDS)]);
+    set_mapblk_filled_subtiles(mapblk, rnd.next(4) ? 15 : rnd.next(16));
+    mapblk->flags = (rnd.next(200) == 0) ? SlbAtFlg_IsDoor : 0;
+}
+
+static void los_random_pos(TestRandom &rnd, struct Coord3d *pos, const struct Coord3d *near_pos)
+{
+    long x;
+    long y;
+    if (near_pos == NULL)
+    {
+        x = rnd.next(LOS_MAP_SUBTILES * COORD_PER_STL);
+        y = rnd.next(LOS_MAP_SUBTILES * COORD_PER_STL);
+    } else
+    {
+        x = near_pos->x.val + (long)rnd.next(2 * LOS_MAX_RANGE * COORD_PER_STL) - LOS_MAX_RANGE * COORD_PER_STL;
+        y = near_pos->y.val + (long)rnd.next(2 * LOS_MAX_RANGE * COORD_PER_STL) - LOS_MAX_RANGE * COORD_PER_STL;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+        if (x >= LOS_MAP_SUBTILES * COORD_PER_STL) x = LOS_MAP_SUBTILES * COORD_PER_STL - 1;
+        if (y >= LOS_MAP_SUBTILES * COORD_PER_STL) y = LOS_MAP_SUBTILES * COORD_PER_STL - 1;
+        // Sometimes make the line axis aligned or diagonal
+        switch (rnd.next(8))
+        {
+        case 0: x = near_pos->x.val; break;
+        case 1: y = near_pos->y.val; break;
+        case 2: y = near_pos->y.val + (x - near_pos->x.val); if ((y < 0) || (y >= LOS_MAP_SUBTILES * COORD_PER_STL)) y = near_pos->y.val; break;
+        default: break;
+        }
+    }
+    pos->x.val = x;
+    pos->y.val = y;
+    pos->z.val = rnd.next(18 * COORD_PER_STL);
+}
+
+/** Results of all checked queries, for comparing cached and uncached ones. */
+struct LosResults {
+    TbBool sight_2d;
+    TbBool sight_3d;
+    TbBool sight_nowibble;
+    TbBool solid;
+};
+
+static LosResults los_query(const struct Coord3d *frpos, const struct Coord3d *topos)
+{
+    LosResults res;
+    res.sight_2d = line_of_sight_2d(frpos, topos);
+    res.sight_3d = line_of_sight_3d(frpos, topos);
+    res.sight_nowibble = nowibble_line_of_sight_3d(frpos, topos);
+    res.solid = point_in_map_is_solid(topos);
+    return res;
+}
+
+ADD_TEST(test_line_of_sight_cache)
+{
+    for (long i = 0; i < COLUMNS_COUNT; i++)
+        game.columns.lookup[i] = &game.columns_data[i];
+    game.columns.end = &game.columns_data[COLUMNS_COUNT];
+    clear_columns();
+    LbMemorySet(game.map, 0, sizeof(game.map));
+    gameadd.map_subtiles_x = LOS_MAP_SUBTILES;
+    gameadd.map_subtiles_y = LOS_MAP_SUBTILES;
+    TestRandom rnd(1);
+    for (long i = 0; i < LOS_COLUMN_KINDS; i++)
+        los_columns[i] = los_make_column(rnd);
+    for (MapSubtlCoord stl_y = 0; stl_y <= LOS_MAP_SUBTILES; stl_y++)
+        for (MapSubtlCoord stl_x = 0; stl_x <= LOS_MAP_SUBTILES; stl_x++)
+            los_randomize_block(rnd, stl_x, stl_y);
+    game.play_gameturn = 1;
+    struct Coord3d frpos;
+    struct Coord3d topos;
+    for (long n = 0; n < LOS_QUERIES; n++)
+    {
+        // Repeat some queries, to exercise the memo of results
+        if ((n == 0) || (rnd.next(4) != 0))
+        {
+            los_random_pos(rnd, &frpos, NULL);
+            los_random_pos(rnd, &topos, &frpos);
+        }
+        switch (rnd.next(16))
+        {
+        case 0:
+            game.play_gameturn++;
+            break;
+        case 1:
+            // Change the map along the line, like digging would
+            los_randomize_block(rnd, (frpos.x.stl.num + topos.x.stl.num) / 2, (frpos.y.stl.num + topos.y.stl.num) / 2);
+            break;
+        case 2:
+        {
+            // Replace a column which is still on map; the freed slot is likely to be reused
+            // with different content, which requires clearing the whole cache
+            long k = rnd.next(LOS_COLUMN_KINDS);
+            delete_column(los_columns[k]);
+            los_columns[k] = los_make_column(rnd);
+            break;
+        }
+        default:
+            break;
+        }
+        LosResults cached = los_query(&frpos, &topos);
+        set_map_solidity_caching(false);
+        LosResults computed = los_query(&frpos, &topos);
+        set_map_solidity_caching(true);
+        CU_ASSERT_EQUAL(cached.sight_2d, computed.sight_2d);
+        CU_ASSERT_EQUAL(cached.sight_3d, computed.sight_3d);
+        CU_ASSERT_EQUAL(cached.sight_nowibble, computed.sight_nowibble);
+        CU_ASSERT_EQUAL(cached.solid, computed.solid);
+    }
+    LbMemorySet(game.map, 0, sizeof(game.map));
+    clear_columns();
+}
@@ -26,6 +26,23 @@ public:
     }
 };
 
+/** Pseudo-random numbers for randomized tests; the sequence depends only on the seed. */
+class TestRandom
+{
+
+public:
+    explicit TestRandom(unsigned long seed) : seed(seed) {}
+
+    unsigned long next(unsigned long range)
+    {
+        seed = seed * 1103515245UL + 12345UL;
+        return ((seed >> 8) & 0xFFFFFF) % range;
+    }
+
+private:
+    unsigned long seed;
+};
+
 #define TEST_OBJ_NAME(fn_name) fn_name ##__LINE__
 
 #define ADD_TEST(X) \
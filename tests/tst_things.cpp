@@ -0,0 +1,106 @@
+//
+// Tests for paged things storage; slots should be allocated in the same order as with the former fixed array.
+//
+#include "tst_main.h"
+#include <string.h>
+#include <vector>
+
+#include <thing_data.h>
+#include <thing_list.h>
+#include <bflib_memory.h>
+#include <game_legacy.h>
+
+#define THINGS_CHURN_LIVE_MAX   3000
+#define THINGS_CHURN_OPERATIONS 100000
+
+/** Reference free things list; it worked as a stack, with never used slots at bottom in ascending order. */
+struct RefFreeThings {
+    std::vector<ThingIndex> freed;
+    ThingIndex next_unused;
+
+    ThingIndex allocate()
+    {
+        if (!freed.empty()) {
+            ThingIndex tng_idx = freed.back();
+            freed.pop_back();
+            return tng_idx;
+        }
+        return next_unused++;
+    }
+};
+
+struct LiveThing {
+    ThingIndex index;
+    ThingGeneration generation;
+};
+
+ADD_TEST(test_things_pages_churn)
+{
+    long max_pages = 0;
+    TestRandom rnd(1);
+    reset_things_pages();
+    RefFreeThings ref;
+    ref.next_unused = 1;
+    std::vector<LiveThing> live;
+    std::vector<LiveThing> dead;
+    for (long n = 0; n < THINGS_CHURN_OPERATIONS; n++)
+    {
+        // Grow the amount of live things in waves, so that pages are added mid-churn
+        long target = (n / 20000 + 1) * THINGS_CHURN_LIVE_MAX / 5;
+        if ((live.size() < (unsigned long)target) && (rnd.next(3) != 0))
+        {
+            ThingIndex expect_idx = ref.allocate();
+            struct Thing* thing = allocate_free_thing_structure(FTAF_Default);
+            CU_ASSERT_FATAL(!thing_is_invalid(thing));
+            CU_ASSERT_EQUAL(thing->index, expect_idx);
+            CU_ASSERT(thing_get(thing->index) == thing);
+            CU_ASSERT_EQUAL(thing_get_index(thing), thing->index);
+            LiveThing lt = {thing->index, get_thing_generation(thing)};
+            live.push_back(lt);
+        } else
+        if (!live.empty())
+        {
+            unsigned long k = rnd.next(live.size());
+            LiveThing lt = live[k];
+            live[k] = live.back();
+            live.pop_back();
+            delete_thing_structure(thing_get(lt.index), 1);
+            ref.freed.push_back(lt.index);
+            dead.push_back(lt);
+        }
+        if (game.things.pages_count > max_pages)
+            max_pages = game.things.pages_count;
+        CU_ASSERT_EQUAL(THINGS_COUNT, game.things.pages_count * THINGS_PAGE_SIZE);
+    }
+    // Every live thing must be reachable with its generation, and no dead one
+    for (unsigned long i = 0; i < live.size(); i++)
+    {
+        CU_ASSERT(thing_get_if_generation(live[i].index, live[i].generation) == thing_get(live[i].index));
+    }
+    for (unsigned long i = 0; i < dead.size(); i++)
+    {
+        CU_ASSERT(thing_is_invalid(thing_get_if_generation(dead[i].index, dead[i].generation)));
+    }
+    CU_ASSERT_EQUAL(game.things.used_count, (ThingIndex)live.size());
+    // Restoring stored pages should give the same storage, including free things list
+    unsigned long data_len = game.things.pages_count * sizeof(struct ThingsPage);
+    unsigned char* data = (unsigned char *)LbMemoryAlloc(data_len);
+    for (long i = 0; i < game.things.pages_count; i++)
+        memcpy(data + i * sizeof(struct ThingsPage), get_things_page(i), sizeof(struct ThingsPage));
+    struct Things things_mem = game.things;
+    reset_things_pages();
+    CU_ASSERT_EQUAL(game.things.pages_count, 1);
+    CU_ASSERT(restore_things_pages(data, data_len));
+    game.things = things_mem;
+    LbMemoryFree(data);
+    for (long n = 0; n < 2000; n++)
+    {
+        ThingIndex expect_idx = ref.allocate();
+        struct Thing* thing = allocate_free_thing_structure(FTAF_Default);
+        CU_ASSERT_FATAL(!thing_is_invalid(thing));
+        CU_ASSERT_EQUAL(thing->index, expect_idx);
+    }
+    CU_ASSERT(max_pages > 1);
+    memset(get_things_page(0)->things, 0, sizeof(get_things_page(0)->things));
+    reset_things_pages();
+}